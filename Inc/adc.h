@@ -19,9 +19,15 @@
 #include "pll.h"
 #include "stm32f446xx.h"
 #include "gpio.h"
+#include "sample_ring.h"
 
 #define NUM_ADC_PORTS 3         /**< Number of ADC ports available */
-#define TOTAL_NUM_OF_CHANNELS 16 /**< Total number of ADC channels */
+#define TOTAL_NUM_OF_CHANNELS 16 /**< Total number of ranks in a regular sequence */
+#define MAX_CHANNEL_NUMBER 18    /**< Highest ADC input channel (16-18 are internal) */
+#define ADC_RANKS_PER_SQR 6      /**< Ranks held by each of SQR3/SQR2/SQR1 */
+#define ADC_SQR_BITS_PER_RANK 5  /**< Width of a rank field in the SQRx registers */
+#define ADC_SQR1_L_POS 20        /**< Position of the sequence length in SQR1 */
+#define ADC_CLOCK_FREQ (APB2_FREQ/4) /**< ADCCLK after the common prescaler (max 36 MHz) */
 
 /**
  * @brief Enumeration of ADC ports
@@ -32,6 +38,20 @@ typedef enum {
     ADC_PORT_3 = 2, /**< ADC Port 3 */
 } ADC_Port_Type;
 
+/**
+ * @brief Enumeration of ADC channel sampling times (SMPx field values)
+*/
+typedef enum {
+    ADC_SAMPLE_TIME_3_CYCLES   = 0, /**< 3 ADCCLK cycles */
+    ADC_SAMPLE_TIME_15_CYCLES  = 1, /**< 15 ADCCLK cycles */
+    ADC_SAMPLE_TIME_28_CYCLES  = 2, /**< 28 ADCCLK cycles */
+    ADC_SAMPLE_TIME_56_CYCLES  = 3, /**< 56 ADCCLK cycles */
+    ADC_SAMPLE_TIME_84_CYCLES  = 4, /**< 84 ADCCLK cycles */
+    ADC_SAMPLE_TIME_112_CYCLES = 5, /**< 112 ADCCLK cycles */
+    ADC_SAMPLE_TIME_144_CYCLES = 6, /**< 144 ADCCLK cycles */
+    ADC_SAMPLE_TIME_480_CYCLES = 7, /**< 480 ADCCLK cycles */
+} ADC_Sample_Time_Type;
+
 /** @brief Digital value from ADC1 */
 extern volatile uint32_t ADC1_digital_value;
 
@@ -41,6 +61,12 @@ extern volatile uint32_t ADC2_digital_value;
 /** @brief Digital value from ADC3 */
 extern volatile uint32_t ADC3_digital_value;
 
+/** @brief Timestamped samples pushed by ADC_IRQHandler, drained by the main loop */
+extern Sample_Ring_Type adc_sample_ring;
+
+/** @brief Conversions lost inside the ADCs (OVR flag) */
+extern volatile uint32_t adc_overrun_count;
+
 /**
  * @brief Initialize the specified ADC
  * @param ADCx Pointer to ADC peripheral to be initialized
@@ -111,4 +137,40 @@ extern uint32_t get_data(ADC_TypeDef* ADCx);
 */
 extern void set_regular_sequence(ADC_TypeDef* ADCx, uint8_t num_of_channels, uint8_t channels[]);
 
+/**
+ * @brief Get the number of channels in the regular sequence
+ * @param ADCx Pointer to ADC peripheral to query
+ * @return Sequence length (1 to 16)
+*/
+extern uint8_t get_regular_sequence_length(ADC_TypeDef* ADCx);
+
+/**
+ * @brief Set the sampling time of a channel
+ * @param ADCx Pointer to ADC peripheral to configure
+ * @param channel Channel number (0 to 18)
+ * @param sample_time Sampling time, one of ADC_Sample_Time_Type
+*/
+extern void set_channel_sample_time(ADC_TypeDef* ADCx, uint8_t channel, uint8_t sample_time);
+
+/**
+ * @brief Set a scan sequence with a sampling time per rank
+ * @param ADCx Pointer to ADC peripheral to configure
+ * @param num_of_channels Number of channels in the scan (1 to 16)
+ * @param channels Array of channel numbers in rank order
+ * @param sample_times Array of sampling times, one per rank
+*/
+extern void set_scan_sequence(ADC_TypeDef* ADCx, uint8_t num_of_channels, uint8_t channels[], uint8_t sample_times[]);
+
+/**
+ * @brief Enable scan mode for the specified ADC
+ * @param ADCx Pointer to ADC peripheral to configure
+*/
+extern void enable_scan_mode(ADC_TypeDef* ADCx);
+
+/**
+ * @brief Disable scan mode for the specified ADC
+ * @param ADCx Pointer to ADC peripheral to configure
+*/
+extern void disable_scan_mode(ADC_TypeDef* ADCx);
+
 #endif /* ADC_H_ */
\ No newline at end of file
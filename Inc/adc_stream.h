@@ -0,0 +1,120 @@
+/**
+ * @file adc_stream.h
+ * @brief Header file for DMA-backed continuous ADC acquisition
+ *
+ * This file contains declarations for streaming the regular sequence of an
+ * ADC into a circular buffer through DMA2, with callbacks fired when each
+ * half of the buffer has been filled.
+ *
+ * DMA2 request mapping used:
+ *   ADC1 -> Stream 0 / Channel 0
+ *   ADC2 -> Stream 2 / Channel 1
+ *   ADC3 -> Stream 1 / Channel 2
+ *
+ * In triple interleaved mode the three converters sample the same input one
+ * after the other and ADC1's request of stream 0 reads the common data
+ * register.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef ADC_STREAM_H_
+#define ADC_STREAM_H_
+
+#include <stdint.h>
+#include <assert.h>
+#include "stm32f446xx.h"
+#include "adc.h"
+
+#define ADC_STREAM_MAX_LENGTH 0xFFFFu /**< Largest buffer the DMA NDTR counter can describe */
+
+#define ADC_INTERLEAVED_MIN_DELAY 5u  /**< Shortest delay between sampling phases at 12-bit */
+#define ADC_INTERLEAVED_MAX_DELAY 20u /**< Longest delay the CCR DELAY field can express */
+#define ADC_CCR_DELAY_POS 8u          /**< Position of DELAY in ADC_CCR */
+#define ADC_CCR_MULTI_TRIPLE_INTERLEAVED (ADC_CCR_MULTI_4 | ADC_CCR_MULTI_2 | ADC_CCR_MULTI_1 | ADC_CCR_MULTI_0) /**< 0b10111 */
+
+/**
+ * @brief Callback fired from the DMA interrupt when half of the buffer is ready
+ * @param samples Pointer to the first ready sample (first or second half of the buffer)
+ * @param num_of_samples Number of ready samples (always half the buffer length)
+ *
+ * The DMA keeps writing into the other half while the callback runs, so the
+ * data must be consumed before that half wraps around again.
+*/
+typedef void (*ADC_Stream_Callback)(volatile uint16_t* samples, uint32_t num_of_samples);
+
+/**
+ * @brief Callback fired from the DMA interrupt when half of the scan frames are ready
+ * @param frames Pointer to the first ready frame, frames are stored back to back
+ * @param num_of_frames Number of ready frames
+ * @param frame_size Number of samples per frame (length of the regular sequence)
+ *
+ * Sample i of a frame is the conversion of rank i+1 of the regular sequence.
+*/
+typedef void (*ADC_Scan_Callback)(volatile uint16_t* frames, uint32_t num_of_frames, uint8_t frame_size);
+
+/**
+ * @brief Start streaming conversions of the specified ADC into a circular buffer
+ * @param ADCx Pointer to ADC peripheral to stream from (must be initialized and sequenced)
+ * @param buffer Buffer receiving the 12-bit samples
+ * @param length Number of samples in the buffer (even, at most ADC_STREAM_MAX_LENGTH)
+ * @param callback Function called on half and full transfer, may be NULL
+ *
+ * If an external trigger is already selected (see adc_trigger_config()) the
+ * ADC waits for it, otherwise it free-runs in continuous mode.
+*/
+extern void adc_stream_start(ADC_TypeDef* ADCx, volatile uint16_t* buffer, uint32_t length, ADC_Stream_Callback callback);
+
+/**
+ * @brief Start streaming whole scans of the regular sequence into a circular buffer
+ * @param ADCx Pointer to ADC peripheral to stream from (sequenced with scan mode enabled)
+ * @param buffer Buffer holding num_of_frames * sequence length samples
+ * @param num_of_frames Number of frames in the buffer (even)
+ * @param callback Function called when half of the frames are ready, may be NULL
+*/
+extern void adc_scan_start(ADC_TypeDef* ADCx, volatile uint16_t* buffer, uint32_t num_of_frames, ADC_Scan_Callback callback);
+
+/**
+ * @brief Stop streaming conversions of the specified ADC
+ * @param ADCx Pointer to ADC peripheral to stop
+*/
+extern void adc_stream_stop(ADC_TypeDef* ADCx);
+
+/**
+ * @brief Start triple interleaved sampling of one channel
+ * @param channel Channel sampled by ADC1, ADC2 and ADC3 (initialized beforehand)
+ * @param buffer Buffer receiving the samples in conversion order
+ * @param length Number of samples in the buffer (multiple of 4, at most 2 * ADC_STREAM_MAX_LENGTH)
+ * @param delay_cycles ADCCLK cycles between two sampling phases (5 to 20)
+ * @param callback Function called on half and full transfer, may be NULL
+ *
+ * DMA mode 2 moves one 32-bit word per request with the earlier conversion in
+ * bits 15:0 and the later one in bits 31:16 (ADC2|ADC1, ADC1|ADC3, ADC3|ADC2).
+ * On this little-endian core the buffer read as half-words is therefore the
+ * ordered stream ADC1, ADC2, ADC3, ADC1, ... without any copy.
+ * With 3-cycle sampling a conversion takes 15 ADCCLK cycles, so delay_cycles = 5
+ * spaces the three phases evenly and yields ADC_CLOCK_FREQ / 5 samples/s.
+*/
+extern void adc_interleaved_start(uint8_t channel, volatile uint16_t* buffer, uint32_t length, uint8_t delay_cycles, ADC_Stream_Callback callback);
+
+/**
+ * @brief Stop triple interleaved sampling and return the ADCs to independent mode
+*/
+extern void adc_interleaved_stop(void);
+
+/**
+ * @brief Get the index in the buffer the DMA will write next
+ * @param ADCx Pointer to ADC peripheral being streamed
+ * @return Index of the next sample to be written
+*/
+extern uint32_t adc_stream_get_write_index(ADC_TypeDef* ADCx);
+
+/**
+ * @brief Get the most recently converted sample of the stream
+ * @param ADCx Pointer to ADC peripheral being streamed
+ * @return The last sample the DMA wrote into the buffer
+*/
+extern uint16_t adc_stream_get_latest(ADC_TypeDef* ADCx);
+
+#endif /* ADC_STREAM_H_ */
@@ -0,0 +1,61 @@
+/**
+ * @file adc_trigger.h
+ * @brief Header file for timer-paced ADC sampling
+ *
+ * This file contains declarations for driving the regular conversions of an
+ * ADC from the TRGO output of TIM2 or TIM3, so the sample period is set by
+ * hardware instead of by the main loop.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef ADC_TRIGGER_H_
+#define ADC_TRIGGER_H_
+
+#include <stdint.h>
+#include <assert.h>
+#include "pll.h"
+#include "stm32f446xx.h"
+
+// ADC_CR2 EXTSEL codes of the timer TRGO events (RM0390, ADC_CR2 register)
+#define ADC_EXTSEL_TIM2_TRGO    (ADC_CR2_EXTSEL_2 | ADC_CR2_EXTSEL_1)  /**< 0b0110 */
+#define ADC_EXTSEL_TIM3_TRGO    (ADC_CR2_EXTSEL_3)                     /**< 0b1000 */
+
+// ADC_CR2 EXTEN: convert on the rising edge of the trigger
+#define ADC_EXTEN_RISING        (ADC_CR2_EXTEN_0)
+
+/**
+ * @brief Configure a timer to trigger the regular conversions of an ADC
+ * @param ADCx Pointer to ADC peripheral to be triggered
+ * @param TIMx Timer generating the trigger (TIM2 or TIM3)
+ * @param rate_hz Requested sample rate in Hz
+ * @return The sample rate actually produced by the timer, in Hz
+ *
+ * The timer is left stopped; call adc_trigger_start() once the ADC (and its
+ * DMA stream, if any) is ready to receive conversions.
+*/
+extern uint32_t adc_trigger_config(ADC_TypeDef* ADCx, TIM_TypeDef* TIMx, uint32_t rate_hz);
+
+/**
+ * @brief Start generating trigger events
+ * @param TIMx Timer previously configured with adc_trigger_config()
+*/
+extern void adc_trigger_start(TIM_TypeDef* TIMx);
+
+/**
+ * @brief Stop generating trigger events
+ * @param TIMx Timer previously configured with adc_trigger_config()
+*/
+extern void adc_trigger_stop(TIM_TypeDef* TIMx);
+
+/**
+ * @brief Generate a single trigger event by software
+ * @param TIMx Timer previously configured with adc_trigger_config()
+ *
+ * Setting UG raises an update event, which MMS routes to TRGO, so one
+ * conversion of the sequence starts even while the timer is stopped.
+*/
+extern void adc_trigger_fire(TIM_TypeDef* TIMx);
+
+#endif /* ADC_TRIGGER_H_ */
@@ -0,0 +1,41 @@
+/**
+ * @file cobs.h
+ * @brief Header file for Consistent Overhead Byte Stuffing
+ *
+ * COBS removes every 0x00 from a packet at a cost of at most one byte per
+ * 254, so 0x00 can delimit packets on the serial line and a receiver can
+ * resynchronize at the next delimiter after any corruption.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef COBS_H_
+#define COBS_H_
+
+#include <stdint.h>
+
+#define COBS_DELIMITER 0x00u /**< Byte that separates encoded packets */
+
+/** @brief Worst-case encoded size of a packet of n bytes (delimiter not included) */
+#define COBS_MAX_ENCODED_LENGTH(n) ((n) + ((n) / 254u) + 1u)
+
+/**
+ * @brief Encode a packet
+ * @param input Packet bytes
+ * @param length Number of packet bytes
+ * @param output Destination, at least COBS_MAX_ENCODED_LENGTH(length) bytes
+ * @return Number of encoded bytes written (no delimiter is appended)
+*/
+extern uint32_t cobs_encode(const uint8_t* input, uint32_t length, uint8_t* output);
+
+/**
+ * @brief Decode a packet received between two delimiters
+ * @param input Encoded bytes, without the delimiter
+ * @param length Number of encoded bytes
+ * @param output Destination, at least length bytes
+ * @return Number of decoded bytes, 0 if the input is not valid COBS
+*/
+extern uint32_t cobs_decode(const uint8_t* input, uint32_t length, uint8_t* output);
+
+#endif /* COBS_H_ */
@@ -0,0 +1,183 @@
+/**
+ * @file command.h
+ * @brief Header file for the USART2 command interpreter
+ *
+ * Commands arrive in one of two forms on the same line:
+ *
+ * Text, terminated by '\r' or '\n', case-insensitive, numbers in decimal
+ * or 0x hex, separated by spaces or commas:
+ *
+ *   START [rate_hz]     start (or re-pace) timer-triggered acquisition
+ *   STOP                stop acquisition
+ *   SNAP n              return the n latest samples (acquires them if stopped)
+ *   SET ch [ch ...]     select the channels of the regular sequence
+ *   STAT                return the acquisition state and error counters
+ *   TABLE | BINARY      select the output format
+ *   PROBE [n]           return count, min, max and mean cycles of probe n,
+ *                       or the mean of every probe (see profile.h)
+ *   TRIG width [phase]  pulse PB5 for width ns, phase ns after every ADC
+ *                       trigger (see strobe.h); TRIG 0 turns it off
+ *   BITS [bits]         oversample one channel to 12..16 bit telemetry
+ *                       (see oversample.h), return the bits and the ratio
+ *
+ *   and are answered with "OK <NAME> [values]\r\n" or "ERR <reason>\r\n".
+ *
+ * Binary, a COBS frame between two 0x00 bytes. Before encoding:
+ *
+ *   [0] command id  [1] argc  [2..] argc x u32 LE  [end-2] CRC-16 LE
+ *
+ *   and answered with a COBS frame followed by 0x00:
+ *
+ *   [0] COMMAND_RESPONSE_TYPE  [1] command id  [2] status  [3] count
+ *   [4..] count x u32 LE  [end-2] CRC-16 LE
+ *
+ * The response type cannot be mistaken for a telemetry packet, so a host
+ * decoding the telemetry stream can pick responses out of it.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+#include <stdint.h>
+#include "cobs.h"
+
+#define COMMAND_MAX_ARGS            8u      /**< Arguments of one command at most */
+#define COMMAND_MAX_VALUES          16u     /**< Values of one response at most */
+#define COMMAND_LINE_SIZE           64u     /**< Longest text command, terminator excluded */
+#define COMMAND_RESPONSE_TYPE       0x10u   /**< First byte of a binary response */
+
+/** @brief Largest binary request before COBS encoding */
+#define COMMAND_MAX_PACKET_LENGTH   (2u + (COMMAND_MAX_ARGS * 4u) + 2u)
+
+/** @brief Largest binary request on the wire, both delimiters included */
+#define COMMAND_MAX_FRAME_LENGTH    (COBS_MAX_ENCODED_LENGTH(COMMAND_MAX_PACKET_LENGTH) + 2u)
+
+/** @brief Largest reply in either form */
+#define COMMAND_MAX_REPLY_LENGTH    (16u + (COMMAND_MAX_VALUES * 11u) + 2u)
+
+/**
+ * @brief Command identifiers, also the opcodes of the binary form
+*/
+typedef enum {
+    COMMAND_START = 0,
+    COMMAND_STOP,
+    COMMAND_SNAP,
+    COMMAND_SET,
+    COMMAND_STAT,
+    COMMAND_TABLE,
+    COMMAND_BINARY,
+    COMMAND_PROBE,
+    COMMAND_TRIG,
+    COMMAND_BITS,
+    COMMAND_COUNT
+} Command_Id_Type;
+
+/**
+ * @brief Outcome of a command, sent back in the reply
+*/
+typedef enum {
+    COMMAND_OK = 0,
+    COMMAND_ERROR_UNKNOWN,      /**< No such command */
+    COMMAND_ERROR_ARGUMENT,     /**< Wrong number or value of arguments */
+    COMMAND_ERROR_STATE,        /**< Not possible right now */
+    COMMAND_ERROR_FRAME,        /**< Binary frame malformed or CRC mismatch */
+} Command_Status_Type;
+
+/**
+ * @brief A parsed command
+*/
+typedef struct {
+    uint8_t id;                         /**< Command_Id_Type */
+    uint8_t argc;                       /**< Number of arguments */
+    uint32_t argv[COMMAND_MAX_ARGS];    /**< Arguments */
+} Command_Type;
+
+/**
+ * @brief What a handler reports back
+*/
+typedef struct {
+    uint8_t status;                         /**< Command_Status_Type */
+    uint8_t count;                          /**< Number of values */
+    uint32_t values[COMMAND_MAX_VALUES];    /**< Values returned on success */
+} Command_Response_Type;
+
+/**
+ * @brief Executes one command
+ * @param command Validated command, argc within the limits of its id
+ * @param response Preset to COMMAND_OK with no values
+*/
+typedef void (*Command_Handler)(const Command_Type* command, Command_Response_Type* response);
+
+/**
+ * @brief Byte-wise assembler of incoming commands
+*/
+typedef struct {
+    uint8_t buffer[(COMMAND_LINE_SIZE > COMMAND_MAX_FRAME_LENGTH)? COMMAND_LINE_SIZE: COMMAND_MAX_FRAME_LENGTH];
+    uint32_t length;    /**< Bytes collected for the current command */
+    uint8_t binary;     /**< Collecting a COBS frame (a 0x00 was seen) */
+    uint8_t overflow;   /**< Current command outgrew the buffer */
+} Command_Reader_Type;
+
+/**
+ * @brief Reset a reader
+ * @param reader Reader to initialize
+*/
+extern void command_reader_init(Command_Reader_Type* reader);
+
+/**
+ * @brief Feed one received byte and run the command it completes
+ * @param reader Reader collecting the command
+ * @param byte Received byte
+ * @param handlers Handler of every command, indexed by Command_Id_Type
+ * @param reply Destination of the reply, at least COMMAND_MAX_REPLY_LENGTH bytes
+ * @return Length of the reply, 0 while no command is complete
+*/
+extern uint32_t command_reader_feed(Command_Reader_Type* reader, uint8_t byte, const Command_Handler handlers[COMMAND_COUNT], uint8_t* reply);
+
+/**
+ * @brief Parse a text command
+ * @param line Command text without terminator
+ * @param length Number of characters
+ * @param command Destination of the parsed command
+ * @return COMMAND_OK, COMMAND_ERROR_UNKNOWN or COMMAND_ERROR_ARGUMENT
+*/
+extern uint8_t command_parse_text(const char* line, uint32_t length, Command_Type* command);
+
+/**
+ * @brief Parse a binary command
+ * @param frame COBS encoded bytes, delimiters excluded
+ * @param length Number of encoded bytes
+ * @param command Destination of the parsed command
+ * @return COMMAND_OK, COMMAND_ERROR_FRAME, COMMAND_ERROR_UNKNOWN or COMMAND_ERROR_ARGUMENT
+*/
+extern uint8_t command_parse_binary(const uint8_t* frame, uint32_t length, Command_Type* command);
+
+/**
+ * @brief Build the binary form of a command (host side)
+ * @param command Command to send
+ * @param frame Destination, at least COMMAND_MAX_FRAME_LENGTH bytes
+ * @return Number of bytes written, both delimiters included
+*/
+extern uint32_t command_encode_binary(const Command_Type* command, uint8_t* frame);
+
+/**
+ * @brief Parse a binary response (host side)
+ * @param frame COBS encoded bytes, delimiter excluded
+ * @param length Number of encoded bytes
+ * @param id Destination of the command id
+ * @param response Destination of the response
+ * @return 1 if the frame is a well-formed response, 0 otherwise
+*/
+extern uint8_t command_decode_response(const uint8_t* frame, uint32_t length, uint8_t* id, Command_Response_Type* response);
+
+/**
+ * @brief Name of a command
+ * @param id Command_Id_Type
+ * @return Upper-case name, "?" for an unknown id
+*/
+extern const char* command_name(uint8_t id);
+
+#endif /* COMMAND_H_ */
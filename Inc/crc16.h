@@ -0,0 +1,36 @@
+/**
+ * @file crc16.h
+ * @brief Header file for the CRC-16/CCITT-FALSE checksum
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection, no final XOR.
+ * crc16_ccitt("123456789") == 0x29B1.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef CRC16_H_
+#define CRC16_H_
+
+#include <stdint.h>
+
+#define CRC16_CCITT_INIT 0xFFFFu /**< Initial value of a fresh checksum */
+
+/**
+ * @brief Compute or continue a CRC-16/CCITT-FALSE checksum
+ * @param crc Running checksum (CRC16_CCITT_INIT for a new one)
+ * @param data Bytes to add
+ * @param length Number of bytes
+ * @return Updated checksum
+*/
+extern uint16_t crc16_ccitt_update(uint16_t crc, const uint8_t* data, uint32_t length);
+
+/**
+ * @brief Compute the CRC-16/CCITT-FALSE checksum of a buffer
+ * @param data Bytes to checksum
+ * @param length Number of bytes
+ * @return Checksum
+*/
+extern uint16_t crc16_ccitt(const uint8_t* data, uint32_t length);
+
+#endif /* CRC16_H_ */
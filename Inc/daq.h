@@ -0,0 +1,89 @@
+/**
+ * @file daq.h
+ * @brief Header file for the acquisition controller
+ *
+ * This file contains declarations for the part of the firmware that owns
+ * ADC1 acquisition: TIM2-paced DMA streaming, the command handlers that
+ * start, stop, re-pace and re-sequence it over USART2, and the binary
+ * telemetry output.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef DAQ_H_
+#define DAQ_H_
+
+#include <stdint.h>
+#include "command.h"
+#include "telemetry.h"
+
+#define DAQ_STREAM_LENGTH       64u     /**< Samples in the circular DMA buffer of ADC1 */
+#define DAQ_DEFAULT_RATE_HZ     1000u   /**< TIM2 paces ADC1 at this rate after reset */
+#define DAQ_MAX_RATE_HZ         100000u /**< Fastest rate START accepts */
+#define DAQ_DEFAULT_CHANNEL     1u      /**< PA1 */
+
+#define DAQ_OUTPUT_TABLE        0u      /**< ANSI table of the latest sample, drawn by main() */
+#define DAQ_OUTPUT_BINARY       1u      /**< Every sample, COBS framed (see telemetry.h) */
+
+#ifndef DAQ_DEFAULT_OUTPUT
+#define DAQ_DEFAULT_OUTPUT      DAQ_OUTPUT_TABLE
+#endif
+
+#ifndef DAQ_TELEMETRY_ENCODING
+#define DAQ_TELEMETRY_ENCODING  TELEMETRY_TYPE_DELTA   /**< Slow signals compress 3x, others fall back to packed */
+#endif
+
+/**
+ * @brief Set up ADC1 on the default channel and start paced acquisition
+ *
+ * GPIO ports must be initialized beforehand. USART2 is not touched here;
+ * its transmit DMA and receive interrupt only need to be running before
+ * daq_poll(), daq_serve_commands() or daq_send_telemetry() is first called.
+*/
+extern void daq_init(void);
+
+/**
+ * @brief Run received commands and send ready telemetry; call from the main loop
+ *
+ * Same as daq_serve_commands() followed by daq_send_telemetry().
+*/
+extern void daq_poll(void);
+
+/**
+ * @brief Run every command completed by the bytes received so far
+*/
+extern void daq_serve_commands(void);
+
+/**
+ * @brief Send the half buffer filled last, in binary output mode only
+ *
+ * With BITS above 12 the half buffer is decimated instead (see oversample.h)
+ * and a TELEMETRY_TYPE_WIDE16 frame leaves every DAQ_STREAM_LENGTH / 2 results.
+*/
+extern void daq_send_telemetry(void);
+
+/**
+ * @brief Call a function each time a half buffer of samples is ready
+ * @param callback Runs in the DMA2 Stream 0 interrupt, NULL to disable
+*/
+extern void daq_set_ready_callback(void (*callback)(void));
+
+/**
+ * @brief Get the selected output format
+ * @return DAQ_OUTPUT_TABLE or DAQ_OUTPUT_BINARY
+*/
+extern uint8_t daq_get_output_mode(void);
+
+/**
+ * @brief Get the most recent sample of the stream
+ * @return 12-bit conversion result
+*/
+extern uint16_t daq_get_latest(void);
+
+/**
+ * @brief Handlers of every command, indexed by Command_Id_Type
+*/
+extern const Command_Handler daq_command_handlers[COMMAND_COUNT];
+
+#endif /* DAQ_H_ */
@@ -0,0 +1,44 @@
+/**
+ * @file delta_codec.h
+ * @brief Header file for delta compression of 12-bit sample blocks
+ *
+ * Each sample is sent as the difference to the previous one (the first to
+ * zero, so every block decodes on its own). The difference is zigzag mapped
+ * (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...) and written as a little-endian
+ * varint of 3-bit groups, one group per nibble with bit 3 set when another
+ * group follows. Nibbles fill each byte low half first; an odd final nibble
+ * is padded with zero.
+ *
+ * A change of at most +-3 LSB costs half a byte, +-31 LSB one byte, and a
+ * full-scale step five nibbles.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef DELTA_CODEC_H_
+#define DELTA_CODEC_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Compress a block of 12-bit samples, bits 15:12 are ignored
+ * @param samples Samples to compress
+ * @param count Number of samples
+ * @param output Destination of at least max_length bytes
+ * @param max_length Give up once the output would exceed this size
+ * @return Number of bytes written, 0 if the block did not fit in max_length
+*/
+extern uint32_t delta_encode(const uint16_t* samples, uint32_t count, uint8_t* output, uint32_t max_length);
+
+/**
+ * @brief Expand a block compressed by delta_encode()
+ * @param input Compressed bytes
+ * @param length Number of compressed bytes
+ * @param count Number of samples the block holds
+ * @param samples Destination of count samples
+ * @return 1 if the block decoded to exactly length bytes of valid samples, 0 otherwise
+*/
+extern uint8_t delta_decode(const uint8_t* input, uint32_t length, uint32_t count, uint16_t* samples);
+
+#endif /* DELTA_CODEC_H_ */
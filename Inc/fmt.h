@@ -0,0 +1,93 @@
+/**
+ * @file fmt.h
+ * @brief Header file for allocation-free text formatting
+ *
+ * This file contains declarations for the small set of conversions the
+ * firmware prints (padded strings, fixed-width decimal and hex numbers,
+ * color escape codes). Everything is appended to a caller-provided buffer,
+ * typically a USART2_tx_reserve() region, so no heap, no stdio and no
+ * varargs parsing is involved.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef FMT_H_
+#define FMT_H_
+
+#include <stdint.h>
+
+#define FMT_LEFT    0x01u   /**< Pad on the right instead of the left, like "%-" */
+#define FMT_ZERO    0x02u   /**< Pad numbers with '0' instead of ' ', like "%0" */
+
+/**
+ * @brief Destination of formatted text
+ *
+ * Appends that do not fit are cut short and set overflow; length never
+ * exceeds size and no NUL is written unless fmt_char(buffer, '\0') asks for it.
+*/
+typedef struct {
+    char* data;         /**< Start of the buffer */
+    uint32_t length;    /**< Characters written so far */
+    uint32_t size;      /**< Capacity of data */
+    uint8_t overflow;   /**< Set once something did not fit */
+} Fmt_Buffer_Type;
+
+/**
+ * @brief Start formatting into a buffer
+ * @param buffer Formatter state
+ * @param data Destination, may be NULL with size 0 (everything overflows)
+ * @param size Capacity of data
+*/
+extern void fmt_init(Fmt_Buffer_Type* buffer, char* data, uint32_t size);
+
+/**
+ * @brief Append one character
+ * @param buffer Formatter state
+ * @param c Character to append
+*/
+extern void fmt_char(Fmt_Buffer_Type* buffer, char c);
+
+/**
+ * @brief Append a string padded with spaces to a minimum width ("%-9s" / "%9s")
+ * @param buffer Formatter state
+ * @param string NUL-terminated string
+ * @param width Minimum number of characters, 0 for none
+ * @param flags FMT_LEFT to pad on the right
+*/
+extern void fmt_str(Fmt_Buffer_Type* buffer, const char* string, uint8_t width, uint8_t flags);
+
+/**
+ * @brief Append an unsigned decimal number ("%-4lu" / "%04lu")
+ * @param buffer Formatter state
+ * @param value Number to append
+ * @param width Minimum number of characters, 0 for none
+ * @param flags FMT_LEFT and/or FMT_ZERO (ignored with FMT_LEFT)
+*/
+extern void fmt_u32(Fmt_Buffer_Type* buffer, uint32_t value, uint8_t width, uint8_t flags);
+
+/**
+ * @brief Append a signed decimal number ("%-4ld" / "%04ld")
+ * @param buffer Formatter state
+ * @param value Number to append
+ * @param width Minimum number of characters, sign included
+ * @param flags FMT_LEFT and/or FMT_ZERO
+*/
+extern void fmt_i32(Fmt_Buffer_Type* buffer, int32_t value, uint8_t width, uint8_t flags);
+
+/**
+ * @brief Append an upper-case hex number with a fixed number of digits ("%08lX")
+ * @param buffer Formatter state
+ * @param value Number to append
+ * @param digits Number of digits, 1 to 8; higher digits of value are dropped
+*/
+extern void fmt_hex(Fmt_Buffer_Type* buffer, uint32_t value, uint8_t digits);
+
+/**
+ * @brief Append an ANSI color code such as KCYN or BHRED from usart.h
+ * @param buffer Formatter state
+ * @param code Escape sequence to append
+*/
+extern void fmt_color(Fmt_Buffer_Type* buffer, const char* code);
+
+#endif /* FMT_H_ */
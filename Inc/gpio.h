@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include "pll.h"
+#include "hw_poll.h"
 #include "stm32f446xx.h"
 
 /**
@@ -216,6 +217,27 @@ typedef enum {
 #define AF14                         ((uint8_t)14)
 #define AF15                         ((uint8_t)15)
 
+/*
+ * Pin descriptors
+ *
+ * A GPIOx_Pin_Type is port * 16 + pin number, and ports A to H are 0x400
+ * apart on AHB1, so the port registers and the pin mask of a pin are plain
+ * arithmetic. With a constant pin such as PA12 every macro below folds to a
+ * constant at compile time (GPIOA, 1 << 12) and needs no table at all.
+*/
+#define GPIOx_PORT_SHIFT             4u                                                /**< log2(NUM_PINS_PER_PORT) */
+#define GPIOx_PORT_STRIDE            (GPIOB_BASE - GPIOA_BASE)
+#define GPIOx_PORT(port)             ((GPIO_TypeDef*)(GPIOA_BASE + ((uint32_t)(port) * GPIOx_PORT_STRIDE)))
+#define GPIOx_PIN_PORT(pin)          ((uint32_t)(pin) >> GPIOx_PORT_SHIFT)              /**< Port of a pin, PA to PH */
+#define GPIOx_PIN_NUMBER(pin)        ((uint32_t)(pin) & (NUM_PINS_PER_PORT - 1u))       /**< Pin number within its port */
+#define GPIOx_PIN_BIT(pin)           (1uL << GPIOx_PIN_NUMBER(pin))                     /**< Mask of a pin within its port */
+#define GPIOx_PIN_GPIO(pin)          GPIOx_PORT(GPIOx_PIN_PORT(pin))                    /**< Registers of the port of a pin */
+#define BSRR_RESET_SHIFT             16u                                               /**< BSRR[31:16] clears ODR bits */
+
+#if (1u << GPIOx_PORT_SHIFT) != NUM_PINS_PER_PORT
+#error "GPIOx_PORT_SHIFT does not match NUM_PINS_PER_PORT"
+#endif
+
 // Function prototypes for GPIO operations
 
 
@@ -272,6 +294,14 @@ extern void GPIOx_set_odr(uint8_t pin);
 */
 extern void GPIOx_reset_odr(uint8_t pin);
 
+/**
+ * @brief Drive several pins of one port in a single store
+ * @param port The port (PA to PH)
+ * @param mask Pins to drive, one bit per pin (see GPIOx_PIN_BIT())
+ * @param value Level of each pin in mask; pins outside mask keep their level
+*/
+extern void GPIOx_write_port(uint8_t port, uint16_t mask, uint16_t value);
+
 /**
  * @brief Get the input data register (IDR) value of a GPIO pin
  * @param pin The pin to read
@@ -279,4 +309,51 @@ extern void GPIOx_reset_odr(uint8_t pin);
 */
 extern uint8_t GPIOx_get_idr(uint8_t pin);
 
+/*
+ * Inline BSRR accessors
+ *
+ * A write to BSRR sets or clears ODR bits in hardware, leaving every other
+ * pin alone, so unlike a read-modify-write of ODR these cannot lose an update
+ * made by an interrupt in between, and they are safe to call from one. With a
+ * constant pin each compiles to a single store.
+*/
+
+/**
+ * @brief Drive a pin high
+ * @param pin The pin to set
+*/
+static inline void GPIOx_bsrr_set(uint8_t pin) {
+    GPIOx_PIN_GPIO(pin)->BSRR = GPIOx_PIN_BIT(pin);
+    HW_SYNC();
+}
+
+/**
+ * @brief Drive a pin low
+ * @param pin The pin to reset
+*/
+static inline void GPIOx_bsrr_reset(uint8_t pin) {
+    GPIOx_PIN_GPIO(pin)->BSRR = GPIOx_PIN_BIT(pin) << BSRR_RESET_SHIFT;
+    HW_SYNC();
+}
+
+/**
+ * @brief Drive several pins of one port in a single store
+ * @param port The port (PA to PH)
+ * @param mask Pins to drive
+ * @param value Level of each pin in mask
+*/
+static inline void GPIOx_bsrr_write(uint8_t port, uint16_t mask, uint16_t value) {
+    GPIOx_PORT(port)->BSRR = ((uint32_t)(mask & (uint16_t)~value) << BSRR_RESET_SHIFT) | (uint32_t)(mask & value);
+    HW_SYNC();
+}
+
+/**
+ * @brief Read the level of a pin
+ * @param pin The pin to read
+ * @return 1 if the pin is high, 0 if it is low
+*/
+static inline uint8_t GPIOx_idr_read(uint8_t pin) {
+    return (GPIOx_PIN_GPIO(pin)->IDR & GPIOx_PIN_BIT(pin)) != 0u;
+}
+
 #endif /* GPIO_H_ */
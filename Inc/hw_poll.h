@@ -0,0 +1,38 @@
+/**
+ * @file hw_poll.h
+ * @brief Hooks that let busy-wait loops run against the host simulator
+ *
+ * On the target these macros cost nothing: HW_POLL(condition) is the
+ * condition itself and HW_SYNC() is empty. In a SIM_BUILD (see
+ * Sim/sim_device.h) registers are plain memory that only changes when the
+ * simulator runs, so every loop waiting on a register flag is written as
+ *
+ *     while (HW_POLL(!(RCC->CR & RCC_CR_HSIRDY)));
+ *
+ * which advances virtual time by one step before each test of the flag, and
+ * HW_SYNC() follows writes whose effect must be visible before the next
+ * statement (BSRR, a timer update event generated through EGR).
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef HW_POLL_H_
+#define HW_POLL_H_
+
+#ifdef SIM_BUILD
+
+extern void sim_poll(void);
+extern void sim_sync(void);
+
+#define HW_POLL(condition)  (sim_poll(), (condition))
+#define HW_SYNC()           sim_sync()
+
+#else
+
+#define HW_POLL(condition)  (condition)
+#define HW_SYNC()           ((void)0)
+
+#endif
+
+#endif /* HW_POLL_H_ */
@@ -0,0 +1,79 @@
+/**
+ * @file oversample.h
+ * @brief Header file for the oversample-and-decimate stage
+ *
+ * This file contains declarations for trading sample rate for resolution:
+ * every 4^n consecutive 12-bit conversions are summed and the sum shifted
+ * right by n (rounded), giving one (12 + n)-bit result at 1/4^n of the
+ * conversion rate. The extra bits are only real when the input carries
+ * at least 1 LSB of noise (the ADC's own noise usually does), and the
+ * signal is assumed constant over the 4^n conversions.
+ *
+ *   n   samples per result   result bits   range
+ *   0   1                    12            0 to 4095 (pass-through)
+ *   1   4                    13            0 to 8190
+ *   2   16                   14            0 to 16380
+ *   3   64                   15            0 to 32760
+ *   4   256                  16            0 to 65520
+ *
+ * Blocks of any length can be fed in, a result may straddle two of them
+ * (a DMA half buffer holds 32 conversions, a 16-bit result needs 256).
+ * On the Cortex-M4 the sum runs two samples per instruction with __SADD16
+ * and folds into the 32-bit total with __SMLAD; other builds use plain C
+ * versions of the two instructions.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef OVERSAMPLE_H_
+#define OVERSAMPLE_H_
+
+#include <stdint.h>
+
+#define OVERSAMPLE_MAX_EXTRA_BITS   4u      /**< 256 samples per 16-bit result */
+#define OVERSAMPLE_INPUT_BITS       12u     /**< Inputs must be right-aligned 12-bit codes */
+
+/**
+ * @brief State of one oversampled channel
+*/
+typedef struct {
+    uint8_t extra_bits;     /**< n, 0 to OVERSAMPLE_MAX_EXTRA_BITS */
+    uint32_t ratio;         /**< 4^n samples per result */
+    uint32_t pending;       /**< Samples summed toward the next result */
+    uint32_t sum;           /**< Their sum */
+} Oversample_Type;
+
+/**
+ * @brief Set the number of extra bits and drop any partial sum
+ * @param stage Stage to initialize
+ * @param extra_bits n, at most OVERSAMPLE_MAX_EXTRA_BITS (larger values are clipped)
+*/
+extern void oversample_init(Oversample_Type* stage, uint8_t extra_bits);
+
+/**
+ * @brief Drop the samples summed toward the next result, e.g. after a gap in the input
+ * @param stage Stage to reset
+*/
+extern void oversample_reset(Oversample_Type* stage);
+
+/**
+ * @brief Feed a block of conversions
+ * @param stage Stage state
+ * @param samples Right-aligned 12-bit samples of one channel
+ * @param count Number of samples
+ * @param results Destination of the results, at least count / 4^n + 1 entries
+ * @return Number of results written
+*/
+extern uint32_t oversample_process(Oversample_Type* stage, const uint16_t* samples, uint32_t count, uint16_t* results);
+
+/**
+ * @brief Resolution of the results
+ * @param stage Stage state
+ * @return 12 + n
+*/
+static inline uint8_t oversample_bits(const Oversample_Type* stage) {
+    return (uint8_t)(OVERSAMPLE_INPUT_BITS + stage->extra_bits);
+}
+
+#endif /* OVERSAMPLE_H_ */
@@ -0,0 +1,44 @@
+/**
+ * @file pack12.h
+ * @brief Header file for packing 12-bit samples
+ *
+ * Conversion results only use the low 12 bits of their 16-bit slot. Two
+ * samples a and b are packed into three bytes as the little-endian 24-bit
+ * value a | (b << 12):
+ *
+ *   byte 0 = a[7:0]
+ *   byte 1 = b[3:0] << 4 | a[11:8]
+ *   byte 2 = b[11:4]
+ *
+ * An odd trailing sample takes two bytes with the upper nibble cleared.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef PACK12_H_
+#define PACK12_H_
+
+#include <stdint.h>
+
+/** @brief Bytes taken by n packed samples */
+#define PACK12_LENGTH(n) ((((n) * 3u) + 1u) / 2u)
+
+/**
+ * @brief Pack 12-bit samples, bits 15:12 of every sample are ignored
+ * @param samples Samples to pack
+ * @param count Number of samples
+ * @param output Destination, at least PACK12_LENGTH(count) bytes, any alignment
+ * @return Number of bytes written
+*/
+extern uint32_t pack12(const uint16_t* samples, uint32_t count, uint8_t* output);
+
+/**
+ * @brief Unpack samples packed by pack12()
+ * @param input Packed bytes, any alignment
+ * @param count Number of samples to unpack
+ * @param samples Destination of count samples
+*/
+extern void unpack12(const uint8_t* input, uint32_t count, uint16_t* samples);
+
+#endif /* PACK12_H_ */
@@ -18,11 +18,14 @@
 #define HCLK_FREQ       180000000uL
 #define APB1_FREQ       (HCLK_FREQ/4)
 #define APB2_FREQ       (HCLK_FREQ/2)
+#define APB1_TIMER_FREQ (APB1_FREQ*2)   /* APB1 timers run at 2x PCLK1 when PPRE1 != 1 */
 
 extern void clockSpeed_PLL(void);
 extern void SysTick_Init();
 extern void SysTick_Handler();
 extern void delay_ms(uint32_t ms);
+extern void delay_us(uint32_t us);
 extern uint32_t getMillis();
+extern uint32_t get_micros();   /* microseconds since SysTick_Init(), wraps after ~71.6 min */
 
 #endif /* PLL_H_ */
@@ -0,0 +1,123 @@
+/**
+ * @file profile.h
+ * @brief Header file for cycle-accurate probes around driver calls
+ *
+ * This file contains declarations for timing named sections of code with the
+ * DWT cycle counter (CYCCNT, one count per HCLK cycle, wraps every ~23.8 s at
+ * 180 MHz). Every probe keeps the number of runs and the shortest, longest
+ * and total duration, which the PROBE command reports over USART2.
+ *
+ * Probes are compiled in only when PROFILE_ENABLED is 1 (add
+ * -DPROFILE_ENABLED=1 to the build); otherwise PROFILE_BEGIN/PROFILE_END
+ * expand to nothing and no counter is read. In a HOST_BUILD the counter is
+ * profile_mock_cycles, which a test advances by hand.
+ *
+ * Probes must begin and end in the same context, and a probe must not be
+ * used from both an interrupt and the main loop.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 0
+#endif
+
+#ifndef HOST_BUILD
+#include "stm32f446xx.h"
+#endif
+
+/**
+ * @brief Probe points, also the index taken by the PROBE command
+*/
+typedef enum {
+    PROFILE_GET_DATA = 0,   /**< get_data(): polled conversion */
+    PROFILE_TX_SEND,        /**< tx_send(): one blocking byte */
+    PROFILE_TABLE,          /**< print_table_in_serial_monitor() */
+    PROFILE_TELEMETRY,      /**< Encoding and queueing one telemetry frame */
+    PROFILE_COMMAND,        /**< Executing one received command */
+    PROFILE_OVERSAMPLE,     /**< Decimating one half buffer (BITS above 12) */
+    PROFILE_COUNT
+} Profile_Probe_Id_Type;
+
+/**
+ * @brief Accumulated durations of one probe, in CPU cycles
+*/
+typedef struct {
+    uint32_t count;     /**< Number of recorded runs */
+    uint32_t min;       /**< Shortest run, 0xFFFFFFFF before the first one */
+    uint32_t max;       /**< Longest run */
+    uint64_t total;     /**< Sum of all runs, for the mean */
+} Profile_Probe_Type;
+
+#if PROFILE_ENABLED
+
+#ifdef HOST_BUILD
+extern volatile uint32_t profile_mock_cycles;   /**< Stands in for DWT->CYCCNT */
+
+static inline uint32_t profile_cycles(void) {
+    return profile_mock_cycles;
+}
+#else
+/**
+ * @brief Read the free-running cycle counter
+ * @return DWT->CYCCNT
+*/
+static inline uint32_t profile_cycles(void) {
+    return DWT->CYCCNT;
+}
+#endif
+
+/** @brief Start timing probe, in the same block as the matching PROFILE_END */
+#define PROFILE_BEGIN(probe)    uint32_t profile_start_##probe = profile_cycles()
+
+/** @brief Stop timing probe and accumulate the elapsed cycles */
+#define PROFILE_END(probe)      profile_record((probe), profile_cycles() - profile_start_##probe)
+
+#else
+
+#define PROFILE_BEGIN(probe)    do {} while (0)
+#define PROFILE_END(probe)      do {} while (0)
+
+#endif /* PROFILE_ENABLED */
+
+/**
+ * @brief Start the DWT cycle counter and clear every probe
+ *
+ * Does nothing when PROFILE_ENABLED is 0.
+*/
+extern void profile_init(void);
+
+/**
+ * @brief Clear every probe
+*/
+extern void profile_reset(void);
+
+/**
+ * @brief Accumulate one run of a probe
+ * @param probe Profile_Probe_Id_Type
+ * @param cycles Duration of the run
+*/
+extern void profile_record(uint8_t probe, uint32_t cycles);
+
+/**
+ * @brief Copy the accumulators of a probe
+ * @param probe Profile_Probe_Id_Type
+ * @param result Destination of the accumulators
+ * @return 1 if probe exists and profiling is compiled in, 0 otherwise
+*/
+extern uint8_t profile_get(uint8_t probe, Profile_Probe_Type* result);
+
+/**
+ * @brief Mean duration of a probe
+ * @param probe Accumulators of the probe
+ * @return Mean cycles per run, 0 before the first run
+*/
+extern uint32_t profile_mean(const Profile_Probe_Type* probe);
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,84 @@
+/**
+ * @file sample_ring.h
+ * @brief Header file for the single-producer/single-consumer sample queue
+ *
+ * This file contains declarations for a lock-free ring of timestamped ADC
+ * samples. Exactly one context may push (the ADC interrupt) and exactly one
+ * context may pop (the main loop); neither side masks interrupts.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef SAMPLE_RING_H_
+#define SAMPLE_RING_H_
+
+#include <stdint.h>
+
+#define SAMPLE_RING_SIZE 256u                       /**< Number of slots, must be a power of two */
+#define SAMPLE_RING_MASK (SAMPLE_RING_SIZE - 1u)    /**< Index mask for the free-running counters */
+
+#if (SAMPLE_RING_SIZE & SAMPLE_RING_MASK) != 0
+#error "SAMPLE_RING_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief A single timestamped conversion result
+*/
+typedef struct {
+    uint32_t timestamp; /**< getMillis() when the conversion completed */
+    uint16_t value;     /**< 12-bit conversion result */
+    uint8_t adc;        /**< ADC_Port_Type of the converter */
+    uint8_t reserved;
+} ADC_Sample_Type;
+
+/**
+ * @brief Ring storage and indices
+ *
+ * head and tail run freely and wrap at 2^32; the slot is index & SAMPLE_RING_MASK.
+ * head is only written by the producer, tail only by the consumer.
+*/
+typedef struct {
+    volatile uint32_t head;     /**< Number of samples pushed so far */
+    volatile uint32_t tail;     /**< Number of samples popped so far */
+    volatile uint32_t overruns; /**< Samples dropped because the ring was full */
+    ADC_Sample_Type items[SAMPLE_RING_SIZE];
+} Sample_Ring_Type;
+
+/**
+ * @brief Empty the ring and reset its overrun counter
+ * @param ring Ring to initialize (must not be in use)
+*/
+extern void sample_ring_init(Sample_Ring_Type* ring);
+
+/**
+ * @brief Append a sample (producer side)
+ * @param ring Ring to push into
+ * @param sample Sample to copy into the ring
+ * @return 1 if the sample was stored, 0 if the ring was full and the sample was dropped
+*/
+extern uint8_t sample_ring_push(Sample_Ring_Type* ring, const ADC_Sample_Type* sample);
+
+/**
+ * @brief Remove the oldest sample (consumer side)
+ * @param ring Ring to pop from
+ * @param sample Destination of the oldest sample
+ * @return 1 if a sample was popped, 0 if the ring was empty
+*/
+extern uint8_t sample_ring_pop(Sample_Ring_Type* ring, ADC_Sample_Type* sample);
+
+/**
+ * @brief Number of samples waiting in the ring
+ * @param ring Ring to query
+ * @return Number of samples that can be popped
+*/
+extern uint32_t sample_ring_count(const Sample_Ring_Type* ring);
+
+/**
+ * @brief Number of samples dropped because the ring was full
+ * @param ring Ring to query
+ * @return Overrun counter
+*/
+extern uint32_t sample_ring_overruns(const Sample_Ring_Type* ring);
+
+#endif /* SAMPLE_RING_H_ */
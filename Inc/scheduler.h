@@ -0,0 +1,73 @@
+/**
+ * @file scheduler.h
+ * @brief Header file for the run-to-completion task scheduler
+ *
+ * This file contains declarations for a cooperative scheduler of up to
+ * SCHED_MAX_TASKS tasks. Each task owns one priority, which is also its bit
+ * in the ready word: interrupts post work by setting the bit, and the main
+ * loop runs the highest ready task, found with a single CLZ instruction.
+ * A task runs to completion and is not re-run until it is posted again;
+ * posts of a task that is already ready merge into one run.
+ *
+ * When nothing is ready the core sleeps in WFI until the next interrupt.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+
+#ifndef HOST_BUILD
+#include "stm32f446xx.h"
+#endif
+
+#define SCHED_MAX_TASKS     32u     /**< One bit of the ready word per task */
+
+/**
+ * @brief Body of a task
+*/
+typedef void (*Sched_Task)(void);
+
+/**
+ * @brief Forget every task and every pending post
+*/
+extern void sched_init(void);
+
+/**
+ * @brief Install the task of a priority
+ * @param priority 0 (lowest) to SCHED_MAX_TASKS - 1 (highest), unique per task
+ * @param task Function run when the priority is posted
+*/
+extern void sched_register(uint8_t priority, Sched_Task task);
+
+/**
+ * @brief Mark a task ready, from an interrupt or from the main loop
+ * @param priority Priority of the task
+*/
+extern void sched_post(uint8_t priority);
+
+/**
+ * @brief Run the highest ready task
+ * @return 1 if a task ran, 0 if none was ready
+*/
+extern uint8_t sched_run_once(void);
+
+/**
+ * @brief Sleep until the next interrupt, unless a task is ready
+ *
+ * Interrupts are masked around the check so a post landing just before
+ * WFI still wakes the core (a pending interrupt ends WFI even when
+ * PRIMASK is set) instead of being slept on.
+*/
+extern void sched_idle(void);
+
+/**
+ * @brief Number of sched_idle() calls that actually slept
+ * @return Sleep counter
+*/
+extern uint32_t sched_sleeps(void);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,91 @@
+/**
+ * @file soft_timer.h
+ * @brief Header file for the millisecond software timer wheel
+ *
+ * This file contains declarations for one-shot and periodic callbacks run
+ * from the main loop. Timers live in caller-owned storage and are hashed by
+ * expiry tick into a wheel of SOFT_TIMER_WHEEL_SIZE slots, so starting,
+ * stopping and advancing one tick only ever touches a single short list.
+ *
+ * Time comes from outside: soft_timer_poll() is handed getMillis() and runs,
+ * tick by tick, every timer that expired since the previous call. Callbacks
+ * therefore never run in interrupt context and may start or stop any
+ * timer, themselves included.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef SOFT_TIMER_H_
+#define SOFT_TIMER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SOFT_TIMER_WHEEL_SIZE   64u                             /**< Slots, must be a power of two */
+#define SOFT_TIMER_WHEEL_MASK   (SOFT_TIMER_WHEEL_SIZE - 1u)    /**< Slot of an expiry tick */
+
+#if (SOFT_TIMER_WHEEL_SIZE & SOFT_TIMER_WHEEL_MASK) != 0
+#error "SOFT_TIMER_WHEEL_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief Function run when a timer expires
+ * @param context Pointer given to soft_timer_start()
+*/
+typedef void (*Soft_Timer_Callback)(void* context);
+
+/**
+ * @brief One timer, owned by the caller and left alone while it is active
+ *
+ * The storage must start zeroed (static, or initialized with {0}).
+*/
+typedef struct Soft_Timer {
+    struct Soft_Timer* next;        /**< Next timer in the same wheel slot */
+    uint32_t expiry;                /**< Tick at which it fires */
+    uint32_t period;                /**< Reload in ms, 0 for a one-shot timer */
+    Soft_Timer_Callback callback;
+    void* context;
+    uint8_t active;                 /**< Linked into the wheel */
+} Soft_Timer_Type;
+
+/**
+ * @brief Empty the wheel and set the current tick
+ * @param now_ms Current time, usually getMillis()
+*/
+extern void soft_timer_init(uint32_t now_ms);
+
+/**
+ * @brief Arm a timer, re-arming it if it is already active
+ * @param timer Timer storage, must stay valid while the timer is active
+ * @param delay_ms Milliseconds from the last processed tick to the first expiry (0 acts as 1)
+ * @param period_ms Reload after every expiry, 0 for a one-shot timer
+ * @param callback Function run on expiry
+ * @param context Passed to callback
+ *
+ * A periodic timer is re-armed from its expiry tick, not from the time the
+ * callback ran, so its period does not drift when the main loop is late.
+*/
+extern void soft_timer_start(Soft_Timer_Type* timer, uint32_t delay_ms, uint32_t period_ms, Soft_Timer_Callback callback, void* context);
+
+/**
+ * @brief Disarm a timer, nothing happens if it is not active
+ * @param timer Timer to stop
+*/
+extern void soft_timer_stop(Soft_Timer_Type* timer);
+
+/**
+ * @brief Run the callbacks of every timer that expired up to now
+ * @param now_ms Current time, usually getMillis()
+ * @return Number of callbacks run
+*/
+extern uint32_t soft_timer_poll(uint32_t now_ms);
+
+/**
+ * @brief Check whether a timer is armed
+ * @param timer Timer to query
+ * @return 1 if the timer will fire, 0 otherwise
+*/
+extern uint8_t soft_timer_active(const Soft_Timer_Type* timer);
+
+#endif /* SOFT_TIMER_H_ */
@@ -0,0 +1,80 @@
+/**
+ * @file strobe.h
+ * @brief Header file for the trigger pulse output synchronized to sampling
+ *
+ * This file contains declarations for a pulse on PB5 (TIM3_CH2, AF2, D4 on
+ * the Nucleo header) that follows every TIM2 TRGO event, i.e. every ADC
+ * trigger of adc_trigger_config(ADCx, TIM2, ...), including the software
+ * triggers of adc_trigger_fire().
+ *
+ * TIM3 is a slave of TIM2 (ITR1) in trigger mode with one-pulse mode set:
+ * each TRGO starts the counter, CH2 in PWM mode 2 goes high when it reaches
+ * CCR2 (the phase) and the update at ARR stops the counter and ends the
+ * pulse. No software runs per sample. TIM3 is therefore no longer available
+ * to adc_trigger_config() while the strobe runs.
+ *
+ * The trigger input is resynchronized to the TIM3 clock, so the pulse lags
+ * the ADC trigger by a fixed 2-3 timer cycles (~25-35 ns at 90 MHz) on top
+ * of the requested phase; the ADC in turn starts sampling a few ADCCLK
+ * cycles after its trigger.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef STROBE_H_
+#define STROBE_H_
+
+#include <stdint.h>
+#include <assert.h>
+#include "pll.h"
+#include "stm32f446xx.h"
+#include "gpio.h"
+
+#define STROBE_PIN          PB5                 /**< TIM3_CH2 */
+#define STROBE_AF           AF2                 /**< TIM3 alternate function */
+#define STROBE_TIMER_FREQ   APB1_TIMER_FREQ     /**< TIM3 counter clock before prescaling */
+
+/**
+ * @brief Start emitting one pulse per TIM2 trigger event
+ * @param width_ns Requested pulse width in ns (at least one timer tick), replaced by the actual width
+ * @param phase_ns Requested delay from the trigger to the rising edge in ns, replaced by the actual delay
+ * @return 1 if the pulse is running, 0 if the width is 0 or the pulse does not fit the timer
+ *
+ * Both values are rounded to the timer resolution, 1/STROBE_TIMER_FREQ
+ * (11.1 ns) as long as phase + width stays under 728 us, coarser beyond.
+ * The phase is at least one tick. A trigger arriving before the previous
+ * pulse has ended is ignored, so phase + width must stay below the sample
+ * period.
+*/
+extern uint8_t strobe_start(uint32_t* width_ns, uint32_t* phase_ns);
+
+/**
+ * @brief Round a pulse exactly as strobe_start() would, without touching the timer
+ * @param width_ns Requested pulse width in ns, replaced by the actual width
+ * @param phase_ns Requested delay in ns, replaced by the actual delay
+ * @return 1 if strobe_start() would accept the pulse, 0 otherwise
+ *
+ * Lets a caller check the actual phase + width against the sample period
+ * before a running pulse is replaced.
+*/
+extern uint8_t strobe_round(uint32_t* width_ns, uint32_t* phase_ns);
+
+/**
+ * @brief Stop emitting pulses and hold the output low
+*/
+extern void strobe_stop(void);
+
+/**
+ * @brief Check whether pulses are being emitted
+ * @return 1 if running, 0 otherwise
+*/
+extern uint8_t strobe_running(void);
+
+/**
+ * @brief Get the time from a trigger to the end of its pulse
+ * @return Actual phase + width in ns of the running pulse, 0 when stopped
+*/
+extern uint64_t strobe_get_span_ns(void);
+
+#endif /* STROBE_H_ */
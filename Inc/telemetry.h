@@ -0,0 +1,94 @@
+/**
+ * @file telemetry.h
+ * @brief Header file for the binary telemetry stream
+ *
+ * Packet layout, little-endian, before COBS encoding:
+ *
+ *   offset  size  field
+ *   0       1     type (TELEMETRY_TYPE_*)
+ *   1       2     sequence number, +1 per packet
+ *   3       4     timestamp, getMillis() of the newest sample
+ *   7       2     channel mask (bit n = ADC channel n present)
+ *   9       1     number of samples n
+ *   10      ...   samples, encoded as given by the type:
+ *                   TELEMETRY_TYPE_PACKED12  3 bytes per pair (see pack12.h)
+ *                   TELEMETRY_TYPE_DELTA     delta + zigzag varint (see delta_codec.h)
+ *                   TELEMETRY_TYPE_WIDE16    1 byte of resolution (12 to 16 bits),
+ *                                            then 2 bytes LE per sample (see oversample.h)
+ *   end-2   2     CRC-16/CCITT-FALSE of all preceding bytes
+ *
+ * On the wire every packet is COBS encoded and followed by a 0x00 byte.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include "cobs.h"
+#include "pack12.h"
+#include "delta_codec.h"
+
+#define TELEMETRY_TYPE_PACKED12     0x01u   /**< Samples packed 2 per 3 bytes */
+#define TELEMETRY_TYPE_DELTA        0x02u   /**< Samples delta compressed */
+#define TELEMETRY_TYPE_WIDE16       0x03u   /**< Oversampled samples, 16 bits each */
+
+#define TELEMETRY_MAX_SAMPLES       64u     /**< Samples carried by one packet at most */
+#define TELEMETRY_HEADER_LENGTH     10u     /**< Bytes before the sample data */
+#define TELEMETRY_CRC_LENGTH        2u      /**< Bytes of the trailing checksum */
+#define TELEMETRY_BASE_BITS         12u     /**< Resolution of the PACKED12 and DELTA samples */
+#define TELEMETRY_MAX_BITS          16u     /**< Resolution of the WIDE16 samples at most */
+
+/** @brief Bytes of n samples in a TELEMETRY_TYPE_WIDE16 packet */
+#define TELEMETRY_WIDE16_LENGTH(n)  (1u + (2u * (n)))
+
+/** @brief Largest frame on the wire carrying data_length bytes of samples, delimiter included */
+#define TELEMETRY_FRAME_LENGTH(data_length) \
+    (COBS_MAX_ENCODED_LENGTH(TELEMETRY_HEADER_LENGTH + (data_length) + TELEMETRY_CRC_LENGTH) + 1u)
+
+/** @brief Largest packet before COBS encoding */
+#define TELEMETRY_MAX_PACKET_LENGTH \
+    (TELEMETRY_HEADER_LENGTH + TELEMETRY_WIDE16_LENGTH(TELEMETRY_MAX_SAMPLES) + TELEMETRY_CRC_LENGTH)
+
+/** @brief Largest frame on the wire, delimiter included */
+#define TELEMETRY_MAX_FRAME_LENGTH  (COBS_MAX_ENCODED_LENGTH(TELEMETRY_MAX_PACKET_LENGTH) + 1u)
+
+/**
+ * @brief Fields of a packet other than the samples
+*/
+typedef struct {
+    uint8_t type;           /**< TELEMETRY_TYPE_*, the encoding of the samples */
+    uint16_t sequence;      /**< Packet counter, wraps at 65536 */
+    uint32_t timestamp;     /**< Milliseconds since boot */
+    uint16_t channel_mask;  /**< ADC channels the samples come from */
+    uint8_t num_of_samples; /**< Samples in the packet, at most TELEMETRY_MAX_SAMPLES */
+    uint8_t bits;           /**< Resolution of TELEMETRY_TYPE_WIDE16 samples, 12 for the other types */
+} Telemetry_Header_Type;
+
+/**
+ * @brief Build a complete frame (packet, CRC, COBS, delimiter)
+ * @param header Packet fields
+ * @param samples header->num_of_samples samples, 12-bit unless the type is TELEMETRY_TYPE_WIDE16
+ * @param frame Destination, at least TELEMETRY_MAX_FRAME_LENGTH bytes
+ * @return Number of bytes written to frame, delimiter included
+ *
+ * A TELEMETRY_TYPE_DELTA block that would not be smaller than the packed
+ * form (a noisy or fast signal) is sent as TELEMETRY_TYPE_PACKED12 instead.
+ * A TELEMETRY_TYPE_WIDE16 block carries header->bits (clipped to 12..16).
+*/
+extern uint32_t telemetry_encode_frame(const Telemetry_Header_Type* header, const uint16_t* samples, uint8_t* frame);
+
+/**
+ * @brief Parse a frame received between two delimiters
+ * @param frame Encoded bytes, delimiter excluded
+ * @param length Number of encoded bytes
+ * @param header Destination of the packet fields
+ * @param samples Destination of the samples, TELEMETRY_MAX_SAMPLES entries
+ * @return 1 if the frame is well formed, its CRC matches and every sample fits
+ *         header->bits, 0 otherwise
+*/
+extern uint8_t telemetry_decode_frame(const uint8_t* frame, uint32_t length, Telemetry_Header_Type* header, uint16_t* samples);
+
+#endif /* TELEMETRY_H_ */
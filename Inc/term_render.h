@@ -0,0 +1,89 @@
+/**
+ * @file term_render.h
+ * @brief Header file for the retained-mode ANSI terminal renderer
+ *
+ * The application draws into a back screen (characters plus a color per
+ * cell); term_render() compares it with a shadow of what the terminal
+ * already shows and emits only cursor moves, color changes and the
+ * characters that differ. An unchanged screen costs zero bytes.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef TERM_RENDER_H_
+#define TERM_RENDER_H_
+
+#include <stdint.h>
+
+#define TERM_ROWS               10u     /**< Rows managed by the renderer */
+#define TERM_COLS               56u     /**< Columns managed by the renderer */
+
+/** @brief Moves to row TERM_ROWS + 2 and clears it, for text sent outside the renderer */
+#define TERM_STATUS_LINE        "\033[12;1H\033[2K"
+
+/** @brief Output space term_render() needs to repaint one cell, escapes included */
+#define TERM_MIN_OUTPUT_SIZE    24u
+
+/**
+ * @brief Colors a cell can be drawn in (same codes as the K and BH macros of usart.h)
+*/
+typedef enum {
+    TERM_COLOR_NORMAL = 0,
+    TERM_COLOR_CYAN,
+    TERM_COLOR_BOLD_RED,
+    TERM_COLOR_BOLD_GREEN,
+    TERM_COLOR_BOLD_BLUE,
+    TERM_COLOR_BOLD_WHITE,
+    TERM_COLOR_COUNT
+} Term_Color_Type;
+
+/**
+ * @brief Screen contents, one character and one Term_Color_Type per cell
+*/
+typedef struct {
+    char chars[TERM_ROWS][TERM_COLS];
+    uint8_t colors[TERM_ROWS][TERM_COLS];
+} Term_Screen_Type;
+
+/**
+ * @brief Renderer state
+*/
+typedef struct {
+    Term_Screen_Type back;      /**< What the application wants shown */
+    Term_Screen_Type front;     /**< What the terminal shows */
+    uint8_t front_valid;        /**< 0 until the terminal has been cleared once */
+    uint8_t cursor_row;         /**< Terminal cursor position after the last output */
+    uint8_t cursor_col;
+    uint8_t color;              /**< Terminal color after the last output */
+} Term_Render_Type;
+
+/**
+ * @brief Blank both screens; the next render clears the terminal first
+ * @param term Renderer to initialize
+*/
+extern void term_init(Term_Render_Type* term);
+
+/**
+ * @brief Draw text into the back screen, clipped at the right edge
+ * @param term Renderer
+ * @param row Row, 0 at the top
+ * @param col Column, 0 at the left
+ * @param text NUL-terminated text without control characters
+ * @param color Term_Color_Type of the text
+*/
+extern void term_put_text(Term_Render_Type* term, uint8_t row, uint8_t col, const char* text, uint8_t color);
+
+/**
+ * @brief Emit the escape sequences and characters that bring the terminal up to date
+ * @param term Renderer
+ * @param output Destination of the bytes to send
+ * @param size Size of output, at least TERM_MIN_OUTPUT_SIZE
+ * @return Number of bytes written
+ *
+ * When output fills up, the cells not yet sent stay pending and go out on
+ * the next call, so a small transmit buffer only spreads an update out.
+*/
+extern uint32_t term_render(Term_Render_Type* term, char* output, uint32_t size);
+
+#endif /* TERM_RENDER_H_ */
@@ -15,6 +15,7 @@
 #include <stdint.h>
 #include "stm32f446xx.h" // Include STM32F446xx specific definitions
 #include "gpio.h"
+#include "pll.h"
 
 // ANSI escape codes for terminal control and text colors
 #define clearScreen() printf("\033[H\033[J")
@@ -45,12 +46,32 @@
 #define NEWLINE_CHARACTER '\n'
 #define NULL_CHARACTER '\0'
 
+// USART2 DMA transmit pipeline (DMA1 Stream 6 / Channel 4)
+#define USART2_TX_BUFFER_SIZE         512u  // size of each of the two ping-pong buffers
+
+// USART2 interrupt-driven receive path
+#define USART2_RX_BUFFER_SIZE         256u  // ring filled by the RXNE interrupt, must be a power of two
+#define USART2_RX_LINE_SIZE           64u   // longest line USART2_read_line() assembles
+
+// USART2 baud rate generator (PCLK1 = APB1_FREQ)
+#ifndef USART2_DEFAULT_BAUD_RATE
+#define USART2_DEFAULT_BAUD_RATE      115200u               // override with -DUSART2_DEFAULT_BAUD_RATE=...
+#endif
+#define USART2_MAX_BAUD_RATE          (APB1_FREQ / 8u)      // OVER8 with USARTDIV = 1
+#define USART2_MIN_BAUD_RATE          ((APB1_FREQ + 65534u) / 65535u)  // OVER16, rounded up so USARTDIV fits BRR
+
 // USART2 configuration constants
 #define USART2_CR1_M_WORD_LENGTH_8    ((uint8_t) 0)
 #define USART2_CR1_M_WORD_LENGTH_9    ((uint8_t) 1)
 
 // Function prototypes for UART2 operations
 
+
+/**
+ * @brief Function called from a USART2 or DMA1 interrupt to signal an event
+*/
+typedef void (*USART2_Event_Callback)(void);
+
 /**
  * @brief Initialize UART2
 */
@@ -87,6 +108,18 @@ extern void USART2_enable_receiver(void);
 */
 extern void USART2_set_default_baud_rate(void);
 
+/**
+ * @brief Set the USART2 baud rate from the APB1 clock
+ * @param baud_rate Requested rate in bit/s (USART2_MIN_BAUD_RATE to USART2_MAX_BAUD_RATE)
+ * @param error_ppm If not NULL, receives (actual - requested) / requested in parts per million
+ * @return The baud rate actually produced
+ *
+ * Oversampling by 16 is used while the divider allows it, since it tolerates
+ * more clock mismatch; above APB1_FREQ / 16 (2.8125 Mbaud) OVER8 is selected.
+ * Call it while nothing is being transmitted.
+*/
+extern uint32_t USART2_set_baud_rate(uint32_t baud_rate, int32_t* error_ppm);
+
 /**
  * @brief Quick default configuration for USART2
 */
@@ -117,4 +150,112 @@ uint8_t UART2_getchar(void);
 */
 void UART2_getString(char string[], uint32_t input_size);
 
+/**
+ * @brief Set up DMA1 Stream 6 to feed USART2 from the ping-pong transmit buffers
+ *
+ * Must be called after USART2_quick_default_config().
+*/
+extern void USART2_dma_tx_init(void);
+
+/**
+ * @brief Queue bytes for DMA transmission without waiting
+ * @param data Bytes to send
+ * @param length Number of bytes
+ * @return Number of bytes queued; the rest is dropped and counted
+*/
+extern uint32_t USART2_dma_write(const char* data, uint32_t length);
+
+/**
+ * @brief Reserve space in the buffer being filled, to format output in place
+ * @param length Number of bytes the caller intends to write
+ * @return Pointer to write to, or NULL if both buffers are too full
+ *
+ * Every successful reserve must be followed by USART2_tx_commit().
+*/
+extern char* USART2_tx_reserve(uint32_t length);
+
+/**
+ * @brief Hand the bytes written after USART2_tx_reserve() to the DMA
+ * @param length Number of bytes actually written (at most the reserved length)
+*/
+extern void USART2_tx_commit(uint32_t length);
+
+/**
+ * @brief Check whether the DMA is still draining a buffer
+ * @return 1 while a transfer is in flight, 0 when idle
+*/
+extern uint8_t USART2_tx_busy(void);
+
+/**
+ * @brief Number of bytes dropped because both transmit buffers were full
+ * @return Dropped byte counter
+*/
+extern uint32_t USART2_tx_dropped(void);
+
+/**
+ * @brief Call a function each time the DMA has drained a transmit buffer
+ * @param callback Runs in DMA1_Stream6_IRQHandler, NULL to disable
+ *
+ * Output that did not fit in the fill buffer can be retried from here
+ * instead of polling USART2_tx_busy().
+*/
+extern void USART2_set_tx_callback(USART2_Event_Callback callback);
+
+/**
+ * @brief Receive through the RXNE and IDLE interrupts instead of polling
+ *
+ * Every received byte is pushed into a lock-free ring by USART2_IRQHandler;
+ * the application drains it with the non-blocking readers below. Once this
+ * is called UART2_getchar() and UART2_getString() read from the ring too.
+*/
+extern void USART2_rx_interrupt_init(void);
+
+/**
+ * @brief Take one received byte without waiting
+ * @param c Destination of the byte
+ * @return 1 if a byte was taken, 0 if the ring was empty
+*/
+extern uint8_t USART2_rx_pop(uint8_t* c);
+
+/**
+ * @brief Number of received bytes waiting in the ring
+ * @return Bytes that can be popped
+*/
+extern uint32_t USART2_rx_available(void);
+
+/**
+ * @brief Assemble a line from the received bytes without waiting
+ * @param line Destination of the NUL-terminated line, without its terminator
+ * @param size Size of line in bytes
+ * @return Length of the completed line, 0 while no line is complete
+ *
+ * Lines end with '\r' or '\n'; empty lines (such as the '\n' of "\r\n") are
+ * skipped and characters beyond USART2_RX_LINE_SIZE - 1 are dropped.
+*/
+extern uint32_t USART2_read_line(char* line, uint32_t size);
+
+/**
+ * @brief Take the bytes received before the line last went idle
+ * @param frame Destination of the bytes
+ * @param size Size of frame in bytes
+ * @return Number of bytes copied, 0 if no idle line followed the pending bytes
+ *
+ * The IDLE flag rises one character time after the last stop bit, so a burst
+ * sent by the host is delimited as soon as it ends, without any per-byte
+ * timeout. Bursts received back to back without a gap are returned together.
+*/
+extern uint32_t USART2_read_frame(uint8_t* frame, uint32_t size);
+
+/**
+ * @brief Number of bytes lost to a full receive ring or a hardware overrun
+ * @return Dropped byte counter
+*/
+extern uint32_t USART2_rx_dropped(void);
+
+/**
+ * @brief Call a function each time a received byte has been queued
+ * @param callback Runs in USART2_IRQHandler, NULL to disable
+*/
+extern void USART2_set_rx_callback(USART2_Event_Callback callback);
+
 #endif /* USART_H_ */
@@ -0,0 +1,39 @@
+/**
+ * @file cmsis_nvic_virtual.h
+ * @brief NVIC access of the simulator build
+ *
+ * core_cm4.h includes this file instead of mapping NVIC_EnableIRQ() and the
+ * other NVIC_* names onto its register-level __NVIC_* functions, because
+ * sim_device.h defines CMSIS_NVIC_VIRTUAL. The calls the firmware makes are
+ * routed to the interrupt model of sim.c; the rest keep the CMSIS mapping.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef CMSIS_NVIC_VIRTUAL_H_
+#define CMSIS_NVIC_VIRTUAL_H_
+
+extern void sim_nvic_enable_irq(IRQn_Type irq);
+extern void sim_nvic_disable_irq(IRQn_Type irq);
+extern uint32_t sim_nvic_get_enable_irq(IRQn_Type irq);
+extern uint32_t sim_nvic_get_pending_irq(IRQn_Type irq);
+extern void sim_nvic_set_pending_irq(IRQn_Type irq);
+extern void sim_nvic_clear_pending_irq(IRQn_Type irq);
+extern void sim_nvic_set_priority(IRQn_Type irq, uint32_t priority);
+extern uint32_t sim_nvic_get_priority(IRQn_Type irq);
+
+#define NVIC_SetPriorityGrouping    __NVIC_SetPriorityGrouping
+#define NVIC_GetPriorityGrouping    __NVIC_GetPriorityGrouping
+#define NVIC_EnableIRQ              sim_nvic_enable_irq
+#define NVIC_GetEnableIRQ           sim_nvic_get_enable_irq
+#define NVIC_DisableIRQ             sim_nvic_disable_irq
+#define NVIC_GetPendingIRQ          sim_nvic_get_pending_irq
+#define NVIC_SetPendingIRQ          sim_nvic_set_pending_irq
+#define NVIC_ClearPendingIRQ        sim_nvic_clear_pending_irq
+#define NVIC_GetActive              __NVIC_GetActive
+#define NVIC_SetPriority            sim_nvic_set_priority
+#define NVIC_GetPriority            sim_nvic_get_priority
+#define NVIC_SystemReset            __NVIC_SystemReset
+
+#endif /* CMSIS_NVIC_VIRTUAL_H_ */
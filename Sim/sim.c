@@ -0,0 +1,1135 @@
+/**
+ * @file: sim.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the behavioural models of the host simulator.
+ *
+ * Registers are plain memory, so the simulator cannot see a write when it
+ * happens. Every step therefore starts by resolving what the firmware wrote
+ * since the last one: rc_w0 status registers are compared with the value the
+ * simulator last published, write-1-to-clear and self-clearing bits (IFCR,
+ * BSRR, SWSTART, EGR) are applied and zeroed, and a USART2 DR without the
+ * SIM_USART_DR_TAG bit is a byte to transmit. The models then run for the
+ * step, the registers they own are published, and pending interrupts are
+ * delivered.
+*/
+
+#include <string.h>
+#include "sim.h"
+#include "pll.h"
+
+
+#define SIM_HCLK_PER_TIMER_TICK     (HCLK_FREQ / APB1_TIMER_FREQ)
+#define SIM_HCLK_PER_PCLK1          (HCLK_FREQ / APB1_FREQ)
+#define SIM_HCLK_PER_ADCCLK         (HCLK_FREQ / (APB2_FREQ / 4u))  /* ADCPRE = PCLK2/4 as set by ADCx_init() */
+#define SIM_WFI_LIMIT_CYCLES        HCLK_FREQ                       /* a WFI with nothing to wake it returns after 1 s */
+
+#define SIM_NUM_IRQS                128u
+#define SIM_NVIC_WORDS              (SIM_NUM_IRQS / 32u)
+#define SIM_NUM_ADCS                3u
+#define SIM_NUM_GPIO_PORTS          8u
+#define SIM_NUM_ADC_CHANNELS        19u
+#define SIM_UART_QUEUE_SIZE         4096u
+#define SIM_UART_QUEUE_MASK         (SIM_UART_QUEUE_SIZE - 1u)
+
+#define SIM_USART_DR_TAG            0x80000000uL    /* marks the DR value published by the simulator */
+#define SIM_USART_SR_RC_W0          (USART_SR_CTS | USART_SR_LBD | USART_SR_TC | USART_SR_RXNE)
+
+// ADC_CR2 EXTSEL codes from the reference manual (RM0390), not from the drivers under test
+#define SIM_EXTSEL_TIM2_TRGO        6u
+#define SIM_EXTSEL_TIM3_TRGO        8u
+#define SIM_MMS_UPDATE              2u
+#define SIM_SMS_TRIGGER             6u      /* slave trigger mode: TRGI sets CEN */
+#define SIM_TS_ITR1                 1u      /* TIM3 ITR1 is TIM2 TRGO */
+#define SIM_OCM_FORCE_LOW           4u
+#define SIM_OCM_FORCE_HIGH          5u
+#define SIM_OCM_PWM1                6u      /* active while CNT < CCR */
+#define SIM_OCM_PWM2                7u      /* active while CNT >= CCR */
+#define SIM_AF_TIM3                 2u
+#define SIM_MODER_AF                2u
+
+#define SIM_FIELD(value, mask)      (((value) & (mask)) / ((mask) & (~(mask) + 1u)))  /* field shifted down to bit 0 */
+
+#define SIM_DMA_FLAG_TE             0x08u
+#define SIM_DMA_FLAG_HT             0x10u
+#define SIM_DMA_FLAG_TC             0x20u
+
+uint32_t sim_peripherals[SIM_PERIPH_SIZE / sizeof(uint32_t)];
+uint32_t sim_core_peripherals[SIM_CORE_SIZE / sizeof(uint32_t)];
+
+/* Exception handlers the firmware may define, defaulting to nothing like the startup file's */
+static void sim_default_handler(void) {
+}
+
+void SysTick_Handler(void) __attribute__((weak, alias("sim_default_handler")));
+void ADC_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void USART2_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void TIM2_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void TIM3_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void DMA1_Stream6_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void DMA2_Stream0_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void DMA2_Stream1_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+void DMA2_Stream2_IRQHandler(void) __attribute__((weak, alias("sim_default_handler")));
+
+/**
+ * @brief A DMA stream serving a modelled peripheral
+*/
+typedef struct {
+    DMA_TypeDef* dma;
+    DMA_Stream_TypeDef* stream;
+    uint8_t number;             /**< Stream number, selects LISR/HISR and the flag offset */
+    uint8_t channel;            /**< CHSEL of the peripheral's request */
+    IRQn_Type irq;
+} Sim_DMA_Route_Type;
+
+typedef struct {
+    uint8_t active;             /**< EN has been seen set */
+    uint32_t length;            /**< NDTR when the stream was enabled, reloaded in circular mode */
+} Sim_DMA_State_Type;
+
+typedef struct {
+    uint8_t busy;               /**< A conversion is in progress */
+    uint8_t rank;               /**< Rank of the regular sequence being converted */
+    uint32_t remaining;         /**< HCLK cycles until the conversion completes */
+    uint32_t status;            /**< SR as last published */
+} Sim_ADC_State_Type;
+
+typedef struct {
+    uint32_t prescaler;         /**< PSC loaded at the last update event */
+    uint32_t prescaler_count;   /**< Timer clock ticks since the counter last moved */
+    uint32_t status;            /**< SR as last published */
+    IRQn_Type irq;
+    uint8_t trgo_source;        /**< ADC EXTSEL code of this timer's TRGO */
+    uint64_t start_cycle;       /**< Cycle a slave trigger last set CEN, counting starts there */
+    uint8_t oc2_ref;            /**< OC2REF, held by the modes that are not modelled */
+} Sim_Timer_State_Type;
+
+typedef struct {
+    uint8_t port;               /**< 0 = GPIOA */
+    uint8_t pin;
+    uint8_t af;                 /**< AFRy value that routes the timer channel to the pin */
+} Sim_AF_Route_Type;
+
+typedef struct {
+    uint32_t status;            /**< SR as last published */
+    uint8_t rx_data;            /**< Last byte received, readable in DR */
+    uint8_t tx_holding;         /**< DR holds a byte waiting for the shift register */
+    uint8_t tx_data;
+    uint8_t tx_busy;            /**< Shift register is sending tx_shift */
+    uint8_t tx_shift;
+    uint32_t tx_remaining;
+    uint8_t rx_busy;            /**< A frame is arriving on the RX line */
+    uint32_t rx_remaining;
+    uint8_t idle_armed;         /**< A frame was received and IDLE has not been raised yet */
+    uint32_t idle_remaining;
+    uint8_t queue[SIM_UART_QUEUE_SIZE];
+    uint32_t queue_head;
+    uint32_t queue_tail;
+    Sim_UART_Sink sink;
+    void* sink_context;
+} Sim_USART_State_Type;
+
+typedef struct {
+    Sim_Waveform waveform;
+    void* context;
+} Sim_Input_Type;
+
+static const Sim_DMA_Route_Type sim_adc_dma[SIM_NUM_ADCS] = {
+    { DMA2, DMA2_Stream0, 0u, 0u, DMA2_Stream0_IRQn },     /* ADC1 */
+    { DMA2, DMA2_Stream2, 2u, 1u, DMA2_Stream2_IRQn },     /* ADC2 */
+    { DMA2, DMA2_Stream1, 1u, 2u, DMA2_Stream1_IRQn },     /* ADC3 */
+};
+static const Sim_DMA_Route_Type sim_usart2_tx_dma = { DMA1, DMA1_Stream6, 6u, 4u, DMA1_Stream6_IRQn };
+static const Sim_AF_Route_Type sim_tim3_ch2_pins[] = {     /* PA7, PB5, PC7 */
+    { 0u, 7u, SIM_AF_TIM3 }, { 1u, 5u, SIM_AF_TIM3 }, { 2u, 7u, SIM_AF_TIM3 },
+};
+
+static ADC_TypeDef* const sim_adcs[SIM_NUM_ADCS] = { ADC1, ADC2, ADC3 };
+static const uint16_t sim_adc_sample_cycles[8] = { 3u, 15u, 28u, 56u, 84u, 112u, 144u, 480u };
+static const uint8_t sim_dma_flag_offsets[4] = { 0u, 6u, 16u, 22u };
+
+static uint64_t sim_cycle;
+static Sim_Stats_Type sim_statistics;
+
+static uint32_t sim_nvic_enabled[SIM_NVIC_WORDS];
+static uint32_t sim_nvic_pending[SIM_NVIC_WORDS];
+static uint8_t sim_nvic_priorities[SIM_NUM_IRQS];
+static uint32_t sim_primask;
+static uint8_t sim_in_handler;
+static uint8_t sim_systick_pending;
+
+static uint32_t sim_systick_value;
+static uint32_t sim_systick_published;
+
+static Sim_DMA_State_Type sim_adc_dma_state[SIM_NUM_ADCS];
+static Sim_DMA_State_Type sim_usart2_tx_dma_state;
+static Sim_ADC_State_Type sim_adc_state[SIM_NUM_ADCS];
+static Sim_Timer_State_Type sim_tim2_state;
+static Sim_Timer_State_Type sim_tim3_state;
+static Sim_USART_State_Type sim_usart2;
+static Sim_Input_Type sim_inputs[SIM_NUM_ADC_CHANNELS];
+static uint16_t sim_gpio_inputs[SIM_NUM_GPIO_PORTS];
+static Sim_Step_Hook sim_step_hook;
+static void* sim_step_hook_context;
+
+static void adc_trigger(uint8_t source);
+static uint8_t timer_oc2_level(TIM_TypeDef* TIMx, Sim_Timer_State_Type* state);
+
+
+/*
+ * Interrupts
+ */
+
+static void pend_irq(IRQn_Type irq) {
+    sim_nvic_pending[(uint32_t)irq / 32u] |= 1uL << ((uint32_t)irq % 32u);
+}
+
+static void pend_systick(void) {
+    sim_systick_pending = 1u;
+    SCB->ICSR |= SCB_ICSR_PENDSTSET_Msk;
+}
+
+// Lowest enabled and pending interrupt number, or -1
+static int32_t next_irq(void) {
+    for (uint32_t word = 0u; word < SIM_NVIC_WORDS; word++) {
+        uint32_t ready = sim_nvic_enabled[word] & sim_nvic_pending[word];
+        if (ready != 0u) {
+            return (int32_t)((word * 32u) + (uint32_t)__builtin_ctz(ready));
+        }
+    }
+    return -1;
+}
+
+// Calls the handler, then retires the flags its register reads would have cleared
+static void dispatch(IRQn_Type irq) {
+    switch (irq) {
+    case ADC_IRQn:
+        ADC_IRQHandler();
+        for (uint8_t i = 0u; i < SIM_NUM_ADCS; i++) {
+            sim_adcs[i]->SR &= ~ADC_SR_EOC;     /* the handler read DR */
+        }
+        break;
+    case USART2_IRQn:
+        USART2_IRQHandler();
+        USART2->SR &= ~(USART_SR_RXNE | USART_SR_ORE | USART_SR_IDLE);     /* SR then DR */
+        break;
+    case TIM2_IRQn:
+        TIM2_IRQHandler();
+        break;
+    case TIM3_IRQn:
+        TIM3_IRQHandler();
+        break;
+    case DMA1_Stream6_IRQn:
+        DMA1_Stream6_IRQHandler();
+        break;
+    case DMA2_Stream0_IRQn:
+        DMA2_Stream0_IRQHandler();
+        break;
+    case DMA2_Stream1_IRQn:
+        DMA2_Stream1_IRQHandler();
+        break;
+    case DMA2_Stream2_IRQn:
+        DMA2_Stream2_IRQHandler();
+        break;
+    default:
+        break;
+    }
+}
+
+static void resolve(void);
+static void publish(void);
+
+// Runs pending handlers to completion while PRIMASK allows it
+static void deliver(void) {
+    if (sim_in_handler) {
+        return;
+    }
+
+    sim_in_handler = 1u;
+    while (sim_primask == 0u) {
+        if (sim_systick_pending) {
+            sim_systick_pending = 0u;
+            SCB->ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+            SysTick_Handler();
+        } else {
+            int32_t irq = next_irq();
+            if (irq < 0) {
+                break;
+            }
+            sim_nvic_pending[(uint32_t)irq / 32u] &= ~(1uL << ((uint32_t)irq % 32u));
+            dispatch((IRQn_Type)irq);
+        }
+        sim_statistics.interrupts++;
+        resolve();
+        publish();
+    }
+    sim_in_handler = 0u;
+}
+
+uint32_t sim_get_primask(void) {
+    return sim_primask;
+}
+
+void sim_set_primask(uint32_t primask) {
+    sim_primask = primask & 1u;
+    if (sim_primask == 0u) {
+        deliver();
+    }
+}
+
+void sim_nvic_enable_irq(IRQn_Type irq) {
+    if ((int32_t)irq >= 0) {
+        sim_nvic_enabled[(uint32_t)irq / 32u] |= 1uL << ((uint32_t)irq % 32u);
+        deliver();
+    }
+}
+
+void sim_nvic_disable_irq(IRQn_Type irq) {
+    if ((int32_t)irq >= 0) {
+        sim_nvic_enabled[(uint32_t)irq / 32u] &= ~(1uL << ((uint32_t)irq % 32u));
+    }
+}
+
+uint32_t sim_nvic_get_enable_irq(IRQn_Type irq) {
+    if ((int32_t)irq < 0) {
+        return 0u;
+    }
+    return (sim_nvic_enabled[(uint32_t)irq / 32u] >> ((uint32_t)irq % 32u)) & 1u;
+}
+
+uint32_t sim_nvic_get_pending_irq(IRQn_Type irq) {
+    if ((int32_t)irq < 0) {
+        return 0u;
+    }
+    return (sim_nvic_pending[(uint32_t)irq / 32u] >> ((uint32_t)irq % 32u)) & 1u;
+}
+
+void sim_nvic_set_pending_irq(IRQn_Type irq) {
+    if ((int32_t)irq >= 0) {
+        pend_irq(irq);
+        deliver();
+    }
+}
+
+void sim_nvic_clear_pending_irq(IRQn_Type irq) {
+    if ((int32_t)irq >= 0) {
+        sim_nvic_pending[(uint32_t)irq / 32u] &= ~(1uL << ((uint32_t)irq % 32u));
+    }
+}
+
+void sim_nvic_set_priority(IRQn_Type irq, uint32_t priority) {
+    if ((int32_t)irq >= 0) {
+        sim_nvic_priorities[(uint32_t)irq] = (uint8_t)priority;     /* stored, not used for arbitration */
+    }
+}
+
+uint32_t sim_nvic_get_priority(IRQn_Type irq) {
+    return ((int32_t)irq >= 0)? sim_nvic_priorities[(uint32_t)irq]: 0u;
+}
+
+
+/*
+ * DMA
+ */
+
+void* sim_host_address(uint32_t address) {
+    uintptr_t window = (uintptr_t)sim_peripherals & ~(uintptr_t)UINT32_MAX;
+
+    return (void*)(window | (uintptr_t)address);
+}
+
+// The stream is enabled and serves the request of this route
+static uint8_t dma_ready(const Sim_DMA_Route_Type* route, const Sim_DMA_State_Type* state) {
+    uint32_t channel = SIM_FIELD(route->stream->CR, DMA_SxCR_CHSEL);
+
+    return (state->active && (channel == route->channel) && (route->stream->NDTR != 0u))? 1u: 0u;
+}
+
+// Notices EN going up (latching the length) or down
+static void dma_sync(const Sim_DMA_Route_Type* route, Sim_DMA_State_Type* state) {
+    uint8_t enabled = (route->stream->CR & DMA_SxCR_EN)? 1u: 0u;
+
+    if (enabled && !state->active) {
+        state->active = 1u;
+        state->length = route->stream->NDTR;
+    } else if (!enabled) {
+        state->active = 0u;
+    }
+}
+
+// Host address of the memory side of the next data item
+static uint8_t* dma_memory(const Sim_DMA_Route_Type* route, const Sim_DMA_State_Type* state, uint32_t* size) {
+    DMA_Stream_TypeDef* stream = route->stream;
+    uint32_t item = state->length - stream->NDTR;
+
+    *size = 1uL << (SIM_FIELD(stream->CR, DMA_SxCR_MSIZE));
+    if ((stream->CR & DMA_SxCR_MINC) == 0u) {
+        item = 0u;
+    }
+
+    return (uint8_t*)sim_host_address(stream->M0AR) + (item * *size);
+}
+
+// Counts one data item: NDTR, half/full transfer flags, circular reload
+static void dma_advance(const Sim_DMA_Route_Type* route, Sim_DMA_State_Type* state) {
+    DMA_Stream_TypeDef* stream = route->stream;
+    volatile uint32_t* isr = (route->number < 4u)? &route->dma->LISR: &route->dma->HISR;
+    uint32_t remaining = stream->NDTR - 1u;
+    uint32_t flags = 0u;
+
+    if (remaining == (state->length / 2u)) {
+        flags |= SIM_DMA_FLAG_HT;
+    }
+    if (remaining == 0u) {
+        flags |= SIM_DMA_FLAG_TC;
+        if (stream->CR & DMA_SxCR_CIRC) {
+            remaining = state->length;
+        } else {
+            stream->CR &= ~DMA_SxCR_EN;
+            state->active = 0u;
+        }
+    }
+    stream->NDTR = remaining;
+    sim_statistics.dma_transfers++;
+
+    if (flags != 0u) {
+        *isr |= flags << sim_dma_flag_offsets[route->number % 4u];
+        if (((flags & SIM_DMA_FLAG_HT) && (stream->CR & DMA_SxCR_HTIE)) ||
+            ((flags & SIM_DMA_FLAG_TC) && (stream->CR & DMA_SxCR_TCIE))) {
+            pend_irq(route->irq);
+        }
+    }
+}
+
+// Peripheral to memory
+static void dma_write(const Sim_DMA_Route_Type* route, Sim_DMA_State_Type* state, uint32_t value) {
+    uint32_t size;
+    uint8_t* memory = dma_memory(route, state, &size);
+
+    memcpy(memory, &value, size);   /* both sides little-endian */
+    dma_advance(route, state);
+}
+
+// Memory to peripheral
+static uint32_t dma_read(const Sim_DMA_Route_Type* route, Sim_DMA_State_Type* state) {
+    uint32_t size;
+    uint32_t value = 0u;
+    const uint8_t* memory = dma_memory(route, state, &size);
+
+    memcpy(&value, memory, size);
+    dma_advance(route, state);
+    return value;
+}
+
+
+/*
+ * RCC, PWR, GPIO, SysTick
+ */
+
+static void clock_sync(void) {
+    const uint32_t ready[][2] = {
+        { RCC_CR_HSION, RCC_CR_HSIRDY },
+        { RCC_CR_HSEON, RCC_CR_HSERDY },
+        { RCC_CR_PLLON, RCC_CR_PLLRDY },
+        { RCC_CR_PLLI2SON, RCC_CR_PLLI2SRDY },
+        { RCC_CR_PLLSAION, RCC_CR_PLLSAIRDY },
+    };
+    uint32_t cr = RCC->CR;
+
+    for (uint32_t i = 0u; i < (sizeof(ready) / sizeof(ready[0])); i++) {
+        cr = (cr & ready[i][0])? (cr | ready[i][1]): (cr & ~ready[i][1]);
+    }
+    RCC->CR = cr;
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SWS) | ((RCC->CFGR & RCC_CFGR_SW) << 2u);
+
+    uint32_t csr = PWR->CSR & ~(PWR_CSR_ODRDY | PWR_CSR_ODSWRDY);
+    if (PWR->CR & PWR_CR_ODEN) {
+        csr |= PWR_CSR_ODRDY;
+    }
+    if (PWR->CR & PWR_CR_ODSWEN) {
+        csr |= PWR_CSR_ODSWRDY;
+    }
+    PWR->CSR = csr;
+}
+
+static GPIO_TypeDef* gpio_port(uint8_t port) {
+    return (GPIO_TypeDef*)(GPIOA_BASE + ((uintptr_t)port * (GPIOB_BASE - GPIOA_BASE)));
+}
+
+static void gpio_sync(void) {
+    for (uint8_t port = 0u; port < SIM_NUM_GPIO_PORTS; port++) {
+        GPIO_TypeDef* GPIOx = gpio_port(port);
+        uint32_t bsrr = GPIOx->BSRR;
+        uint32_t moder = GPIOx->MODER;
+
+        if (bsrr != 0u) {
+            GPIOx->BSRR = 0u;
+            GPIOx->ODR = ((GPIOx->ODR & ~(bsrr >> 16u)) | bsrr) & 0xFFFFu;     /* set wins over reset */
+        }
+
+        // MODERy = 01 marks an output; gather bit 2y of those fields into bit y
+        uint32_t outputs = moder & ~(moder >> 1u) & 0x55555555uL;
+        outputs = (outputs | (outputs >> 1u)) & 0x33333333uL;
+        outputs = (outputs | (outputs >> 2u)) & 0x0F0F0F0FuL;
+        outputs = (outputs | (outputs >> 4u)) & 0x00FF00FFuL;
+        outputs = (outputs | (outputs >> 8u)) & 0x0000FFFFuL;
+        GPIOx->IDR = (GPIOx->ODR & outputs) | (sim_gpio_inputs[port] & ~outputs);
+    }
+
+    // alternate function pins follow the peripheral driving them, only TIM3 CH2 is modelled
+    uint8_t oc2 = timer_oc2_level(TIM3, &sim_tim3_state);
+    for (uint8_t i = 0u; i < (sizeof(sim_tim3_ch2_pins) / sizeof(sim_tim3_ch2_pins[0])); i++) {
+        const Sim_AF_Route_Type* route = &sim_tim3_ch2_pins[i];
+        GPIO_TypeDef* GPIOx = gpio_port(route->port);
+        uint32_t afr = GPIOx->AFR[route->pin / 8u] >> ((route->pin % 8u) * 4u);
+
+        if ((((GPIOx->MODER >> (route->pin * 2u)) & 3u) == SIM_MODER_AF) && ((afr & 0xFu) == route->af)) {
+            GPIOx->IDR = (GPIOx->IDR & ~(1uL << route->pin)) | ((uint32_t)oc2 << route->pin);
+        }
+    }
+}
+
+static void systick_sync(void) {
+    if (SysTick->VAL != sim_systick_published) {
+        sim_systick_value = 0u;     /* any write clears the counter and COUNTFLAG */
+        SysTick->CTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+    }
+}
+
+static void systick_advance(uint32_t cycles) {
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0u) {
+        return;
+    }
+
+    while (cycles > 0u) {
+        if (sim_systick_value == 0u) {
+            sim_systick_value = SysTick->LOAD & SysTick_LOAD_RELOAD_Msk;   /* reload takes one clock */
+            cycles--;
+            continue;
+        }
+
+        uint32_t count = (cycles < sim_systick_value)? cycles: sim_systick_value;
+        sim_systick_value -= count;
+        cycles -= count;
+
+        if (sim_systick_value == 0u) {
+            SysTick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+            if (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk) {
+                pend_systick();
+            }
+        }
+    }
+}
+
+
+/*
+ * TIM2, TIM3
+ */
+
+// TIM3 in trigger mode on ITR1 starts counting from the cycle TIM2 TRGO rises
+static void timer_trgo(TIM_TypeDef* TIMx) {
+    if ((TIMx != TIM2) || (SIM_FIELD(TIM3->SMCR, TIM_SMCR_TS) != SIM_TS_ITR1) ||
+            (SIM_FIELD(TIM3->SMCR, TIM_SMCR_SMS) != SIM_SMS_TRIGGER) || (TIM3->CR1 & TIM_CR1_CEN)) {
+        return;
+    }
+    TIM3->CR1 |= TIM_CR1_CEN;
+    sim_tim3_state.start_cycle = sim_cycle;
+}
+
+static void timer_update(TIM_TypeDef* TIMx, Sim_Timer_State_Type* state) {
+    state->prescaler = TIMx->PSC & 0xFFFFu;
+    TIMx->SR |= TIM_SR_UIF;
+    if (TIMx->DIER & TIM_DIER_UIE) {
+        pend_irq(state->irq);
+    }
+    if (SIM_FIELD(TIMx->CR2, TIM_CR2_MMS) == SIM_MMS_UPDATE) {
+        adc_trigger(state->trgo_source);
+        timer_trgo(TIMx);
+    }
+}
+
+// Level of the CH2 output, upcounting only
+static uint8_t timer_oc2_level(TIM_TypeDef* TIMx, Sim_Timer_State_Type* state) {
+    switch (SIM_FIELD(TIMx->CCMR1, TIM_CCMR1_OC2M)) {
+    case SIM_OCM_FORCE_LOW:
+        state->oc2_ref = 0u;
+        break;
+    case SIM_OCM_FORCE_HIGH:
+        state->oc2_ref = 1u;
+        break;
+    case SIM_OCM_PWM1:
+        state->oc2_ref = (TIMx->CNT < TIMx->CCR2)? 1u: 0u;
+        break;
+    case SIM_OCM_PWM2:
+        state->oc2_ref = (TIMx->CNT >= TIMx->CCR2)? 1u: 0u;
+        break;
+    default:
+        break;      /* frozen and the match modes keep OC2REF */
+    }
+
+    if ((TIMx->CCER & TIM_CCER_CC2E) == 0u) {
+        return 0u;
+    }
+    return (TIMx->CCER & TIM_CCER_CC2P)? (state->oc2_ref ^ 1u): state->oc2_ref;
+}
+
+static void timer_sync(TIM_TypeDef* TIMx, Sim_Timer_State_Type* state) {
+    if (TIMx->SR != state->status) {
+        TIMx->SR &= state->status;      /* rc_w0 */
+    }
+    if (TIMx->EGR & TIM_EGR_UG) {
+        TIMx->EGR = 0u;
+        TIMx->CNT = 0u;
+        state->prescaler_count = 0u;
+        timer_update(TIMx, state);
+    }
+}
+
+static void timer_advance(TIM_TypeDef* TIMx, Sim_Timer_State_Type* state, uint64_t start, uint64_t end) {
+    uint32_t arr = TIMx->ARR;
+
+    if (((TIMx->CR1 & TIM_CR1_CEN) == 0u) || (arr == 0u)) {
+        return;
+    }
+
+    if (state->start_cycle > start) {
+        start = state->start_cycle;     /* triggered during this step by a timer advanced before it */
+    }
+    uint64_t ticks = state->prescaler_count + ((end / SIM_HCLK_PER_TIMER_TICK) - (start / SIM_HCLK_PER_TIMER_TICK));
+    uint64_t counts = ticks / (state->prescaler + 1u);
+    state->prescaler_count = (uint32_t)(ticks % (state->prescaler + 1u));
+
+    while (counts > 0u) {
+        uint64_t to_update = (uint64_t)arr - TIMx->CNT + 1u;
+        if (counts < to_update) {
+            TIMx->CNT += (uint32_t)counts;
+            break;
+        }
+        counts -= to_update;
+        TIMx->CNT = 0u;
+        timer_update(TIMx, state);
+        if (TIMx->CR1 & TIM_CR1_OPM) {
+            TIMx->CR1 &= ~TIM_CR1_CEN;
+            break;
+        }
+    }
+}
+
+
+// HCLK cycles until the counter reaches value, value > CNT
+static uint64_t timer_cycles_to(const TIM_TypeDef* TIMx, const Sim_Timer_State_Type* state, uint64_t value) {
+    uint64_t ticks = ((value - 1u - TIMx->CNT) * (state->prescaler + 1u)) +
+            ((state->prescaler + 1u) - state->prescaler_count);
+
+    return (ticks * SIM_HCLK_PER_TIMER_TICK) - (sim_cycle % SIM_HCLK_PER_TIMER_TICK);
+}
+
+// HCLK cycles until the next update event or CH2 edge, 0 if the counter is stopped
+static uint64_t timer_next_event(TIM_TypeDef* TIMx, const Sim_Timer_State_Type* state) {
+    uint32_t arr = TIMx->ARR;
+
+    if (((TIMx->CR1 & TIM_CR1_CEN) == 0u) || (arr == 0u) || (TIMx->CNT > arr)) {
+        return 0u;
+    }
+
+    uint64_t next = timer_cycles_to(TIMx, state, (uint64_t)arr + 1u);
+    if ((TIMx->CCER & TIM_CCER_CC2E) && (TIMx->CCR2 > TIMx->CNT) && (TIMx->CCR2 <= arr)) {
+        uint64_t compare = timer_cycles_to(TIMx, state, TIMx->CCR2);
+        next = (compare < next)? compare: next;     /* PWM modes change level at CNT = CCR2 */
+    }
+    return next;
+}
+
+
+/*
+ * ADC1..3
+ */
+
+static uint8_t adc_channel(ADC_TypeDef* ADCx, uint8_t rank) {
+    uint32_t sqr = (rank < 6u)? ADCx->SQR3: (rank < 12u)? ADCx->SQR2: ADCx->SQR1;
+
+    return (uint8_t)((sqr >> ((rank % 6u) * 5u)) & ADC_SQR3_SQ1);
+}
+
+static uint32_t adc_conversion_cycles(ADC_TypeDef* ADCx, uint8_t channel) {
+    uint32_t smp = (channel < 10u)?
+            ((ADCx->SMPR2 >> (channel * 3u)) & 7u):
+            ((ADCx->SMPR1 >> ((channel - 10u) * 3u)) & 7u);
+    uint32_t resolution = 12u - (2u * SIM_FIELD(ADCx->CR1, ADC_CR1_RES));
+
+    return (sim_adc_sample_cycles[smp] + resolution) * SIM_HCLK_PER_ADCCLK;
+}
+
+static void adc_begin(uint8_t index, uint8_t rank) {
+    ADC_TypeDef* ADCx = sim_adcs[index];
+    Sim_ADC_State_Type* state = &sim_adc_state[index];
+
+    state->busy = 1u;
+    state->rank = rank;
+    state->remaining = adc_conversion_cycles(ADCx, adc_channel(ADCx, rank));
+    ADCx->SR |= ADC_SR_STRT;
+}
+
+static void adc_trigger(uint8_t source) {
+    for (uint8_t i = 0u; i < SIM_NUM_ADCS; i++) {
+        ADC_TypeDef* ADCx = sim_adcs[i];
+        uint32_t extsel = SIM_FIELD(ADCx->CR2, ADC_CR2_EXTSEL);
+
+        if ((ADCx->CR2 & ADC_CR2_ADON) && (ADCx->CR2 & ADC_CR2_EXTEN) &&
+            (extsel == source) && !sim_adc_state[i].busy) {
+            adc_begin(i, 0u);
+        }
+    }
+}
+
+static void adc_complete(uint8_t index, uint64_t cycle) {
+    ADC_TypeDef* ADCx = sim_adcs[index];
+    Sim_ADC_State_Type* state = &sim_adc_state[index];
+    uint8_t channel = adc_channel(ADCx, state->rank);
+    uint32_t value = 0u;
+
+    if ((channel < SIM_NUM_ADC_CHANNELS) && (sim_inputs[channel].waveform != NULL)) {
+        value = sim_inputs[channel].waveform(channel, cycle, sim_inputs[channel].context) & 0xFFFu;
+    }
+    value >>= 2u * SIM_FIELD(ADCx->CR1, ADC_CR1_RES);
+    if (ADCx->CR2 & ADC_CR2_ALIGN) {
+        value <<= 4u;
+    }
+
+    ADCx->DR = value;
+    ADCx->SR |= ADC_SR_EOC;
+    sim_statistics.adc_conversions++;
+
+    if (ADCx->CR2 & ADC_CR2_DMA) {
+        if (dma_ready(&sim_adc_dma[index], &sim_adc_dma_state[index])) {
+            dma_write(&sim_adc_dma[index], &sim_adc_dma_state[index], value);
+            ADCx->SR &= ~ADC_SR_EOC;    /* the DMA read DR */
+        } else {
+            ADCx->SR |= ADC_SR_OVR;     /* nobody took the previous request */
+            if (ADCx->CR1 & ADC_CR1_OVRIE) {
+                pend_irq(ADC_IRQn);
+            }
+        }
+    }
+    if ((ADCx->SR & ADC_SR_EOC) && (ADCx->CR1 & ADC_CR1_EOCIE)) {
+        pend_irq(ADC_IRQn);
+    }
+
+    uint8_t length = (uint8_t)(SIM_FIELD(ADCx->SQR1, ADC_SQR1_L) + 1u);
+    if ((ADCx->CR1 & ADC_CR1_SCAN) && ((state->rank + 1u) < length)) {
+        adc_begin(index, state->rank + 1u);
+    } else if (ADCx->CR2 & ADC_CR2_CONT) {
+        adc_begin(index, 0u);
+    } else {
+        state->busy = 0u;
+    }
+}
+
+static void adc_sync(uint8_t index) {
+    ADC_TypeDef* ADCx = sim_adcs[index];
+    Sim_ADC_State_Type* state = &sim_adc_state[index];
+
+    if (ADCx->SR != state->status) {
+        ADCx->SR &= state->status;      /* rc_w0 */
+    }
+    if ((ADCx->CR2 & ADC_CR2_ADON) == 0u) {
+        state->busy = 0u;
+    }
+    if (ADCx->CR2 & ADC_CR2_SWSTART) {
+        ADCx->CR2 &= ~ADC_CR2_SWSTART;  /* cleared by hardware as the conversion starts */
+        if ((ADCx->CR2 & ADC_CR2_ADON) && !state->busy) {
+            adc_begin(index, 0u);
+        }
+    }
+}
+
+static void adc_advance(uint8_t index, uint64_t start, uint32_t cycles) {
+    Sim_ADC_State_Type* state = &sim_adc_state[index];
+    uint32_t budget = cycles;
+
+    while (state->busy && (budget >= state->remaining)) {
+        budget -= state->remaining;
+        adc_complete(index, start + (cycles - budget));
+    }
+    if (state->busy) {
+        state->remaining -= budget;
+    }
+}
+
+
+/*
+ * USART2
+ */
+
+static uint32_t usart_frame_cycles(void) {
+    uint32_t brr = USART2->BRR & 0xFFFFu;
+    uint32_t bit = (USART2->CR1 & USART_CR1_OVER8)? (((brr >> 4u) << 3u) | (brr & 7u)): brr;
+    uint32_t bits = (USART2->CR1 & USART_CR1_M)? 11u: 10u;
+
+    if (bit == 0u) {
+        bit = 16u;
+    }
+    return bit * bits * SIM_HCLK_PER_PCLK1;
+}
+
+// Moves DR to the shift register, and DMA data into DR, as far as both allow
+static void usart_feed(void) {
+    Sim_USART_State_Type* state = &sim_usart2;
+
+    for (;;) {
+        if (!state->tx_holding && (USART2->CR3 & USART_CR3_DMAT) &&
+            dma_ready(&sim_usart2_tx_dma, &sim_usart2_tx_dma_state)) {
+            state->tx_data = (uint8_t)dma_read(&sim_usart2_tx_dma, &sim_usart2_tx_dma_state);
+            state->tx_holding = 1u;
+        }
+        if (state->tx_busy || !state->tx_holding) {
+            break;
+        }
+        state->tx_shift = state->tx_data;
+        state->tx_holding = 0u;
+        state->tx_busy = 1u;
+        state->tx_remaining = usart_frame_cycles();
+        USART2->SR &= ~USART_SR_TC;
+    }
+
+    if (state->tx_holding) {
+        USART2->SR &= ~USART_SR_TXE;
+    } else {
+        USART2->SR |= USART_SR_TXE;
+    }
+}
+
+static void usart_sync(void) {
+    Sim_USART_State_Type* state = &sim_usart2;
+    uint32_t sr = USART2->SR;
+    uint32_t dr = USART2->DR;
+
+    if (sr != state->status) {
+        USART2->SR = (state->status & ~SIM_USART_SR_RC_W0) | (state->status & sr & SIM_USART_SR_RC_W0);
+    }
+
+    if ((dr & SIM_USART_DR_TAG) == 0u) {
+        uint32_t enabled = USART_CR1_UE | USART_CR1_TE;
+        if ((USART2->CR1 & enabled) == enabled) {
+            state->tx_data = (uint8_t)dr;   /* the SR read, DR write sequence clears TC */
+            state->tx_holding = 1u;
+            USART2->SR &= ~USART_SR_TC;
+        }
+        USART2->DR = state->rx_data | SIM_USART_DR_TAG;
+    }
+
+    dma_sync(&sim_usart2_tx_dma, &sim_usart2_tx_dma_state);
+    usart_feed();
+}
+
+static void usart_receive(uint8_t byte) {
+    Sim_USART_State_Type* state = &sim_usart2;
+
+    if (USART2->SR & USART_SR_RXNE) {
+        USART2->SR |= USART_SR_ORE;     /* DR still unread: the new byte is lost */
+    } else {
+        state->rx_data = byte;
+        USART2->DR = byte | SIM_USART_DR_TAG;
+        USART2->SR |= USART_SR_RXNE;
+        sim_statistics.uart_rx_bytes++;
+    }
+    if (USART2->CR1 & USART_CR1_RXNEIE) {
+        pend_irq(USART2_IRQn);
+    }
+}
+
+static void usart_advance(uint32_t cycles) {
+    Sim_USART_State_Type* state = &sim_usart2;
+    uint32_t budget = cycles;
+
+    // polled reception: a byte raised in an earlier step has been read by now
+    if ((USART2->CR1 & USART_CR1_RXNEIE) == 0u) {
+        USART2->SR &= ~(USART_SR_RXNE | USART_SR_ORE);
+    }
+
+    while (state->tx_busy && (budget >= state->tx_remaining)) {
+        budget -= state->tx_remaining;
+        state->tx_busy = 0u;
+        sim_statistics.uart_tx_bytes++;
+        if (state->sink != NULL) {
+            state->sink(state->tx_shift, state->sink_context);
+        }
+        usart_feed();
+        if (!state->tx_busy) {
+            USART2->SR |= USART_SR_TC;
+            if (USART2->CR1 & USART_CR1_TCIE) {
+                pend_irq(USART2_IRQn);
+            }
+        }
+    }
+    if (state->tx_busy) {
+        state->tx_remaining -= budget;
+    }
+
+    uint32_t enabled = USART_CR1_UE | USART_CR1_RE;
+    budget = cycles;
+    while ((USART2->CR1 & enabled) == enabled) {
+        if (!state->rx_busy) {
+            if (state->queue_head == state->queue_tail) {
+                break;
+            }
+            state->rx_busy = 1u;
+            state->rx_remaining = usart_frame_cycles();
+        }
+        if (budget < state->rx_remaining) {
+            state->rx_remaining -= budget;
+            budget = 0u;
+            break;
+        }
+        budget -= state->rx_remaining;
+        state->rx_busy = 0u;
+        usart_receive(state->queue[state->queue_tail & SIM_UART_QUEUE_MASK]);
+        state->queue_tail++;
+        state->idle_armed = 1u;
+        state->idle_remaining = usart_frame_cycles();
+    }
+
+    if (state->idle_armed && !state->rx_busy) {
+        if (budget < state->idle_remaining) {
+            state->idle_remaining -= budget;
+        } else {
+            state->idle_armed = 0u;
+            USART2->SR |= USART_SR_IDLE;
+            if (USART2->CR1 & USART_CR1_IDLEIE) {
+                pend_irq(USART2_IRQn);
+            }
+        }
+    }
+}
+
+
+/*
+ * Stepping
+ */
+
+// Applies what the firmware wrote since the simulator last ran
+static void resolve(void) {
+    clock_sync();
+    gpio_sync();
+    systick_sync();
+    timer_sync(TIM2, &sim_tim2_state);
+    timer_sync(TIM3, &sim_tim3_state);
+
+    DMA1->LISR &= ~DMA1->LIFCR;
+    DMA1->HISR &= ~DMA1->HIFCR;
+    DMA2->LISR &= ~DMA2->LIFCR;
+    DMA2->HISR &= ~DMA2->HIFCR;
+    DMA1->LIFCR = 0u;
+    DMA1->HIFCR = 0u;
+    DMA2->LIFCR = 0u;
+    DMA2->HIFCR = 0u;
+
+    for (uint8_t i = 0u; i < SIM_NUM_ADCS; i++) {
+        dma_sync(&sim_adc_dma[i], &sim_adc_dma_state[i]);
+        adc_sync(i);
+    }
+    usart_sync();
+}
+
+// Records the registers the simulator owns, to tell its own values from later writes
+static void publish(void) {
+    SysTick->VAL = sim_systick_value;
+    sim_systick_published = sim_systick_value;
+    sim_tim2_state.status = TIM2->SR;
+    sim_tim3_state.status = TIM3->SR;
+    for (uint8_t i = 0u; i < SIM_NUM_ADCS; i++) {
+        sim_adc_state[i].status = sim_adcs[i]->SR;
+    }
+    sim_usart2.status = USART2->SR;
+    gpio_sync();
+}
+
+// Smallest non-zero candidate
+static uint64_t earliest(uint64_t next, uint64_t candidate) {
+    return ((candidate != 0u) && (candidate < next))? candidate: next;
+}
+
+/*
+ * HCLK cycles until the next modelled state change (a counter wrapping, a
+ * conversion or a frame completing), at most limit. Stepping exactly that far
+ * lands on the event, so interrupts are taken at the cycle they are raised.
+ */
+static uint64_t next_event(uint64_t limit) {
+    const Sim_USART_State_Type* usart = &sim_usart2;
+    uint64_t next = limit;
+
+    if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) {
+        next = earliest(next, (sim_systick_value == 0u)? 1u: sim_systick_value);
+    }
+    next = earliest(next, timer_next_event(TIM2, &sim_tim2_state));
+    next = earliest(next, timer_next_event(TIM3, &sim_tim3_state));
+    for (uint8_t i = 0u; i < SIM_NUM_ADCS; i++) {
+        if (sim_adc_state[i].busy) {
+            next = earliest(next, sim_adc_state[i].remaining);
+        }
+    }
+    if (usart->tx_busy) {
+        next = earliest(next, usart->tx_remaining);
+    }
+    if (usart->rx_busy) {
+        next = earliest(next, usart->rx_remaining);
+    } else if (usart->queue_head != usart->queue_tail) {
+        next = earliest(next, 1u);
+    } else if (usart->idle_armed) {
+        next = earliest(next, usart->idle_remaining);
+    }
+
+    return next;
+}
+
+static void step(uint32_t cycles) {
+    uint64_t start = sim_cycle;
+
+    resolve();
+    sim_cycle += cycles;
+
+    systick_advance(cycles);
+    timer_advance(TIM2, &sim_tim2_state, start, sim_cycle);
+    timer_advance(TIM3, &sim_tim3_state, start, sim_cycle);
+    for (uint8_t i = 0u; i < SIM_NUM_ADCS; i++) {
+        adc_advance(i, start, cycles);
+    }
+    usart_advance(cycles);
+    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) {
+        DWT->CYCCNT += cycles;
+    }
+
+    publish();
+    deliver();
+
+    if (sim_step_hook != NULL) {
+        sim_step_hook(sim_step_hook_context);
+    }
+}
+
+void sim_reset(void) {
+    memset(sim_peripherals, 0, sizeof(sim_peripherals));
+    memset(sim_core_peripherals, 0, sizeof(sim_core_peripherals));
+    memset(sim_nvic_enabled, 0, sizeof(sim_nvic_enabled));
+    memset(sim_nvic_pending, 0, sizeof(sim_nvic_pending));
+    memset(sim_nvic_priorities, 0, sizeof(sim_nvic_priorities));
+    memset(sim_adc_dma_state, 0, sizeof(sim_adc_dma_state));
+    memset(&sim_usart2_tx_dma_state, 0, sizeof(sim_usart2_tx_dma_state));
+    memset(sim_adc_state, 0, sizeof(sim_adc_state));
+    memset(&sim_tim2_state, 0, sizeof(sim_tim2_state));
+    memset(&sim_tim3_state, 0, sizeof(sim_tim3_state));
+    memset(&sim_usart2, 0, sizeof(sim_usart2));
+    memset(sim_inputs, 0, sizeof(sim_inputs));
+    memset(sim_gpio_inputs, 0, sizeof(sim_gpio_inputs));
+    memset(&sim_statistics, 0, sizeof(sim_statistics));
+    sim_step_hook = NULL;
+    sim_step_hook_context = NULL;
+
+    sim_cycle = 0u;
+    sim_primask = 0u;
+    sim_in_handler = 0u;
+    sim_systick_pending = 0u;
+    sim_systick_value = 0u;
+
+    sim_tim2_state.irq = TIM2_IRQn;
+    sim_tim2_state.trgo_source = SIM_EXTSEL_TIM2_TRGO;
+    sim_tim3_state.irq = TIM3_IRQn;
+    sim_tim3_state.trgo_source = SIM_EXTSEL_TIM3_TRGO;
+
+    // reset values the drivers depend on
+    RCC->CR = 0x00000083uL;         /* HSI on and ready */
+    RCC->PLLCFGR = 0x24003010uL;
+    GPIOA->MODER = 0xA8000000uL;    /* SWD pins */
+    GPIOB->MODER = 0x00000280uL;
+    USART2->SR = USART_SR_TXE | USART_SR_TC;
+    USART2->DR = SIM_USART_DR_TAG;
+
+    publish();
+}
+
+void sim_sync(void) {
+    resolve();
+    publish();
+    deliver();
+}
+
+void sim_poll(void) {
+    step(SIM_STEP_CYCLES);
+}
+
+/*
+ * No firmware code runs between two events except in the handlers they
+ * trigger, so time jumps from one event to the next.
+ */
+void sim_advance(uint64_t cycles) {
+    while (cycles > 0u) {
+        uint64_t count = next_event((cycles < UINT32_MAX)? cycles: UINT32_MAX);
+        step((uint32_t)count);
+        cycles -= count;
+    }
+}
+
+/*
+ * WFI sleeps until an enabled interrupt is pending, even with PRIMASK set.
+ * With PRIMASK clear the interrupt is taken inside the step, so the wake-up
+ * is recognised by the interrupt count moving instead.
+ */
+void sim_wfi(void) {
+    uint64_t deadline = sim_cycle + SIM_WFI_LIMIT_CYCLES;
+    uint32_t taken = sim_statistics.interrupts;
+
+    sim_sync();
+    while ((sim_statistics.interrupts == taken) && !sim_systick_pending &&
+           (next_irq() < 0) && (sim_cycle < deadline)) {
+        step((uint32_t)next_event(deadline - sim_cycle));
+    }
+}
+
+uint64_t sim_cycles(void) {
+    return sim_cycle;
+}
+
+const Sim_Stats_Type* sim_stats(void) {
+    return &sim_statistics;
+}
+
+void sim_set_step_hook(Sim_Step_Hook hook, void* context) {
+    sim_step_hook = hook;
+    sim_step_hook_context = context;
+}
+
+void sim_adc_set_input(uint8_t channel, Sim_Waveform waveform, void* context) {
+    if (channel < SIM_NUM_ADC_CHANNELS) {
+        sim_inputs[channel].waveform = waveform;
+        sim_inputs[channel].context = context;
+    }
+}
+
+void sim_uart_set_sink(Sim_UART_Sink sink, void* context) {
+    sim_usart2.sink = sink;
+    sim_usart2.sink_context = context;
+}
+
+uint32_t sim_uart_inject(const uint8_t* data, uint32_t length) {
+    Sim_USART_State_Type* state = &sim_usart2;
+    uint32_t queued = 0u;
+
+    while ((queued < length) && ((state->queue_head - state->queue_tail) < SIM_UART_QUEUE_SIZE)) {
+        state->queue[state->queue_head & SIM_UART_QUEUE_MASK] = data[queued];
+        state->queue_head++;
+        queued++;
+    }
+    return queued;
+}
+
+void sim_gpio_set_input(uint8_t port, uint8_t pin, uint8_t level) {
+    if ((port < SIM_NUM_GPIO_PORTS) && (pin < 16u)) {
+        if (level) {
+            sim_gpio_inputs[port] |= (uint16_t)(1u << pin);
+        } else {
+            sim_gpio_inputs[port] &= (uint16_t)~(1u << pin);
+        }
+        gpio_sync();
+    }
+}
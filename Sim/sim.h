@@ -0,0 +1,178 @@
+/**
+ * @file sim.h
+ * @brief Header file for the host-side peripheral simulator
+ *
+ * This file contains declarations for running the drivers of Src/ on a PC.
+ * sim_device.h places every register block in host memory; this module
+ * gives the blocks the firmware relies on a behavioural model, advanced in
+ * virtual HCLK cycles (180 MHz):
+ *
+ *   - RCC/PWR: ready flags follow their enable bits, SWS follows SW.
+ *   - SysTick: VAL counts down at HCLK, the wrap calls SysTick_Handler().
+ *   - TIM2/TIM3: up-counters at APB1_TIMER_FREQ with PSC/ARR, EGR.UG and
+ *     OPM; the update event is routed to TRGO when MMS = 010. TIM3 in
+ *     trigger mode (SMS = 110) on ITR1 is started by TIM2 TRGO, and its CH2
+ *     output (forced and PWM modes, CC2E, CC2P) drives PA7/PB5/PC7 in AF2.
+ *   - ADC1..3: SWSTART or a matching TIM2/TIM3 TRGO converts the regular
+ *     sequence (SQRx, SCAN, CONT) in (SMP + resolution) ADCCLK cycles; DR
+ *     takes the value of the channel's waveform, then EOC, DMA request and
+ *     EOCIE interrupt follow.
+ *   - DMA2 streams 0/2/1 (ADC1/2/3) and DMA1 stream 6 (USART2 TX): NDTR,
+ *     MINC, CIRC, half and full transfer flags and interrupts.
+ *   - USART2: one byte per frame time from BRR/OVER8/M, TXE/TC for polled
+ *     writes of DR and for DMAT; injected bytes arrive through RXNE, ORE and
+ *     IDLE with their interrupts.
+ *   - GPIOA..H: BSRR is applied to ODR, IDR mirrors ODR on output pins and
+ *     sim_gpio_set_input() levels on the others.
+ *   - DWT: CYCCNT counts HCLK cycles once enabled.
+ *   - NVIC/PRIMASK: pending interrupts are delivered to the firmware's
+ *     handlers when enabled and unmasked, one at a time, lowest number first.
+ *
+ * Not modelled: interrupt priorities and nesting, ADC injected channels,
+ * multi-ADC (interleaved) mode, the other timer slave modes, channels and
+ * alternate functions, USART parity/errors, and anything outside the blocks
+ * listed above, whose registers simply hold what was written.
+ *
+ * Hardware events that clear a flag on a read (EOC by reading DR, RXNE and
+ * IDLE by reading SR then DR) are approximated: the flags are treated as
+ * consumed after the corresponding interrupt handler has run, or, for
+ * polled USART reception, at the next simulator step.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+
+#define SIM_STEP_CYCLES     32u     /**< HCLK cycles advanced per sim_poll() (~178 ns) */
+
+/**
+ * @brief Analog input of an ADC channel
+ * @param channel ADC channel being converted (0 to 18)
+ * @param cycle HCLK cycle at which the conversion completes
+ * @param context Pointer given to sim_adc_set_input()
+ * @return Input level as a 12-bit code (0 to 4095)
+*/
+typedef uint16_t (*Sim_Waveform)(uint8_t channel, uint64_t cycle, void* context);
+
+/**
+ * @brief Receiver of the bytes USART2 puts on its TX line
+ * @param byte Byte transmitted
+ * @param context Pointer given to sim_uart_set_sink()
+*/
+typedef void (*Sim_UART_Sink)(uint8_t byte, void* context);
+
+/**
+ * @brief Function run after every simulator step
+ * @param context Pointer given to sim_set_step_hook()
+ *
+ * It may end the simulation with longjmp(), whatever the firmware was doing.
+*/
+typedef void (*Sim_Step_Hook)(void* context);
+
+/**
+ * @brief Counts of simulated hardware activity since sim_reset()
+*/
+typedef struct {
+    uint32_t adc_conversions;   /**< Conversions completed by ADC1..3 */
+    uint32_t dma_transfers;     /**< Data items moved by the modelled DMA streams */
+    uint32_t uart_tx_bytes;     /**< Bytes shifted out of USART2 */
+    uint32_t uart_rx_bytes;     /**< Injected bytes that reached USART2 DR */
+    uint32_t interrupts;        /**< Exception handlers called, SysTick included */
+} Sim_Stats_Type;
+
+/**
+ * @brief Put every simulated register block in its reset state
+ *
+ * Also clears virtual time, the NVIC, PRIMASK, the statistics, the waveforms,
+ * the UART sink and any bytes still waiting to be received.
+*/
+extern void sim_reset(void);
+
+/**
+ * @brief Apply pending register writes and deliver pending interrupts, without advancing time
+*/
+extern void sim_sync(void);
+
+/**
+ * @brief Advance virtual time by one step of SIM_STEP_CYCLES
+*/
+extern void sim_poll(void);
+
+/**
+ * @brief Advance virtual time
+ * @param cycles Number of HCLK cycles to run
+ *
+ * Runs from one hardware event to the next (counter wrap, end of a
+ * conversion or of a frame) instead of in fixed steps, and __WFI does the
+ * same, so idle stretches cost almost nothing. Busy-wait loops still advance
+ * by SIM_STEP_CYCLES per poll.
+*/
+extern void sim_advance(uint64_t cycles);
+
+/**
+ * @brief Virtual time
+ * @return HCLK cycles elapsed since sim_reset()
+*/
+extern uint64_t sim_cycles(void);
+
+/**
+ * @brief Set the function run after every step
+ * @param hook Function to call, or NULL
+ * @param context Pointer passed back to hook
+*/
+extern void sim_set_step_hook(Sim_Step_Hook hook, void* context);
+
+/**
+ * @brief Activity counters
+ * @return Pointer to the counters, updated as the simulation runs
+*/
+extern const Sim_Stats_Type* sim_stats(void);
+
+/**
+ * @brief Set the signal seen by an ADC channel
+ * @param channel ADC channel (0 to 18)
+ * @param waveform Function giving the input level, or NULL for a constant 0
+ * @param context Pointer passed back to waveform
+*/
+extern void sim_adc_set_input(uint8_t channel, Sim_Waveform waveform, void* context);
+
+/**
+ * @brief Set the receiver of the bytes transmitted by USART2
+ * @param sink Function called once per byte, or NULL to discard them
+ * @param context Pointer passed back to sink
+*/
+extern void sim_uart_set_sink(Sim_UART_Sink sink, void* context);
+
+/**
+ * @brief Queue bytes on the RX line of USART2
+ * @param data Bytes to receive, one per frame time, back to back
+ * @param length Number of bytes
+ * @return Number of bytes queued (less than length if the queue is full)
+*/
+extern uint32_t sim_uart_inject(const uint8_t* data, uint32_t length);
+
+/**
+ * @brief Drive the level of a pin that is not configured as an output
+ * @param port Port index (0 = GPIOA to 7 = GPIOH)
+ * @param pin Pin number within the port (0 to 15)
+ * @param level 0 for low, anything else for high
+*/
+extern void sim_gpio_set_input(uint8_t port, uint8_t pin, uint8_t level);
+
+/**
+ * @brief Translate a 32-bit DMA address register back into a host pointer
+ * @param address Value the firmware wrote into PAR/M0AR
+ * @return Host pointer to the same object
+ *
+ * The firmware stores buffer addresses as uint32_t. This is lossless for
+ * static objects of a program linked with -no-pie; otherwise the upper half
+ * is taken from the simulator's own data, which is correct for statics as
+ * long as the data segment does not cross a 4 GiB boundary.
+*/
+extern void* sim_host_address(uint32_t address);
+
+#endif /* SIM_H_ */
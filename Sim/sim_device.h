@@ -0,0 +1,124 @@
+/**
+ * @file sim_device.h
+ * @brief Host build of the device header: registers backed by simulated peripherals
+ *
+ * This file is force-included into every translation unit of a simulator
+ * build (gcc -include Sim/sim_device.h -ISim ...). It stands in for the
+ * parts of the Cortex-M4 support that cannot run on a PC and then moves the
+ * peripheral address space into host memory:
+ *
+ *   - cmsis_gcc.h is skipped; the compiler macros it defines are given host
+ *     equivalents and the intrinsics used by the firmware (__disable_irq,
+ *     __enable_irq, __get_PRIMASK, __set_PRIMASK, __WFI, __CLZ) call into the
+ *     interrupt model of sim.c.
+ *   - NVIC_EnableIRQ() and friends are routed to the simulated NVIC through
+ *     the CMSIS_NVIC_VIRTUAL hook of core_cm4.h (see cmsis_nvic_virtual.h).
+ *   - PERIPH_BASE and the core peripheral bases are redefined to arrays in
+ *     sim.c, so ADC1, GPIOA..H, USART2, RCC, DMA2_Stream0, SysTick, SCB, DWT
+ *     and every other register block keep their offsets from stm32f446xx.h
+ *     but live in ordinary RAM.
+ *
+ * The drivers are compiled unchanged: target code paths are used, HOST_BUILD
+ * must not be defined. Register writes take effect at the next simulator
+ * step (sim_poll(), sim_sync(), __WFI, an interrupt delivery), which is why
+ * every busy-wait loop of the drivers goes through HW_POLL() (hw_poll.h).
+ *
+ * DMA address registers are 32 bits wide, so buffers handed to a DMA stream
+ * must be static and the program linked with -no-pie (see sim_host_address()).
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef SIM_DEVICE_H_
+#define SIM_DEVICE_H_
+
+#ifndef SIM_BUILD
+#define SIM_BUILD 1
+#endif
+
+#ifdef HOST_BUILD
+#error "SIM_BUILD runs the target code paths, do not combine it with HOST_BUILD"
+#endif
+
+#include <stdint.h>
+
+/*
+ * Host replacement of cmsis_gcc.h
+ */
+#define __CMSIS_GCC_H
+
+#define __ASM                       __asm
+#define __INLINE                    inline
+#define __STATIC_INLINE             static inline
+#define __STATIC_FORCEINLINE        __attribute__((always_inline)) static inline
+#define __NO_RETURN                 __attribute__((__noreturn__))
+#define __USED                      __attribute__((used))
+#define __WEAK                      __attribute__((weak))
+#define __PACKED                    __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT             struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION              union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                __attribute__((aligned(x)))
+#define __RESTRICT                  __restrict
+#define __COMPILER_BARRIER()        __asm volatile ("" ::: "memory")
+
+#define __NOP()                     ((void)0)
+#define __DSB()                     __COMPILER_BARRIER()
+#define __ISB()                     __COMPILER_BARRIER()
+#define __DMB()                     __COMPILER_BARRIER()
+#define __WFI()                     sim_wfi()
+#define __WFE()                     sim_wfi()
+#define __SEV()                     ((void)0)
+
+extern void sim_wfi(void);
+extern uint32_t sim_get_primask(void);
+extern void sim_set_primask(uint32_t primask);
+
+static inline void __disable_irq(void) {
+    sim_set_primask(1u);
+}
+
+static inline void __enable_irq(void) {
+    sim_set_primask(0u);
+}
+
+static inline uint32_t __get_PRIMASK(void) {
+    return sim_get_primask();
+}
+
+static inline void __set_PRIMASK(uint32_t primask) {
+    sim_set_primask(primask);
+}
+
+static inline uint8_t __CLZ(uint32_t value) {
+    return (value == 0u)? 32u: (uint8_t)__builtin_clz(value);
+}
+
+/* NVIC_* calls resolve through Sim/cmsis_nvic_virtual.h */
+#define CMSIS_NVIC_VIRTUAL
+
+#include "stm32f446xx.h"
+
+/*
+ * Register blocks in host memory
+ */
+#define SIM_PERIPH_SIZE     0x00040000uL    /**< APB1, APB2 and AHB1 up to DMA2 and beyond (0x4000_0000..0x4003_FFFF) */
+#define SIM_CORE_SIZE       0x00010000uL    /**< ITM, DWT and the System Control Space (0xE000_0000..0xE000_FFFF) */
+
+extern uint32_t sim_peripherals[SIM_PERIPH_SIZE / sizeof(uint32_t)];
+extern uint32_t sim_core_peripherals[SIM_CORE_SIZE / sizeof(uint32_t)];
+
+#undef PERIPH_BASE
+#define PERIPH_BASE         ((uintptr_t)sim_peripherals)
+
+#undef SCS_BASE
+#undef ITM_BASE
+#undef DWT_BASE
+#undef CoreDebug_BASE
+#define SIM_CORE_BASE       ((uintptr_t)sim_core_peripherals)
+#define SCS_BASE            (SIM_CORE_BASE + 0xE000uL)
+#define ITM_BASE            (SIM_CORE_BASE + 0x0000uL)
+#define DWT_BASE            (SIM_CORE_BASE + 0x1000uL)
+#define CoreDebug_BASE      (SIM_CORE_BASE + 0xEDF0uL)
+
+#endif /* SIM_DEVICE_H_ */
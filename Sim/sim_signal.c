@@ -0,0 +1,278 @@
+/**
+ * @file: sim_signal.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the synthetic analog sources of the simulator.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include "sim_signal.h"
+#include "pll.h"
+
+
+#define SIM_SIGNAL_MAX_CODE     4095.0
+#define SIM_SIGNAL_PI           3.14159265358979323846
+#define SIM_SIGNAL_LINE_SIZE    256u
+
+
+typedef struct {
+    const char* name;
+    uint8_t kind;
+    uint8_t min_params;
+    uint8_t max_params;
+} Sim_Signal_Kind_Type;
+
+static const Sim_Signal_Kind_Type sim_signal_kinds[] = {
+    { "const", SIM_SIGNAL_CONSTANT, 1u, 1u },
+    { "sine",  SIM_SIGNAL_SINE,     3u, 3u },
+    { "ramp",  SIM_SIGNAL_RAMP,     3u, 3u },
+    { "noise", SIM_SIGNAL_NOISE,    2u, 3u },
+    { "step",  SIM_SIGNAL_STEP,     3u, 3u },
+};
+
+
+// splitmix64: a well mixed 64-bit value for every input, no state to keep
+static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15uLL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9uLL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBuLL;
+    return x ^ (x >> 31);
+}
+
+static uint16_t clamp(double level) {
+    if (!(level > 0.0)) {
+        return 0u;      /* NaN included */
+    }
+    if (level >= SIM_SIGNAL_MAX_CODE) {
+        return (uint16_t)SIM_SIGNAL_MAX_CODE;
+    }
+    return (uint16_t)lround(level);
+}
+
+// Appends one level, growing the arrays as needed
+static uint8_t csv_append(Sim_Signal_Type* signal, uint32_t* capacity, double time, double level) {
+    if (signal->count == *capacity) {
+        uint32_t size = (*capacity == 0u)? 1024u: (*capacity * 2u);
+        double* times = realloc(signal->times, size * sizeof(double));
+        if (times == NULL) {
+            return 0u;
+        }
+        signal->times = times;
+        double* levels = realloc(signal->levels, size * sizeof(double));
+        if (levels == NULL) {
+            return 0u;
+        }
+        signal->levels = levels;
+        *capacity = size;
+    }
+    signal->times[signal->count] = time;
+    signal->levels[signal->count] = level;
+    signal->count++;
+    return 1u;
+}
+
+static uint8_t csv_load(Sim_Signal_Type* signal, const char* path, double rate_hz) {
+    char line[SIM_SIGNAL_LINE_SIZE];
+    uint32_t capacity = 0u;
+    FILE* file = fopen(path, "r");
+
+    if (file == NULL) {
+        perror(path);
+        return 0u;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char* cursor = line;
+        char* end;
+
+        while (isspace((unsigned char)*cursor)) {
+            cursor++;
+        }
+        double first = strtod(cursor, &end);
+        if ((*cursor == '#') || (end == cursor)) {
+            continue;   /* blank, comment or header */
+        }
+
+        while (isspace((unsigned char)*end)) {
+            end++;
+        }
+        double time = signal->count / rate_hz;
+        double level = first;
+        if ((*end == ',') || (*end == ';')) {
+            char* value = end + 1;
+            level = strtod(value, &end);
+            if (end == value) {
+                continue;
+            }
+            time = first;
+            if ((signal->count != 0u) && (time < signal->times[signal->count - 1u])) {
+                fprintf(stderr, "%s: time %g goes backwards\n", path, time);
+                fclose(file);
+                return 0u;
+            }
+        }
+        if (!csv_append(signal, &capacity, time, level)) {
+            fclose(file);
+            return 0u;
+        }
+    }
+    fclose(file);
+
+    if (signal->count == 0u) {
+        fprintf(stderr, "%s: no levels\n", path);
+        return 0u;
+    }
+    return 1u;
+}
+
+// Level in force at time t, for conversions that mostly come in time order
+static double csv_level(Sim_Signal_Type* signal, double t) {
+    uint32_t index = signal->cursor;
+
+    if (t < signal->times[index]) {
+        uint32_t low = 0u;          /* went back in time: binary search */
+        uint32_t high = index;
+        while (low < high) {
+            uint32_t middle = low + ((high - low + 1u) / 2u);
+            if (signal->times[middle] <= t) {
+                low = middle;
+            } else {
+                high = middle - 1u;
+            }
+        }
+        index = low;
+    } else {
+        while (((index + 1u) < signal->count) && (signal->times[index + 1u] <= t)) {
+            index++;
+        }
+    }
+
+    signal->cursor = index;
+    return signal->levels[index];
+}
+
+
+uint8_t sim_signal_parse(Sim_Signal_Type* signal, const char* spec) {
+    const char* colon = strchr(spec, ':');
+
+    memset(signal, 0, sizeof(*signal));
+    if (colon == NULL) {
+        return 0u;
+    }
+
+    size_t name_length = (size_t)(colon - spec);
+    const char* params = colon + 1;
+
+    if ((name_length == 3u) && (strncmp(spec, "csv", 3u) == 0)) {
+        char path[SIM_SIGNAL_LINE_SIZE];
+        const char* comma = strrchr(params, ',');
+        double rate_hz = SIM_SIGNAL_CSV_RATE_HZ;
+        size_t path_length = strlen(params);
+
+        if (comma != NULL) {
+            char* end;
+            double rate = strtod(comma + 1, &end);
+            if ((end != (comma + 1)) && (*end == '\0')) {
+                if (!(rate > 0.0)) {
+                    return 0u;
+                }
+                rate_hz = rate;
+                path_length = (size_t)(comma - params);
+            }
+        }
+        if ((path_length == 0u) || (path_length >= sizeof(path))) {
+            return 0u;
+        }
+        memcpy(path, params, path_length);
+        path[path_length] = '\0';
+
+        signal->kind = SIM_SIGNAL_CSV;
+        if (!csv_load(signal, path, rate_hz)) {
+            sim_signal_free(signal);
+            return 0u;
+        }
+        return 1u;
+    }
+
+    for (uint32_t k = 0; k < (sizeof(sim_signal_kinds) / sizeof(sim_signal_kinds[0])); k++) {
+        const Sim_Signal_Kind_Type* kind = &sim_signal_kinds[k];
+        if ((strlen(kind->name) != name_length) || (strncmp(spec, kind->name, name_length) != 0)) {
+            continue;
+        }
+
+        uint8_t count = 0u;
+        const char* cursor = params;
+        for (;;) {
+            char* end;
+            double value = strtod(cursor, &end);
+            if ((end == cursor) || (count == kind->max_params)) {
+                return 0u;
+            }
+            signal->level[count++] = value;
+            if (*end == '\0') {
+                break;
+            }
+            if (*end != ',') {
+                return 0u;
+            }
+            cursor = end + 1;
+        }
+        if (count < kind->min_params) {
+            return 0u;
+        }
+
+        signal->kind = kind->kind;
+        if (kind->kind == SIM_SIGNAL_NOISE) {
+            signal->seed = (count > 2u)? (uint64_t)signal->level[2]: 1u;
+        }
+        return 1u;
+    }
+
+    return 0u;
+}
+
+void sim_signal_free(Sim_Signal_Type* signal) {
+    free(signal->times);
+    free(signal->levels);
+    signal->times = NULL;
+    signal->levels = NULL;
+    signal->count = 0u;
+    signal->cursor = 0u;
+}
+
+uint16_t sim_signal_sample(uint8_t channel, uint64_t cycle, void* context) {
+    Sim_Signal_Type* signal = context;
+    double t = (double)cycle / HCLK_FREQ;
+    double phase;
+
+    (void)channel;
+
+    switch (signal->kind) {
+    case SIM_SIGNAL_SINE:
+        phase = fmod(t * signal->level[2], 1.0);
+        return clamp(signal->level[0] + (signal->level[1] * sin(2.0 * SIM_SIGNAL_PI * phase)));
+
+    case SIM_SIGNAL_RAMP:
+        phase = fmod(t * signal->level[2], 1.0);
+        return clamp(signal->level[0] + ((signal->level[1] - signal->level[0]) * phase));
+
+    case SIM_SIGNAL_NOISE: {
+        double unit = (double)(mix(signal->seed ^ mix(cycle)) >> 11) / 9007199254740992.0;    /* [0, 1) */
+        return clamp(signal->level[0] + (signal->level[1] * ((2.0 * unit) - 1.0)));
+    }
+
+    case SIM_SIGNAL_STEP:
+        return clamp((t < signal->level[2])? signal->level[0]: signal->level[1]);
+
+    case SIM_SIGNAL_CSV:
+        return clamp(csv_level(signal, t));
+
+    default:
+        return clamp(signal->level[0]);
+    }
+}
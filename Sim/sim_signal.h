@@ -0,0 +1,81 @@
+/**
+ * @file sim_signal.h
+ * @brief Header file for the synthetic analog sources of the simulator
+ *
+ * A source is described by a short text specification, so a harness can take
+ * it from the command line:
+ *
+ *   const:level                        constant 12-bit code
+ *   sine:offset,amplitude,freq_hz      offset + amplitude * sin(2 pi f t)
+ *   ramp:low,high,freq_hz              sawtooth from low to high, freq_hz times a second
+ *   noise:mean,amplitude[,seed]        uniform in mean +- amplitude
+ *   step:before,after,time_s           before until time_s, after from then on
+ *   csv:path[,rate_hz]                 replay of a recording (see below)
+ *
+ * Levels are ADC codes, clamped to 0..4095. Every source is a pure function
+ * of the HCLK cycle of the conversion, noise included (a hash of the seed
+ * and the cycle), so a run gives the same samples every time.
+ *
+ * A CSV file holds either one level per line, played at rate_hz (1000 if
+ * omitted), or "time_s,level" lines with increasing times; either way the
+ * level holds until the next one and the last one holds forever. Blank lines,
+ * lines starting with '#' and lines that do not start with a number (a
+ * header) are skipped.
+ *
+ * @date Oct 17, 2026
+ * @author Anurag
+*/
+
+#ifndef SIM_SIGNAL_H_
+#define SIM_SIGNAL_H_
+
+#include <stdint.h>
+
+#define SIM_SIGNAL_CONSTANT     0u
+#define SIM_SIGNAL_SINE         1u
+#define SIM_SIGNAL_RAMP         2u
+#define SIM_SIGNAL_NOISE        3u
+#define SIM_SIGNAL_STEP         4u
+#define SIM_SIGNAL_CSV          5u
+
+#define SIM_SIGNAL_CSV_RATE_HZ  1000.0  /**< Rate of a CSV file of bare levels if none is given */
+
+/**
+ * @brief A parsed source
+*/
+typedef struct {
+    uint8_t kind;           /**< SIM_SIGNAL_* */
+    double level[3];        /**< Parameters in the order of the specification */
+    uint64_t seed;          /**< Noise seed */
+    double* times;          /**< CSV: time of each level in seconds */
+    double* levels;         /**< CSV: the levels */
+    uint32_t count;         /**< CSV: number of levels */
+    uint32_t cursor;        /**< CSV: index of the last level returned */
+} Sim_Signal_Type;
+
+/**
+ * @brief Parse a source specification
+ * @param signal Destination
+ * @param spec Text such as "sine:2048,1000,50"
+ * @return 1 on success, 0 if the text is invalid or the CSV file cannot be read
+*/
+extern uint8_t sim_signal_parse(Sim_Signal_Type* signal, const char* spec);
+
+/**
+ * @brief Release the memory held by a CSV source
+ * @param signal Source filled by sim_signal_parse()
+*/
+extern void sim_signal_free(Sim_Signal_Type* signal);
+
+/**
+ * @brief Level of a source, in the form of a Sim_Waveform
+ * @param channel ADC channel being converted (unused)
+ * @param cycle HCLK cycle of the conversion
+ * @param context The Sim_Signal_Type
+ * @return 12-bit code
+ *
+ * Pass it to sim_adc_set_input() with the signal as context.
+*/
+extern uint16_t sim_signal_sample(uint8_t channel, uint64_t cycle, void* context);
+
+#endif /* SIM_SIGNAL_H_ */
@@ -10,6 +10,8 @@
 
 
 #include "adc.h"
+#include "profile.h"
+#include "hw_poll.h"
 
 
 #define ASSERT assert
@@ -18,6 +20,9 @@ volatile uint32_t ADC1_digital_value = 0;
 volatile uint32_t ADC2_digital_value = 0;
 volatile uint32_t ADC3_digital_value = 0;
 
+Sample_Ring_Type adc_sample_ring;
+volatile uint32_t adc_overrun_count = 0;
+
 
 /**
  * @brief Initializes the specified ADC peripheral
@@ -33,6 +38,9 @@ void ADCx_init(ADC_TypeDef* ADCx) {
         RCC_APB2ENR_ADC3EN
 	};
 	RCC->APB2ENR |= ADC_RCC_Enables[index];
+
+	// ADCCLK = PCLK2/4 keeps the converters within their 36 MHz limit
+	ADC->CCR = (ADC->CCR & ~ADC_CCR_ADCPRE) | ADC_CCR_ADCPRE_0;
 }
 
 /**
@@ -53,7 +61,7 @@ uint8_t check_end_of_conversion_status(ADC_TypeDef* ADCx) {
 void clear_end_of_conversion_staus(ADC_TypeDef* ADCx) {
 	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
 
-	ADCx->SR |= ~ADC_SR_EOC;
+	ADCx->SR = ~ADC_SR_EOC;	/* rc_w0: writing 0 clears EOC, the 1s leave the other flags alone */
 }
 
 /**
@@ -64,7 +72,7 @@ void enable_interrupt_on_end_of_conversion(ADC_TypeDef* ADCx) {
 	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
 
 	__disable_irq();
-	ADCx->CR1 |= ADC_CR1_EOCIE;
+	ADCx->CR1 |= ADC_CR1_EOCIE | ADC_CR1_OVRIE;
 	NVIC_EnableIRQ(ADC_IRQn);
 	__enable_irq();
 }
@@ -126,10 +134,13 @@ void start_conversion(ADC_TypeDef* ADCx) {
 */
 uint32_t get_data(ADC_TypeDef* ADCx) {
 	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
-	while(check_end_of_conversion_status(ADCx) == 0);
+	PROFILE_BEGIN(PROFILE_GET_DATA);
+	while(HW_POLL(check_end_of_conversion_status(ADCx) == 0));
 	clear_end_of_conversion_staus(ADCx);
 
-	return (ADCx->DR & (0xFFF));
+	uint32_t data = ADCx->DR & (0xFFF);
+	PROFILE_END(PROFILE_GET_DATA);
+	return data;
 }
 
 /**
@@ -137,59 +148,133 @@ uint32_t get_data(ADC_TypeDef* ADCx) {
  * @param ADCx Pointer to the ADC peripheral
  * @param num_of_channels Number of channels in the sequence
  * @param channels Array containing the channel numbers
+ *
+ * Ranks 1-6 are held in SQR3, ranks 7-12 in SQR2 and ranks 13-16 in SQR1,
+ * 5 bits each. The sequence length L-1 lives in SQR1[23:20]. Scan mode is
+ * enabled whenever more than one channel is sequenced.
 */
 void set_regular_sequence(ADC_TypeDef* ADCx, uint8_t num_of_channels, uint8_t channels[]) {
-	ASSERT((num_of_channels > 0) && (num_of_channels < TOTAL_NUM_OF_CHANNELS));
+	ASSERT((num_of_channels > 0) && (num_of_channels <= TOTAL_NUM_OF_CHANNELS));
 	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
 
-	ADCx->SQR1 = 0;
-	ADCx->SQR2 = 0;
-	ADCx->SQR3 = 0;
-
-	uint8_t channel = 0;
-	uint8_t sequence1 = 0,
-			sequence2 = 0,
-			sequence3 = 0;
+	uint32_t sequence[3] = {0u, 0u, 0u};	/* SQR3, SQR2, SQR1 */
 
 	for (uint8_t i = 0; i < num_of_channels; i++) {
-		channel = channels[i];
-		if ((i >= 0) && (i < 6)) {
-			ADCx->SQR3 = (channel << sequence1);
-			sequence1 += 5;
-		} else if ((i >= 6) && (i < 12)) {
-			ADCx->SQR2 = (channel << sequence2);
-			sequence2 += 5;
-		} else if ((i >= 12) & (i < 16)) {
-			ADCx->SQR3 = (channel << sequence2);
-			sequence3 += 5;
-		}
+		ASSERT(channels[i] <= MAX_CHANNEL_NUMBER);
+		sequence[i / ADC_RANKS_PER_SQR] |= ((uint32_t)channels[i] << ((i % ADC_RANKS_PER_SQR) * ADC_SQR_BITS_PER_RANK));
 	}
+	sequence[2] |= ((uint32_t)(num_of_channels - 1) << ADC_SQR1_L_POS);
+
+	ADCx->SQR3 = sequence[0];
+	ADCx->SQR2 = sequence[1];
+	ADCx->SQR1 = sequence[2];
 
-	ADCx->SQR3 |= (num_of_channels - 1);
+	if (num_of_channels > 1) {
+		enable_scan_mode(ADCx);
+	} else {
+		disable_scan_mode(ADCx);
+	}
 }
 
 /**
- * ISR for ADC. NOT TESTED YET!
- * TODO:
- * - Test the ISR
- * - Make it more efficient
+ * @brief Gets the number of channels in the regular sequence
+ * @param ADCx Pointer to the ADC peripheral
+ * @return Sequence length (1 to 16)
 */
-void ADC_IRQHandler(void) {
-	if (check_end_of_conversion_status(ADC1)) {
-		clear_end_of_conversion_staus(ADC1);
-		ADC1_digital_value = ADC1->DR & (0xFFF);
-		return;
+uint8_t get_regular_sequence_length(ADC_TypeDef* ADCx) {
+	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
+
+	return (uint8_t)(((ADCx->SQR1 & ADC_SQR1_L) >> ADC_SQR1_L_POS) + 1u);
+}
+
+/**
+ * @brief Sets the sampling time of a channel
+ * @param ADCx Pointer to the ADC peripheral
+ * @param channel Channel number (0 to 18)
+ * @param sample_time One of the ADC_Sample_Time_Type values
+ *
+ * Channels 0-9 are configured in SMPR2 and channels 10-18 in SMPR1, 3 bits each.
+*/
+void set_channel_sample_time(ADC_TypeDef* ADCx, uint8_t channel, uint8_t sample_time) {
+	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
+	ASSERT(channel <= MAX_CHANNEL_NUMBER);
+	ASSERT(sample_time <= ADC_SAMPLE_TIME_480_CYCLES);
+
+	if (channel < 10) {
+		uint32_t shift = channel * 3u;
+		ADCx->SMPR2 = (ADCx->SMPR2 & ~(7u << shift)) | ((uint32_t)sample_time << shift);
+	} else {
+		uint32_t shift = (channel - 10u) * 3u;
+		ADCx->SMPR1 = (ADCx->SMPR1 & ~(7u << shift)) | ((uint32_t)sample_time << shift);
 	}
+}
 
-	if (check_end_of_conversion_status(ADC2)) {
-		clear_end_of_conversion_staus(ADC2);
-		ADC2_digital_value = ADC2->DR & (0xFFF);
-		return;
+/**
+ * @brief Configures a scan of several channels with individual sampling times
+ * @param ADCx Pointer to the ADC peripheral
+ * @param num_of_channels Number of channels in the scan (1 to 16)
+ * @param channels Array containing the channel numbers, in rank order
+ * @param sample_times Array containing the sampling time of each rank
+*/
+void set_scan_sequence(ADC_TypeDef* ADCx, uint8_t num_of_channels, uint8_t channels[], uint8_t sample_times[]) {
+	for (uint8_t i = 0; i < num_of_channels; i++) {
+		set_channel_sample_time(ADCx, channels[i], sample_times[i]);
 	}
+	set_regular_sequence(ADCx, num_of_channels, channels);
+}
 
-	if (check_end_of_conversion_status(ADC3)) {
-		clear_end_of_conversion_staus(ADC3);
-		ADC3_digital_value = ADC3->DR & (0xFFF);
-		return;
+/**
+ * @brief Enables scan mode so the whole regular sequence is converted per trigger
+ * @param ADCx Pointer to the ADC peripheral
+*/
+void enable_scan_mode(ADC_TypeDef* ADCx) {
+	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
+
+	ADCx->CR1 |= ADC_CR1_SCAN;
+}
+
+/**
+ * @brief Disables scan mode, only the first rank is converted
+ * @param ADCx Pointer to the ADC peripheral
+*/
+void disable_scan_mode(ADC_TypeDef* ADCx) {
+	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
+
+	ADCx->CR1 &= ~ADC_CR1_SCAN;
+}
+
+/**
+ * @brief ISR for ADC1, ADC2 and ADC3 end of conversion
+ *
+ * Every finished conversion is pushed, with its getMillis() timestamp, into
+ * adc_sample_ring for the main loop to drain. Reading DR clears EOC. A full
+ * ring is counted by the ring itself; conversions lost inside the ADC
+ * because DR was not read in time (OVR) are counted in adc_overrun_count.
+*/
+void ADC_IRQHandler(void) {
+	ADC_TypeDef* const converters[NUM_ADC_PORTS] = { ADC1, ADC2, ADC3 };
+	volatile uint32_t* const latest[NUM_ADC_PORTS] = {
+		&ADC1_digital_value, &ADC2_digital_value, &ADC3_digital_value,
+	};
+	ADC_Sample_Type sample;
+
+	sample.timestamp = getMillis();
+	sample.reserved = 0;
+
+	for (uint8_t i = 0; i < NUM_ADC_PORTS; i++) {
+		ADC_TypeDef* ADCx = converters[i];
+		uint32_t status = ADCx->SR;
+
+		if (status & ADC_SR_OVR) {
+			ADCx->SR = ~ADC_SR_OVR;
+			adc_overrun_count++;
+		}
+
+		if (status & ADC_SR_EOC) {
+			sample.value = (uint16_t)(ADCx->DR & (0xFFF));
+			sample.adc = i;
+			*latest[i] = sample.value;
+			sample_ring_push(&adc_sample_ring, &sample);
+		}
 	}
 }
@@ -0,0 +1,312 @@
+/**
+ * @file: adc_stream.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements continuous ADC acquisition through DMA2 in circular
+ * mode. The converter runs back-to-back and the DMA moves every result into
+ * memory, so the core is only involved twice per buffer (half and full
+ * transfer interrupts).
+*/
+
+
+#include "adc_stream.h"
+#include "hw_poll.h"
+
+
+#define ASSERT assert
+
+// Flag offsets of a stream inside DMA_LISR/DMA_LIFCR (streams 0..3)
+#define DMA_FLAG_OFFSET_STREAM0	0u
+#define DMA_FLAG_OFFSET_STREAM1	6u
+#define DMA_FLAG_OFFSET_STREAM2	16u
+
+// Flag bits relative to the stream offset
+#define DMA_FLAG_FE		(1u << 0)
+#define DMA_FLAG_DME	(1u << 2)
+#define DMA_FLAG_TE		(1u << 3)
+#define DMA_FLAG_HT		(1u << 4)
+#define DMA_FLAG_TC		(1u << 5)
+#define DMA_FLAGS_ALL	(DMA_FLAG_FE | DMA_FLAG_DME | DMA_FLAG_TE | DMA_FLAG_HT | DMA_FLAG_TC)
+
+/**
+ * @brief Static description of the DMA2 stream serving an ADC
+*/
+typedef struct {
+	uint32_t channel_select;	/**< CHSEL bits of DMA_SxCR */
+	uint8_t flag_offset;		/**< Offset of the stream flags in LISR/LIFCR */
+	IRQn_Type irq;				/**< Stream interrupt */
+} ADC_Stream_DMA_Type;
+
+/**
+ * @brief Runtime state of a running stream
+*/
+typedef struct {
+	volatile uint16_t* buffer;
+	uint32_t length;
+	ADC_Stream_Callback callback;
+	ADC_Scan_Callback scan_callback;
+	uint8_t frame_size;		/**< Samples per scan of the regular sequence */
+	uint8_t samples_per_transfer;	/**< 1 for a single ADC, 2 for packed multi-mode words */
+} ADC_Stream_State_Type;
+
+static const ADC_Stream_DMA_Type adc_stream_dma[NUM_ADC_PORTS] = {
+	{ 0u,               DMA_FLAG_OFFSET_STREAM0, DMA2_Stream0_IRQn },	/* ADC1: channel 0 */
+	{ DMA_SxCR_CHSEL_0, DMA_FLAG_OFFSET_STREAM2, DMA2_Stream2_IRQn },	/* ADC2: channel 1 */
+	{ DMA_SxCR_CHSEL_1, DMA_FLAG_OFFSET_STREAM1, DMA2_Stream1_IRQn },	/* ADC3: channel 2 */
+};
+
+static ADC_Stream_State_Type adc_stream_state[NUM_ADC_PORTS];
+
+
+// Helper function to get the index of an ADC port
+static uint8_t get_adc_index(ADC_TypeDef* ADCx) {
+	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
+
+	return (ADCx == ADC1)? ADC_PORT_1: (ADCx == ADC2)? ADC_PORT_2: ADC_PORT_3;
+}
+
+// Helper function to get the DMA2 stream serving an ADC port
+static DMA_Stream_TypeDef* get_dma_stream(uint8_t index) {
+	DMA_Stream_TypeDef* const streams[NUM_ADC_PORTS] = {
+		DMA2_Stream0, DMA2_Stream2, DMA2_Stream1,
+	};
+
+	return streams[index];
+}
+
+// Common body of the DMA2 stream interrupts
+static void adc_stream_irq(uint8_t index) {
+	const ADC_Stream_DMA_Type* dma = &adc_stream_dma[index];
+	ADC_Stream_State_Type* state = &adc_stream_state[index];
+	uint32_t flags = (DMA2->LISR >> dma->flag_offset) & DMA_FLAGS_ALL;
+
+	DMA2->LIFCR = flags << dma->flag_offset;	/* write 1 to clear the flags that were seen */
+
+	uint32_t half = state->length / 2u;
+	if (state->scan_callback != NULL) {
+		uint32_t num_of_frames = half / state->frame_size;
+		if (flags & DMA_FLAG_HT) {
+			state->scan_callback(&state->buffer[0], num_of_frames, state->frame_size);
+		}
+		if (flags & DMA_FLAG_TC) {
+			state->scan_callback(&state->buffer[half], num_of_frames, state->frame_size);
+		}
+	} else if (state->callback != NULL) {
+		if (flags & DMA_FLAG_HT) {
+			state->callback(&state->buffer[0], half);
+		}
+		if (flags & DMA_FLAG_TC) {
+			state->callback(&state->buffer[half], half);
+		}
+	}
+}
+
+// Programs the DMA stream of an ADC port, the callbacks must already be set
+static void dma_start(uint8_t index, volatile void* peripheral, volatile uint16_t* buffer, uint32_t length, uint8_t samples_per_transfer) {
+	const ADC_Stream_DMA_Type* dma = &adc_stream_dma[index];
+	DMA_Stream_TypeDef* stream = get_dma_stream(index);
+	uint32_t data_size = (samples_per_transfer == 1u)?
+			(DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0):	/* 16-bit half-words */
+			(DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1);	/* 32-bit words holding two samples */
+
+	adc_stream_state[index].buffer = buffer;
+	adc_stream_state[index].length = length;
+	adc_stream_state[index].samples_per_transfer = samples_per_transfer;
+
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+
+	// the stream can only be reprogrammed once it reports itself disabled
+	stream->CR &= ~DMA_SxCR_EN;
+	while (HW_POLL(stream->CR & DMA_SxCR_EN));
+	DMA2->LIFCR = DMA_FLAGS_ALL << dma->flag_offset;
+
+	stream->PAR = (uint32_t)peripheral;
+	stream->M0AR = (uint32_t)buffer;
+	stream->NDTR = length / samples_per_transfer;
+	stream->FCR = 0;	/* direct mode, every request moves one data item */
+	stream->CR = dma->channel_select |
+			DMA_SxCR_PL_1 |		/* high priority */
+			data_size |
+			DMA_SxCR_MINC |
+			DMA_SxCR_CIRC |
+			DMA_SxCR_HTIE |
+			DMA_SxCR_TCIE |
+			DMA_SxCR_TEIE;		/* DIR = 00: peripheral to memory */
+
+	NVIC_EnableIRQ(dma->irq);
+	stream->CR |= DMA_SxCR_EN;
+}
+
+// Lets an ADC issue DMA requests and starts it unless a trigger paces it
+static void adc_start(ADC_TypeDef* ADCx) {
+	// keep issuing DMA requests after the first pass through the sequence
+	ADCx->CR2 |= ADC_CR2_DMA | ADC_CR2_DDS;
+	enable_adc_converter(ADCx);
+
+	// free-run unless a hardware trigger paces the conversions
+	if ((ADCx->CR2 & ADC_CR2_EXTEN) == 0u) {
+		ADCx->CR2 |= ADC_CR2_CONT;
+		start_conversion(ADCx);
+	}
+}
+
+/**
+ * @brief Starts streaming conversions of the specified ADC into a circular buffer
+ * @param ADCx Pointer to the ADC peripheral
+ * @param buffer Buffer receiving the samples
+ * @param length Number of samples in the buffer
+ * @param callback Function called when a half of the buffer is ready
+*/
+void adc_stream_start(ADC_TypeDef* ADCx, volatile uint16_t* buffer, uint32_t length, ADC_Stream_Callback callback) {
+	ASSERT(buffer != NULL);
+	ASSERT((length >= 2u) && (length <= ADC_STREAM_MAX_LENGTH) && ((length % 2u) == 0u));
+
+	uint8_t index = get_adc_index(ADCx);
+
+	adc_stream_state[index].callback = callback;
+	adc_stream_state[index].scan_callback = NULL;
+	adc_stream_state[index].frame_size = 1u;
+
+	dma_start(index, &ADCx->DR, buffer, length, 1u);
+	adc_start(ADCx);
+}
+
+/**
+ * @brief Starts streaming whole scans of the regular sequence into a circular buffer
+ * @param ADCx Pointer to the ADC peripheral
+ * @param buffer Buffer receiving num_of_frames scans back to back
+ * @param num_of_frames Number of scans the buffer holds
+ * @param callback Function called when a half of the frames is ready
+*/
+void adc_scan_start(ADC_TypeDef* ADCx, volatile uint16_t* buffer, uint32_t num_of_frames, ADC_Scan_Callback callback) {
+	uint8_t index = get_adc_index(ADCx);
+	uint8_t frame_size = get_regular_sequence_length(ADCx);
+	uint32_t length = num_of_frames * frame_size;
+
+	ASSERT(buffer != NULL);
+	ASSERT((num_of_frames >= 2u) && ((num_of_frames % 2u) == 0u));
+	ASSERT(length <= ADC_STREAM_MAX_LENGTH);
+
+	adc_stream_state[index].callback = NULL;
+	adc_stream_state[index].scan_callback = callback;
+	adc_stream_state[index].frame_size = frame_size;
+
+	dma_start(index, &ADCx->DR, buffer, length, 1u);
+	adc_start(ADCx);
+}
+
+/**
+ * @brief Stops streaming conversions of the specified ADC
+ * @param ADCx Pointer to the ADC peripheral
+*/
+void adc_stream_stop(ADC_TypeDef* ADCx) {
+	uint8_t index = get_adc_index(ADCx);
+	DMA_Stream_TypeDef* stream = get_dma_stream(index);
+
+	ADCx->CR2 &= ~(ADC_CR2_CONT | ADC_CR2_DMA | ADC_CR2_DDS);
+	stream->CR &= ~DMA_SxCR_EN;
+	while (HW_POLL(stream->CR & DMA_SxCR_EN));
+	NVIC_DisableIRQ(adc_stream_dma[index].irq);
+
+	adc_stream_state[index].callback = NULL;
+	adc_stream_state[index].scan_callback = NULL;
+}
+
+/**
+ * @brief Gets the index in the buffer the DMA will write next
+ * @param ADCx Pointer to the ADC peripheral
+ * @return Index of the next sample to be written
+*/
+uint32_t adc_stream_get_write_index(ADC_TypeDef* ADCx) {
+	uint8_t index = get_adc_index(ADCx);
+	uint32_t remaining = get_dma_stream(index)->NDTR * adc_stream_state[index].samples_per_transfer;
+	uint32_t length = adc_stream_state[index].length;
+
+	return (remaining >= length)? 0u: (length - remaining);
+}
+
+/**
+ * @brief Gets the most recently converted sample of the stream
+ * @param ADCx Pointer to the ADC peripheral
+ * @return The last sample written by the DMA
+*/
+uint16_t adc_stream_get_latest(ADC_TypeDef* ADCx) {
+	uint8_t index = get_adc_index(ADCx);
+	uint32_t write_index = adc_stream_get_write_index(ADCx);
+	uint32_t latest = (write_index == 0u)? (adc_stream_state[index].length - 1u): (write_index - 1u);
+
+	return adc_stream_state[index].buffer[latest] & 0xFFF;
+}
+
+/**
+ * @brief Starts triple interleaved sampling of one channel by ADC1, ADC2 and ADC3
+ * @param channel Channel number sampled by all three converters
+ * @param buffer Buffer receiving the samples in conversion order
+ * @param length Number of samples in the buffer
+ * @param delay_cycles ADCCLK cycles between the sampling phases of two converters
+ * @param callback Function called when a half of the buffer is ready
+*/
+void adc_interleaved_start(uint8_t channel, volatile uint16_t* buffer, uint32_t length, uint8_t delay_cycles, ADC_Stream_Callback callback) {
+	ASSERT(buffer != NULL);
+	ASSERT((length >= 4u) && (length <= (2u * ADC_STREAM_MAX_LENGTH)) && ((length % 4u) == 0u));
+	ASSERT((delay_cycles >= ADC_INTERLEAVED_MIN_DELAY) && (delay_cycles <= ADC_INTERLEAVED_MAX_DELAY));
+
+	ADC_TypeDef* const converters[NUM_ADC_PORTS] = { ADC1, ADC2, ADC3 };
+	uint8_t sequence[] = { channel };
+
+	for (uint8_t i = 0; i < NUM_ADC_PORTS; i++) {
+		ADC_TypeDef* ADCx = converters[i];
+		ADCx->CR2 &= ~(ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_EXTEN | ADC_CR2_SWSTART);
+		set_channel_sample_time(ADCx, channel, ADC_SAMPLE_TIME_3_CYCLES);
+		set_regular_sequence(ADCx, 1, sequence);
+		ADCx->CR2 |= ADC_CR2_CONT;
+		enable_adc_converter(ADCx);
+	}
+
+	// MULTI = 10111: triple interleaved regular mode, DMA mode 2 packs two samples per word
+	ADC->CCR = (ADC->CCR & ~(ADC_CCR_MULTI | ADC_CCR_DELAY | ADC_CCR_DMA | ADC_CCR_DDS)) |
+			ADC_CCR_MULTI_TRIPLE_INTERLEAVED |
+			((uint32_t)(delay_cycles - ADC_INTERLEAVED_MIN_DELAY) << ADC_CCR_DELAY_POS) |
+			ADC_CCR_DMA_1 |
+			ADC_CCR_DDS;
+
+	adc_stream_state[ADC_PORT_1].callback = callback;
+	adc_stream_state[ADC_PORT_1].scan_callback = NULL;
+	adc_stream_state[ADC_PORT_1].frame_size = 1u;
+
+	// the ADC1 request of DMA2 stream 0 serves the common data register in multi mode
+	dma_start(ADC_PORT_1, &ADC->CDR, buffer, length, 2u);
+	start_conversion(ADC1);
+}
+
+/**
+ * @brief Stops triple interleaved sampling and returns the ADCs to independent mode
+*/
+void adc_interleaved_stop(void) {
+	ADC->CCR &= ~(ADC_CCR_MULTI | ADC_CCR_DELAY | ADC_CCR_DMA | ADC_CCR_DDS);
+	ADC2->CR2 &= ~ADC_CR2_CONT;
+	ADC3->CR2 &= ~ADC_CR2_CONT;
+	adc_stream_stop(ADC1);
+}
+
+/**
+ * ISR for DMA2 Stream 0 (ADC1)
+*/
+void DMA2_Stream0_IRQHandler(void) {
+	adc_stream_irq(ADC_PORT_1);
+}
+
+/**
+ * ISR for DMA2 Stream 2 (ADC2)
+*/
+void DMA2_Stream2_IRQHandler(void) {
+	adc_stream_irq(ADC_PORT_2);
+}
+
+/**
+ * ISR for DMA2 Stream 1 (ADC3)
+*/
+void DMA2_Stream1_IRQHandler(void) {
+	adc_stream_irq(ADC_PORT_3);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file: adc_trigger.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements hardware-paced sampling: a general purpose timer counts
+ * the sample period and its update event, routed to TRGO, starts the regular
+ * sequence of the ADC. No software runs between two samples.
+*/
+
+
+#include "adc_trigger.h"
+#include "hw_poll.h"
+
+
+#define ASSERT assert
+
+#define TIM2_MAX_RELOAD     0xFFFFFFFFuL	/* TIM2 is a 32-bit counter */
+#define TIM3_MAX_RELOAD     0xFFFFuL		/* TIM3 is a 16-bit counter */
+#define TIM_MAX_PRESCALER   0xFFFFuL
+
+
+/**
+ * @brief Configures a timer to trigger the regular conversions of an ADC
+ * @param ADCx Pointer to the ADC peripheral
+ * @param TIMx Timer generating the trigger (TIM2 or TIM3)
+ * @param rate_hz Requested sample rate in Hz
+ * @return The sample rate actually produced, in Hz
+*/
+uint32_t adc_trigger_config(ADC_TypeDef* ADCx, TIM_TypeDef* TIMx, uint32_t rate_hz) {
+	ASSERT((ADCx == ADC1) || (ADCx == ADC2) || (ADCx == ADC3));
+	ASSERT((TIMx == TIM2) || (TIMx == TIM3));
+	ASSERT((rate_hz > 0u) && (rate_hz <= APB1_TIMER_FREQ));
+
+	uint32_t max_reload = (TIMx == TIM2)? TIM2_MAX_RELOAD: TIM3_MAX_RELOAD;
+	uint32_t ticks = APB1_TIMER_FREQ / rate_hz;	/* timer clock cycles per sample */
+
+	// smallest prescaler that lets the period fit in the auto-reload register
+	uint32_t prescaler = (ticks - 1u) / max_reload;
+	ASSERT(prescaler <= TIM_MAX_PRESCALER);
+	uint32_t reload = (ticks / (prescaler + 1u)) - 1u;
+
+	RCC->APB1ENR |= (TIMx == TIM2)? RCC_APB1ENR_TIM2EN: RCC_APB1ENR_TIM3EN;
+
+	TIMx->CR1 = 0;
+	TIMx->PSC = prescaler;
+	TIMx->ARR = reload;
+	TIMx->CNT = 0;
+	TIMx->EGR = TIM_EGR_UG;		/* load PSC now instead of at the first overflow */
+	HW_SYNC();
+	TIMx->SR = 0;
+	TIMx->CR2 = (TIMx->CR2 & ~TIM_CR2_MMS) | TIM_CR2_MMS_1;	/* MMS = 010: update event -> TRGO */
+	TIMx->CR1 = TIM_CR1_ARPE;
+
+	// every trigger converts the sequence once
+	ADCx->CR2 &= ~(ADC_CR2_CONT | ADC_CR2_EXTSEL | ADC_CR2_EXTEN);
+	ADCx->CR2 |= ((TIMx == TIM2)? ADC_EXTSEL_TIM2_TRGO: ADC_EXTSEL_TIM3_TRGO) | ADC_EXTEN_RISING;
+
+	return APB1_TIMER_FREQ / ((prescaler + 1u) * (reload + 1u));
+}
+
+/**
+ * @brief Starts generating trigger events
+ * @param TIMx Timer generating the trigger
+*/
+void adc_trigger_start(TIM_TypeDef* TIMx) {
+	ASSERT((TIMx == TIM2) || (TIMx == TIM3));
+
+	TIMx->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief Stops generating trigger events
+ * @param TIMx Timer generating the trigger
+*/
+void adc_trigger_stop(TIM_TypeDef* TIMx) {
+	ASSERT((TIMx == TIM2) || (TIMx == TIM3));
+
+	TIMx->CR1 &= ~TIM_CR1_CEN;
+}
+
+/**
+ * @brief Generates one trigger event
+ * @param TIMx Timer generating the trigger
+*/
+void adc_trigger_fire(TIM_TypeDef* TIMx) {
+	ASSERT((TIMx == TIM2) || (TIMx == TIM3));
+
+	TIMx->EGR = TIM_EGR_UG;
+	HW_SYNC();
+}
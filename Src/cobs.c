@@ -0,0 +1,74 @@
+/**
+ * @file: cobs.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements COBS encoding and decoding. Each encoded block starts
+ * with a code byte giving the distance to the next (removed) zero; code 0xFF
+ * marks a block of 254 non-zero bytes with no zero after it.
+*/
+
+#include "cobs.h"
+
+
+/**
+ * @brief Encodes a packet
+ * @param input Packet bytes
+ * @param length Number of packet bytes
+ * @param output Destination buffer
+ * @return Number of encoded bytes
+*/
+uint32_t cobs_encode(const uint8_t* input, uint32_t length, uint8_t* output) {
+    uint32_t code_index = 0;    // where the code byte of the current block goes
+    uint32_t write_index = 1;
+    uint8_t code = 1;
+
+    for (uint32_t i = 0; i < length; i++) {
+        if (input[i] == 0u) {
+            output[code_index] = code;
+            code_index = write_index++;
+            code = 1;
+        } else {
+            output[write_index++] = input[i];
+            code++;
+            if (code == 0xFFu) {
+                output[code_index] = code;
+                code_index = write_index++;
+                code = 1;
+            }
+        }
+    }
+    output[code_index] = code;
+
+    return write_index;
+}
+
+/**
+ * @brief Decodes a packet
+ * @param input Encoded bytes
+ * @param length Number of encoded bytes
+ * @param output Destination buffer
+ * @return Number of decoded bytes, 0 on malformed input
+*/
+uint32_t cobs_decode(const uint8_t* input, uint32_t length, uint8_t* output) {
+    uint32_t read_index = 0;
+    uint32_t write_index = 0;
+
+    while (read_index < length) {
+        uint8_t code = input[read_index++];
+        if ((code == 0u) || ((read_index + code - 1u) > length)) {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++) {
+            output[write_index++] = input[read_index++];
+        }
+
+        // a zero follows every block except a full one and the last one
+        if ((code != 0xFFu) && (read_index < length)) {
+            output[write_index++] = 0u;
+        }
+    }
+
+    return write_index;
+}
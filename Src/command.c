@@ -0,0 +1,439 @@
+/**
+ * @file: command.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements parsing, dispatch and replies of USART2 commands.
+ *
+ * Command names are looked up through a perfect hash: the second and third
+ * letters and the length of every name land in distinct slots of a
+ * 16-entry table, so a lookup is one hash, one table read and one string
+ * compare, whatever the number of commands. Adding a command means finding
+ * a hash that keeps the slots distinct (tests/command_test.c checks it).
+*/
+
+#include "command.h"
+#include "crc16.h"
+#include "fmt.h"
+
+#define COMMAND_HASH_SIZE       16u
+#define COMMAND_HASH_MASK       (COMMAND_HASH_SIZE - 1u)
+#define COMMAND_MIN_NAME_LENGTH 3u
+#define COMMAND_MAX_NAME_LENGTH 6u
+#define COMMAND_NONE            0xFFu
+#define COMMAND_CRC_LENGTH      2u
+#define RESPONSE_HEADER_LENGTH  4u
+
+#define TO_UPPER(c) ((((c) >= 'a') && ((c) <= 'z'))? (char)((c) - ('a' - 'A')): (c))
+
+/**
+ * @brief Name and argument limits of a command
+*/
+typedef struct {
+    const char* name;
+    uint8_t min_args;
+    uint8_t max_args;
+} Command_Spec_Type;
+
+static const Command_Spec_Type command_specs[COMMAND_COUNT] = {
+    [COMMAND_START]  = {"START",  0u, 1u},
+    [COMMAND_STOP]   = {"STOP",   0u, 0u},
+    [COMMAND_SNAP]   = {"SNAP",   1u, 1u},
+    [COMMAND_SET]    = {"SET",    1u, COMMAND_MAX_ARGS},
+    [COMMAND_STAT]   = {"STAT",   0u, 0u},
+    [COMMAND_TABLE]  = {"TABLE",  0u, 0u},
+    [COMMAND_BINARY] = {"BINARY", 0u, 0u},
+    [COMMAND_PROBE]  = {"PROBE",  0u, 1u},
+    [COMMAND_TRIG]   = {"TRIG",   1u, 2u},
+    [COMMAND_BITS]   = {"BITS",   0u, 1u},
+};
+
+// slot = (name[1] + name[2] + length) & 15
+static const uint8_t command_hash_table[COMMAND_HASH_SIZE] = {
+    [0]  = COMMAND_NONE,
+    [1]  = COMMAND_BITS,    /* 'I' + 'T' + 4 */
+    [2]  = COMMAND_NONE,
+    [3]  = COMMAND_SNAP,    /* 'N' + 'A' + 4 */
+    [4]  = COMMAND_NONE,
+    [5]  = COMMAND_NONE,
+    [6]  = COMMAND_PROBE,   /* 'R' + 'O' + 5 */
+    [7]  = COMMAND_STOP,    /* 'T' + 'O' + 4 */
+    [8]  = COMMAND_TABLE,   /* 'A' + 'B' + 5 */
+    [9]  = COMMAND_STAT,    /* 'T' + 'A' + 4 */
+    [10] = COMMAND_START,   /* 'T' + 'A' + 5 */
+    [11] = COMMAND_NONE,
+    [12] = COMMAND_SET,     /* 'E' + 'T' + 3 */
+    [13] = COMMAND_BINARY,  /* 'I' + 'N' + 6 */
+    [14] = COMMAND_NONE,
+    [15] = COMMAND_TRIG,    /* 'R' + 'I' + 4 */
+};
+
+static const char* const status_names[] = {
+    [COMMAND_OK]             = "OK",
+    [COMMAND_ERROR_UNKNOWN]  = "ERR UNKNOWN",
+    [COMMAND_ERROR_ARGUMENT] = "ERR ARGUMENT",
+    [COMMAND_ERROR_STATE]    = "ERR STATE",
+    [COMMAND_ERROR_FRAME]    = "ERR FRAME",
+};
+
+
+// Finds the command called name[0..length), case-insensitive
+static uint8_t lookup(const char* name, uint32_t length) {
+    if ((length < COMMAND_MIN_NAME_LENGTH) || (length > COMMAND_MAX_NAME_LENGTH)) {
+        return COMMAND_NONE;
+    }
+
+    uint8_t id = command_hash_table[(TO_UPPER(name[1]) + TO_UPPER(name[2]) + length) & COMMAND_HASH_MASK];
+    if (id == COMMAND_NONE) {
+        return COMMAND_NONE;
+    }
+
+    const char* candidate = command_specs[id].name;
+    for (uint32_t i = 0; i < length; i++) {
+        if (TO_UPPER(name[i]) != candidate[i]) {
+            return COMMAND_NONE;
+        }
+    }
+
+    return (candidate[length] == '\0')? id: COMMAND_NONE;
+}
+
+// Parses an unsigned decimal or 0x hex number filling the whole token
+static uint8_t parse_number(const char* token, uint32_t length, uint32_t* value) {
+    uint32_t base = 10u;
+    uint32_t result = 0;
+    uint32_t i = 0;
+
+    if ((length > 2u) && (token[0] == '0') && ((token[1] == 'x') || (token[1] == 'X'))) {
+        base = 16u;
+        i = 2u;
+    }
+    if (i >= length) {
+        return 0;
+    }
+
+    for (; i < length; i++) {
+        char c = TO_UPPER(token[i]);
+        uint32_t digit;
+
+        if ((c >= '0') && (c <= '9')) {
+            digit = (uint32_t)(c - '0');
+        } else if ((base == 16u) && (c >= 'A') && (c <= 'F')) {
+            digit = (uint32_t)(c - 'A' + 10);
+        } else {
+            return 0;
+        }
+
+        if (result > ((0xFFFFFFFFu - digit) / base)) {
+            return 0;   /* does not fit in 32 bits */
+        }
+        result = (result * base) + digit;
+    }
+
+    *value = result;
+    return 1;
+}
+
+static uint8_t is_separator(char c) {
+    return (c == ' ') || (c == ',') || (c == '\t');
+}
+
+static uint8_t check_arguments(const Command_Type* command) {
+    const Command_Spec_Type* spec = &command_specs[command->id];
+
+    return ((command->argc >= spec->min_args) && (command->argc <= spec->max_args))?
+           COMMAND_OK: COMMAND_ERROR_ARGUMENT;
+}
+
+static void put_u32(uint8_t* destination, uint32_t value) {
+    destination[0] = (uint8_t)value;
+    destination[1] = (uint8_t)(value >> 8);
+    destination[2] = (uint8_t)(value >> 16);
+    destination[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get_u32(const uint8_t* source) {
+    return source[0] | ((uint32_t)source[1] << 8) | ((uint32_t)source[2] << 16) | ((uint32_t)source[3] << 24);
+}
+
+// Appends a CRC to packet[0..length), COBS encodes it into frame and terminates it
+static uint32_t finish_frame(uint8_t* packet, uint32_t length, uint8_t* frame) {
+    uint16_t crc = crc16_ccitt(packet, length);
+
+    packet[length++] = (uint8_t)crc;
+    packet[length++] = (uint8_t)(crc >> 8);
+
+    length = cobs_encode(packet, length, frame);
+    frame[length++] = COBS_DELIMITER;
+    return length;
+}
+
+// Decodes a COBS frame and strips its CRC, returns the payload length or 0
+static uint32_t open_frame(const uint8_t* frame, uint32_t length, uint8_t* packet, uint32_t size) {
+    if ((length == 0u) || (length > size)) {
+        return 0;
+    }
+
+    uint32_t packet_length = cobs_decode(frame, length, packet);
+    if (packet_length <= COMMAND_CRC_LENGTH) {
+        return 0;
+    }
+
+    packet_length -= COMMAND_CRC_LENGTH;
+    uint16_t crc = (uint16_t)(packet[packet_length] | (packet[packet_length + 1u] << 8));
+    return (crc16_ccitt(packet, packet_length) == crc)? packet_length: 0u;
+}
+
+static uint32_t text_reply(uint8_t id, const Command_Response_Type* response, uint8_t* reply) {
+    uint8_t known = response->status < (sizeof(status_names) / sizeof(status_names[0]));
+    Fmt_Buffer_Type text;
+
+    fmt_init(&text, (char*)reply, COMMAND_MAX_REPLY_LENGTH);
+    fmt_str(&text, known? status_names[response->status]: "ERR", 0u, 0u);
+
+    if (response->status == COMMAND_OK) {
+        fmt_char(&text, ' ');
+        fmt_str(&text, command_name(id), 0u, 0u);
+        for (uint32_t i = 0; i < response->count; i++) {
+            fmt_char(&text, ' ');
+            fmt_u32(&text, response->values[i], 0u, 0u);
+        }
+    }
+
+    fmt_str(&text, "\r\n", 0u, 0u);
+    return text.length;
+}
+
+static uint32_t binary_reply(uint8_t id, const Command_Response_Type* response, uint8_t* reply) {
+    uint8_t packet[RESPONSE_HEADER_LENGTH + (COMMAND_MAX_VALUES * 4u) + COMMAND_CRC_LENGTH];
+    uint32_t length = RESPONSE_HEADER_LENGTH;
+
+    packet[0] = COMMAND_RESPONSE_TYPE;
+    packet[1] = id;
+    packet[2] = response->status;
+    packet[3] = response->count;
+    for (uint32_t i = 0; i < response->count; i++) {
+        put_u32(&packet[length], response->values[i]);
+        length += 4u;
+    }
+
+    return finish_frame(packet, length, reply);
+}
+
+// Validates, runs and answers one complete command
+static uint32_t execute(Command_Reader_Type* reader, const Command_Handler handlers[COMMAND_COUNT], uint8_t* reply) {
+    Command_Type command = {.id = COMMAND_NONE};
+    Command_Response_Type response = {.status = COMMAND_OK, .count = 0};
+
+    if (reader->overflow) {
+        response.status = reader->binary? COMMAND_ERROR_FRAME: COMMAND_ERROR_ARGUMENT;
+    } else if (reader->binary) {
+        response.status = command_parse_binary(reader->buffer, reader->length, &command);
+    } else {
+        response.status = command_parse_text((const char*)reader->buffer, reader->length, &command);
+    }
+
+    if ((response.status == COMMAND_OK) && (handlers[command.id] != 0)) {
+        handlers[command.id](&command, &response);
+        if (response.count > COMMAND_MAX_VALUES) {
+            response.count = COMMAND_MAX_VALUES;
+        }
+    } else if (response.status == COMMAND_OK) {
+        response.status = COMMAND_ERROR_UNKNOWN;    /* not handled by this firmware */
+    }
+
+    if (response.status != COMMAND_OK) {
+        response.count = 0;
+    }
+
+    return reader->binary? binary_reply(command.id, &response, reply): text_reply(command.id, &response, reply);
+}
+
+
+/**
+ * @brief Resets a reader
+ * @param reader Reader to initialize
+*/
+void command_reader_init(Command_Reader_Type* reader) {
+    reader->length = 0;
+    reader->binary = 0;
+    reader->overflow = 0;
+}
+
+/**
+ * @brief Feeds one byte to a reader
+ * @param reader Reader collecting the command
+ * @param byte Received byte
+ * @param handlers Command handlers
+ * @param reply Destination of the reply
+ * @return Reply length, 0 if no command was completed
+ *
+ * A 0x00 opens a binary frame and the next 0x00 closes it; otherwise bytes
+ * collect into a text line until '\r' or '\n'.
+*/
+uint32_t command_reader_feed(Command_Reader_Type* reader, uint8_t byte, const Command_Handler handlers[COMMAND_COUNT], uint8_t* reply) {
+    uint8_t complete = 0;
+
+    if (byte == COBS_DELIMITER) {
+        if (reader->binary && ((reader->length != 0u) || reader->overflow)) {
+            complete = 1;
+        } else {
+            command_reader_init(reader);    /* opening delimiter, any partial text is dropped */
+            reader->binary = 1;
+        }
+    } else if (!reader->binary && ((byte == '\r') || (byte == '\n'))) {
+        complete = (reader->length != 0u) || reader->overflow;
+    } else if (reader->length < (reader->binary? COMMAND_MAX_FRAME_LENGTH: COMMAND_LINE_SIZE)) {
+        reader->buffer[reader->length++] = byte;
+    } else {
+        reader->overflow = 1;
+    }
+
+    if (!complete) {
+        return 0;
+    }
+
+    uint32_t length = execute(reader, handlers, reply);
+    command_reader_init(reader);
+    return length;
+}
+
+/**
+ * @brief Parses a text command
+ * @param line Command text
+ * @param length Number of characters
+ * @param command Destination of the command
+ * @return Command_Status_Type
+*/
+uint8_t command_parse_text(const char* line, uint32_t length, Command_Type* command) {
+    uint32_t i = 0;
+
+    while ((i < length) && is_separator(line[i])) {
+        i++;
+    }
+
+    uint32_t start = i;
+    while ((i < length) && !is_separator(line[i])) {
+        i++;
+    }
+
+    command->id = lookup(&line[start], i - start);
+    command->argc = 0;
+    if (command->id == COMMAND_NONE) {
+        return COMMAND_ERROR_UNKNOWN;
+    }
+
+    for (;;) {
+        while ((i < length) && is_separator(line[i])) {
+            i++;
+        }
+        if (i >= length) {
+            break;
+        }
+
+        start = i;
+        while ((i < length) && !is_separator(line[i])) {
+            i++;
+        }
+
+        if ((command->argc >= COMMAND_MAX_ARGS) ||
+            !parse_number(&line[start], i - start, &command->argv[command->argc])) {
+            return COMMAND_ERROR_ARGUMENT;
+        }
+        command->argc++;
+    }
+
+    return check_arguments(command);
+}
+
+/**
+ * @brief Parses a binary command
+ * @param frame COBS encoded bytes
+ * @param length Number of encoded bytes
+ * @param command Destination of the command
+ * @return Command_Status_Type
+*/
+uint8_t command_parse_binary(const uint8_t* frame, uint32_t length, Command_Type* command) {
+    uint8_t packet[COMMAND_MAX_FRAME_LENGTH];
+    uint32_t packet_length = open_frame(frame, length, packet, sizeof(packet));
+
+    command->id = COMMAND_NONE;
+    command->argc = 0;
+
+    if ((packet_length < 2u) || (packet_length != (2u + (packet[1] * 4u)))) {
+        return COMMAND_ERROR_FRAME;
+    }
+    if (packet[0] >= COMMAND_COUNT) {
+        return COMMAND_ERROR_UNKNOWN;
+    }
+    if (packet[1] > COMMAND_MAX_ARGS) {
+        return COMMAND_ERROR_ARGUMENT;
+    }
+
+    command->id = packet[0];
+    command->argc = packet[1];
+    for (uint32_t i = 0; i < command->argc; i++) {
+        command->argv[i] = get_u32(&packet[2u + (i * 4u)]);
+    }
+
+    return check_arguments(command);
+}
+
+/**
+ * @brief Builds the binary form of a command
+ * @param command Command to encode
+ * @param frame Destination buffer
+ * @return Bytes written, delimiters included
+*/
+uint32_t command_encode_binary(const Command_Type* command, uint8_t* frame) {
+    uint8_t packet[COMMAND_MAX_PACKET_LENGTH];
+    uint32_t argc = (command->argc > COMMAND_MAX_ARGS)? COMMAND_MAX_ARGS: command->argc;
+    uint32_t length = 2u;
+
+    packet[0] = command->id;
+    packet[1] = (uint8_t)argc;
+    for (uint32_t i = 0; i < argc; i++) {
+        put_u32(&packet[length], command->argv[i]);
+        length += 4u;
+    }
+
+    frame[0] = COBS_DELIMITER;
+    return 1u + finish_frame(packet, length, &frame[1]);
+}
+
+/**
+ * @brief Parses a binary response
+ * @param frame COBS encoded bytes
+ * @param length Number of encoded bytes
+ * @param id Destination of the command id
+ * @param response Destination of the response
+ * @return 1 if valid, 0 otherwise
+*/
+uint8_t command_decode_response(const uint8_t* frame, uint32_t length, uint8_t* id, Command_Response_Type* response) {
+    uint8_t packet[COMMAND_MAX_REPLY_LENGTH];
+    uint32_t packet_length = open_frame(frame, length, packet, sizeof(packet));
+
+    if ((packet_length < RESPONSE_HEADER_LENGTH) ||
+        (packet[0] != COMMAND_RESPONSE_TYPE) ||
+        (packet[3] > COMMAND_MAX_VALUES) ||
+        (packet_length != (RESPONSE_HEADER_LENGTH + (packet[3] * 4u)))) {
+        return 0;
+    }
+
+    *id = packet[1];
+    response->status = packet[2];
+    response->count = packet[3];
+    for (uint32_t i = 0; i < response->count; i++) {
+        response->values[i] = get_u32(&packet[RESPONSE_HEADER_LENGTH + (i * 4u)]);
+    }
+    return 1;
+}
+
+/**
+ * @brief Gets the name of a command
+ * @param id Command identifier
+ * @return Name of the command
+*/
+const char* command_name(uint8_t id) {
+    return (id < COMMAND_COUNT)? command_specs[id].name: "?";
+}
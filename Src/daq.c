@@ -0,0 +1,491 @@
+/**
+ * @file: daq.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the acquisition controller: ADC1 streams the regular
+ * sequence into a circular buffer through DMA2, TIM2 paces the conversions,
+ * and commands received on USART2 reconfigure both without stopping the
+ * main loop. Each DMA half buffer becomes one telemetry frame in binary mode,
+ * or, with BITS above 12, is decimated into a block of wider results that
+ * leaves as one frame once it holds a half buffer's worth.
+*/
+
+#include "daq.h"
+#include "gpio.h"
+#include "adc.h"
+#include "adc_stream.h"
+#include "adc_trigger.h"
+#include "usart.h"
+#include "term_render.h"
+#include "profile.h"
+#include "strobe.h"
+#include "hw_poll.h"
+#include "oversample.h"
+
+
+#define DAQ_HALF_LENGTH         (DAQ_STREAM_LENGTH / 2u)
+#define DAQ_MAX_CHANNEL         15u     /* channels 16-18 are internal, not wired to pins */
+#define DAQ_NO_PIN              0xFFu
+#define DAQ_SNAP_SPIN_LIMIT     100000u /* polls of the DMA counter per software trigger */
+
+// Pin of each external ADC123 channel; PA2/PA3 carry USART2 and PA6 drives an LED
+static const uint8_t daq_channel_pins[DAQ_MAX_CHANNEL + 1u] = {
+	PA0, PA1, DAQ_NO_PIN, DAQ_NO_PIN, PA4, PA5, DAQ_NO_PIN, PA7,
+	PB0, PB1, PC0, PC1, PC2, PC3, PC4, PC5,
+};
+
+static volatile uint16_t daq_buffer[DAQ_STREAM_LENGTH];
+
+static volatile uint16_t* volatile daq_ready_half = NULL;	/* half of the buffer the DMA just filled */
+static volatile uint32_t daq_ready_halves = 0u;	/* halves filled so far, doubles as the packet sequence */
+
+static uint32_t daq_sent_halves = 0u;	/* daq_ready_halves at the last telemetry frame */
+static uint32_t daq_frames_sent = 0u;
+static uint32_t daq_frames_dropped = 0u;
+
+static uint8_t daq_running = 0u;
+static uint32_t daq_rate_hz = 0u;
+static uint16_t daq_channel_mask = 0u;
+static uint8_t daq_num_of_channels = 0u;
+static uint8_t daq_output_mode = DAQ_DEFAULT_OUTPUT;
+
+static Oversample_Type daq_oversample;	/* extra_bits 0: frames carry the raw conversions */
+static uint16_t daq_wide_block[DAQ_HALF_LENGTH];	/* decimated results waiting for a frame */
+static uint32_t daq_wide_count = 0u;
+static uint16_t daq_wide_sequence = 0u;	/* sequence of the WIDE16 frames, +1 per lost block too */
+
+static Command_Reader_Type daq_reader;
+static void (*volatile daq_ready_callback)(void) = NULL;
+
+
+/* DMA2 Stream 0 half/full transfer: only record which half is ready */
+static void on_samples(volatile uint16_t* samples, uint32_t num_of_samples) {
+	(void)num_of_samples;
+	daq_ready_half = samples;
+	daq_ready_halves++;
+	if (daq_ready_callback != NULL) {
+		daq_ready_callback();
+	}
+}
+
+/* Reads the ready half and its count together, so an interrupt in between cannot pair one with the other */
+static uint32_t get_ready_half(volatile uint16_t** half) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t ready = daq_ready_halves;
+	*half = daq_ready_half;
+	__set_PRIMASK(primask);
+	return ready;
+}
+
+/* Programs the regular sequence and (re)starts the DMA stream */
+static void start_stream(uint8_t num_of_channels, uint8_t channels[]) {
+	daq_channel_mask = 0u;
+	daq_num_of_channels = num_of_channels;
+	for (uint8_t i = 0; i < num_of_channels; i++) {
+		uint8_t pin = daq_channel_pins[channels[i]];
+
+		GPIOx_init(pin / NUM_PINS_PER_PORT);
+		GPIOx_config_mode(pin, MODER_ANALOG);
+		daq_channel_mask |= (uint16_t)(1u << channels[i]);
+	}
+
+	set_regular_sequence(ADC1, num_of_channels, channels);
+	adc_stream_start(ADC1, daq_buffer, DAQ_STREAM_LENGTH, on_samples);
+}
+
+/* Copies the count samples written last, oldest first */
+static void copy_latest(uint32_t count, uint32_t* destination) {
+	uint32_t index = adc_stream_get_write_index(ADC1);
+
+	for (uint32_t i = 0; i < count; i++) {
+		destination[i] = daq_buffer[(index + DAQ_STREAM_LENGTH - count + i) % DAQ_STREAM_LENGTH];
+	}
+}
+
+/* Converts count samples on demand while the timer is stopped */
+static uint8_t acquire(uint32_t count) {
+	uint32_t acquired = 0u;
+
+	while (acquired < count) {
+		uint32_t before = adc_stream_get_write_index(ADC1);
+		uint32_t after = before;
+		uint32_t spins = 0u;
+
+		adc_trigger_fire(TIM2);
+		while (HW_POLL((after == before) && (spins++ < DAQ_SNAP_SPIN_LIMIT))) {
+			after = adc_stream_get_write_index(ADC1);
+		}
+		if (after == before) {
+			return 0u;	/* no conversion came out of the trigger */
+		}
+		acquired += (after + DAQ_STREAM_LENGTH - before) % DAQ_STREAM_LENGTH;
+	}
+
+	return 1u;
+}
+
+/* Formats one telemetry frame of DAQ_HALF_LENGTH samples straight into the USART2 DMA buffer */
+static void send_telemetry_frame(uint8_t type, const uint16_t* samples, uint32_t sequence) {
+	uint32_t data_length = (type == TELEMETRY_TYPE_WIDE16)?
+			TELEMETRY_WIDE16_LENGTH(DAQ_HALF_LENGTH): PACK12_LENGTH(DAQ_HALF_LENGTH);
+	char* frame = USART2_tx_reserve(TELEMETRY_FRAME_LENGTH(data_length));
+
+	if (frame == NULL) {
+		daq_frames_dropped++;	/* link saturated, the decoder sees the gap in the sequence numbers */
+		return;
+	}
+
+	Telemetry_Header_Type header = {
+		.type = type,
+		.sequence = (uint16_t)sequence,
+		.timestamp = getMillis(),
+		.channel_mask = daq_channel_mask,
+		.num_of_samples = DAQ_HALF_LENGTH,
+		.bits = oversample_bits(&daq_oversample),
+	};
+
+	/* the DMA is filling the other half, this one is stable until it wraps */
+	PROFILE_BEGIN(PROFILE_TELEMETRY);
+	USART2_tx_commit(telemetry_encode_frame(&header, samples, (uint8_t*)frame));
+	PROFILE_END(PROFILE_TELEMETRY);
+	daq_frames_sent++;
+}
+
+/* Drops the partial result and the results not sent yet */
+static void restart_decimation(void) {
+	oversample_reset(&daq_oversample);
+	daq_wide_count = 0u;
+}
+
+/* Decimates one half buffer, sends the results once they fill a frame */
+static void decimate_half(volatile uint16_t* samples, uint32_t skipped_halves) {
+	// a result must not span the conversions that were never read
+	if (skipped_halves != 0u) {
+		restart_decimation();
+		daq_wide_sequence++;	/* the block they belonged to is lost */
+	}
+
+	/* the DMA is filling the other half, this one is stable until it wraps */
+	PROFILE_BEGIN(PROFILE_OVERSAMPLE);
+	daq_wide_count += oversample_process(&daq_oversample, (const uint16_t*)samples, DAQ_HALF_LENGTH,
+			&daq_wide_block[daq_wide_count]);
+	PROFILE_END(PROFILE_OVERSAMPLE);
+
+	// 4^n divides or is a multiple of DAQ_HALF_LENGTH, the block fills exactly
+	if (daq_wide_count == DAQ_HALF_LENGTH) {
+		send_telemetry_frame(TELEMETRY_TYPE_WIDE16, daq_wide_block, daq_wide_sequence++);
+		daq_wide_count = 0u;
+	}
+}
+
+
+/*
+ * Whether a pulse ending span_ns after a trigger is over before the next one at rate_hz;
+ * TIM2 needs no prescaler, so its period is APB1_TIMER_FREQ / rate_hz whole ticks.
+ * Compared in ticks, the rounding of span_ns to ns cannot hide a tie.
+*/
+static uint8_t strobe_fits(uint64_t span_ns, uint32_t rate_hz) {
+	uint64_t period_ticks = APB1_TIMER_FREQ / rate_hz;
+	uint64_t span_ticks = ((span_ns * APB1_TIMER_FREQ) + 500000000uLL) / 1000000000uLL;
+
+	return (span_ticks < period_ticks)? 1u: 0u;
+}
+
+
+/* START [rate_hz]: (re)start paced acquisition, reply with the actual rate */
+static void handle_start(const Command_Type* command, Command_Response_Type* response) {
+	uint32_t rate_hz = (command->argc != 0u)? command->argv[0]: daq_rate_hz;
+
+	if ((rate_hz == 0u) || (rate_hz > DAQ_MAX_RATE_HZ)) {
+		response->status = COMMAND_ERROR_ARGUMENT;
+		return;
+	}
+	// a running strobe pulse must still end before the next trigger, TRIG 0 or a shorter TRIG first
+	if (strobe_running() && !strobe_fits(strobe_get_span_ns(), rate_hz)) {
+		response->status = COMMAND_ERROR_STATE;
+		return;
+	}
+
+	adc_trigger_stop(TIM2);
+	daq_rate_hz = adc_trigger_config(ADC1, TIM2, rate_hz);
+	adc_trigger_start(TIM2);
+	daq_running = 1u;
+
+	response->values[response->count++] = daq_rate_hz;
+}
+
+/* STOP: stop the trigger, the stream stays armed for SNAP */
+static void handle_stop(const Command_Type* command, Command_Response_Type* response) {
+	(void)command;
+	(void)response;
+
+	adc_trigger_stop(TIM2);
+	daq_running = 0u;
+}
+
+/* SNAP n: reply with the n latest samples, converting them first when stopped */
+static void handle_snap(const Command_Type* command, Command_Response_Type* response) {
+	uint32_t count = command->argv[0];
+
+	if ((count == 0u) || (count > COMMAND_MAX_VALUES)) {
+		response->status = COMMAND_ERROR_ARGUMENT;
+		return;
+	}
+	if (!daq_running && !acquire(count)) {
+		response->status = COMMAND_ERROR_STATE;
+		return;
+	}
+
+	copy_latest(count, response->values);
+	response->count = (uint8_t)count;
+}
+
+/* SET ch [ch ...]: scan the given channels, reply with the channel mask */
+static void handle_set(const Command_Type* command, Command_Response_Type* response) {
+	uint8_t channels[COMMAND_MAX_ARGS];
+
+	// every half buffer must hold whole scans
+	if ((DAQ_HALF_LENGTH % command->argc) != 0u) {
+		response->status = COMMAND_ERROR_ARGUMENT;
+		return;
+	}
+	// the oversampler sums consecutive conversions, they must come from one channel
+	if ((daq_oversample.extra_bits != 0u) && (command->argc > 1u)) {
+		response->status = COMMAND_ERROR_STATE;
+		return;
+	}
+	for (uint8_t i = 0; i < command->argc; i++) {
+		if ((command->argv[i] > DAQ_MAX_CHANNEL) || (daq_channel_pins[command->argv[i]] == DAQ_NO_PIN)) {
+			response->status = COMMAND_ERROR_ARGUMENT;
+			return;
+		}
+		channels[i] = (uint8_t)command->argv[i];
+	}
+
+	adc_trigger_stop(TIM2);
+	adc_stream_stop(ADC1);
+	start_stream(command->argc, channels);
+	restart_decimation();
+	daq_sent_halves = daq_ready_halves;
+	if (daq_running) {
+		adc_trigger_start(TIM2);
+	}
+
+	response->values[response->count++] = daq_channel_mask;
+}
+
+/* STAT: running, rate, channel mask, output mode, frames sent/dropped, tx/rx bytes dropped */
+static void handle_stat(const Command_Type* command, Command_Response_Type* response) {
+	(void)command;
+
+	response->values[0] = daq_running;
+	response->values[1] = daq_rate_hz;
+	response->values[2] = daq_channel_mask;
+	response->values[3] = daq_output_mode;
+	response->values[4] = daq_frames_sent;
+	response->values[5] = daq_frames_dropped;
+	response->values[6] = USART2_tx_dropped();
+	response->values[7] = USART2_rx_dropped();
+	response->count = 8u;
+}
+
+/* TABLE: back to the ANSI table */
+static void handle_table(const Command_Type* command, Command_Response_Type* response) {
+	(void)command;
+	(void)response;
+
+	daq_output_mode = DAQ_OUTPUT_TABLE;
+}
+
+/* BINARY: stream telemetry frames, starting with the next half buffer */
+static void handle_binary(const Command_Type* command, Command_Response_Type* response) {
+	(void)command;
+	(void)response;
+
+	restart_decimation();
+	daq_sent_halves = daq_ready_halves;
+	daq_output_mode = DAQ_OUTPUT_BINARY;
+}
+
+/* PROBE [n]: count, min, max and mean cycles of probe n, or the mean of every probe */
+static void handle_probe(const Command_Type* command, Command_Response_Type* response) {
+	Profile_Probe_Type probe;
+
+	if (!PROFILE_ENABLED) {
+		response->status = COMMAND_ERROR_STATE;	/* built without -DPROFILE_ENABLED=1 */
+		return;
+	}
+
+	if (command->argc == 0u) {
+		for (uint8_t i = 0; (i < PROFILE_COUNT) && (i < COMMAND_MAX_VALUES); i++) {
+			profile_get(i, &probe);
+			response->values[response->count++] = profile_mean(&probe);
+		}
+		return;
+	}
+
+	if ((command->argv[0] >= PROFILE_COUNT) || !profile_get((uint8_t)command->argv[0], &probe)) {
+		response->status = COMMAND_ERROR_ARGUMENT;
+		return;
+	}
+
+	response->values[0] = probe.count;
+	response->values[1] = (probe.count != 0u)? probe.min: 0u;
+	response->values[2] = probe.max;
+	response->values[3] = profile_mean(&probe);
+	response->count = 4u;
+}
+
+/* TRIG width_ns [phase_ns]: pulse PB5 after every trigger, reply with the actual width and phase; TRIG 0 stops */
+static void handle_trig(const Command_Type* command, Command_Response_Type* response) {
+	uint32_t width_ns = command->argv[0];
+	uint32_t phase_ns = (command->argc > 1u)? command->argv[1]: 0u;
+
+	if (width_ns == 0u) {
+		strobe_stop();
+		return;
+	}
+
+	// the rounded pulse must be over before the next trigger, or every other one is skipped
+	if (!strobe_round(&width_ns, &phase_ns) || !strobe_fits((uint64_t)width_ns + phase_ns, daq_rate_hz)) {
+		response->status = COMMAND_ERROR_ARGUMENT;
+		return;
+	}
+	if (!strobe_start(&width_ns, &phase_ns)) {
+		response->status = COMMAND_ERROR_ARGUMENT;
+		return;
+	}
+
+	response->values[0] = width_ns;
+	response->values[1] = phase_ns;
+	response->count = 2u;
+}
+
+/* BITS [bits]: binary frames carry 12..16 bit results of 4^(bits-12) conversions each, reply with bits and ratio */
+static void handle_bits(const Command_Type* command, Command_Response_Type* response) {
+	if (command->argc != 0u) {
+		uint32_t bits = command->argv[0];
+
+		if ((bits < OVERSAMPLE_INPUT_BITS) || (bits > (OVERSAMPLE_INPUT_BITS + OVERSAMPLE_MAX_EXTRA_BITS))) {
+			response->status = COMMAND_ERROR_ARGUMENT;
+			return;
+		}
+		if ((bits != OVERSAMPLE_INPUT_BITS) && (daq_num_of_channels > 1u)) {
+			response->status = COMMAND_ERROR_STATE;	/* SET one channel first */
+			return;
+		}
+
+		oversample_init(&daq_oversample, (uint8_t)(bits - OVERSAMPLE_INPUT_BITS));
+		restart_decimation();
+		daq_sent_halves = daq_ready_halves;
+	}
+
+	response->values[0] = oversample_bits(&daq_oversample);
+	response->values[1] = daq_oversample.ratio;
+	response->count = 2u;
+}
+
+const Command_Handler daq_command_handlers[COMMAND_COUNT] = {
+	[COMMAND_START]  = handle_start,
+	[COMMAND_STOP]   = handle_stop,
+	[COMMAND_SNAP]   = handle_snap,
+	[COMMAND_SET]    = handle_set,
+	[COMMAND_STAT]   = handle_stat,
+	[COMMAND_TABLE]  = handle_table,
+	[COMMAND_BINARY] = handle_binary,
+	[COMMAND_PROBE]  = handle_probe,
+	[COMMAND_TRIG]   = handle_trig,
+	[COMMAND_BITS]   = handle_bits,
+};
+
+
+/**
+ * @brief Sets up and starts paced acquisition of the default channel
+*/
+void daq_init(void) {
+	uint8_t channels[] = {DAQ_DEFAULT_CHANNEL};
+
+	command_reader_init(&daq_reader);
+	oversample_init(&daq_oversample, 0u);
+
+	ADCx_init(ADC1);	/* initializing(Enabling Clock) for ADC1 */
+	enable_adc_converter(ADC1);	/* Enable ADC */
+
+	daq_rate_hz = adc_trigger_config(ADC1, TIM2, DAQ_DEFAULT_RATE_HZ);	/* TIM2 TRGO starts every conversion */
+	start_stream(1u, channels);	/* DMA2 moves every conversion into the circular buffer */
+	adc_trigger_start(TIM2);
+	daq_running = 1u;
+}
+
+/**
+ * @brief Runs pending commands and sends the ready half buffer
+*/
+void daq_poll(void) {
+	daq_serve_commands();
+	daq_send_telemetry();
+}
+
+/**
+ * @brief Runs the commands completed by the received bytes
+*/
+void daq_serve_commands(void) {
+	uint8_t reply[COMMAND_MAX_REPLY_LENGTH];
+	uint8_t byte;
+
+	while (USART2_rx_pop(&byte)) {
+		PROFILE_BEGIN(PROFILE_COMMAND);
+		uint32_t length = command_reader_feed(&daq_reader, byte, daq_command_handlers, reply);
+		if (length != 0u) {
+			PROFILE_END(PROFILE_COMMAND);	/* only bytes that complete a command are counted */
+			if ((daq_output_mode == DAQ_OUTPUT_TABLE) && (reply[length - 1u] == '\n')) {
+				USART2_dma_write(TERM_STATUS_LINE, sizeof(TERM_STATUS_LINE) - 1u);	/* below the table */
+			}
+			USART2_dma_write((const char*)reply, length);
+		}
+	}
+}
+
+/**
+ * @brief Sends, or decimates, the ready half buffer in binary mode
+*/
+void daq_send_telemetry(void) {
+	if (daq_output_mode == DAQ_OUTPUT_BINARY) {
+		volatile uint16_t* half;
+		uint32_t ready = get_ready_half(&half);
+		if (ready != daq_sent_halves) {
+			uint32_t skipped = ready - daq_sent_halves - 1u;
+			daq_sent_halves = ready;
+			if (daq_oversample.extra_bits == 0u) {
+				send_telemetry_frame(DAQ_TELEMETRY_ENCODING, (const uint16_t*)half, ready);
+			} else {
+				decimate_half(half, skipped);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Sets the function called when a half buffer is ready
+ * @param callback Function called from the DMA interrupt, or NULL
+*/
+void daq_set_ready_callback(void (*callback)(void)) {
+	daq_ready_callback = callback;
+}
+
+/**
+ * @brief Gets the selected output format
+ * @return Output mode
+*/
+uint8_t daq_get_output_mode(void) {
+	return daq_output_mode;
+}
+
+/**
+ * @brief Gets the most recent sample
+ * @return Latest sample of the stream
+*/
+uint16_t daq_get_latest(void) {
+	return adc_stream_get_latest(ADC1);
+}
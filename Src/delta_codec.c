@@ -0,0 +1,104 @@
+/**
+ * @file: delta_codec.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the delta + zigzag + nibble varint sample codec.
+*/
+
+#include "delta_codec.h"
+
+#define SAMPLE_MASK     0x0FFFu
+#define NIBBLE_DATA     0x07u   /* 3 payload bits per nibble */
+#define NIBBLE_MORE     0x08u   /* another nibble follows */
+#define NIBBLE_BITS     3u
+
+
+/**
+ * @brief Compresses a block of samples
+ * @param samples Samples to compress
+ * @param count Number of samples
+ * @param output Destination buffer
+ * @param max_length Size limit of the output
+ * @return Bytes written, 0 if over the limit
+*/
+uint32_t delta_encode(const uint16_t* samples, uint32_t count, uint8_t* output, uint32_t max_length) {
+    uint32_t nibbles = 0;
+    int32_t previous = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t sample = (int32_t)(samples[i] & SAMPLE_MASK);
+        int32_t delta = sample - previous;
+        uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+
+        previous = sample;
+
+        do {
+            uint8_t nibble = (uint8_t)(zigzag & NIBBLE_DATA);
+
+            zigzag >>= NIBBLE_BITS;
+            if (zigzag != 0u) {
+                nibble |= NIBBLE_MORE;
+            }
+
+            if ((nibbles >> 1) >= max_length) {
+                return 0;
+            }
+            if (nibbles & 1u) {
+                output[nibbles >> 1] |= (uint8_t)(nibble << 4);
+            } else {
+                output[nibbles >> 1] = nibble;
+            }
+            nibbles++;
+        } while (zigzag != 0u);
+    }
+
+    return (nibbles + 1u) >> 1;
+}
+
+/**
+ * @brief Expands a compressed block
+ * @param input Compressed bytes
+ * @param length Number of compressed bytes
+ * @param count Number of samples to produce
+ * @param samples Destination buffer
+ * @return 1 if valid, 0 otherwise
+*/
+uint8_t delta_decode(const uint8_t* input, uint32_t length, uint32_t count, uint16_t* samples) {
+    uint32_t nibbles = 0;
+    uint32_t total = length << 1;
+    int32_t previous = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t zigzag = 0;
+        uint32_t shift = 0;
+        uint8_t nibble;
+
+        do {
+            if ((nibbles >= total) || (shift > 12u)) {
+                return 0;   /* truncated block or a run longer than any 12-bit delta */
+            }
+            nibble = (uint8_t)(input[nibbles >> 1] >> ((nibbles & 1u) << 2)) & 0x0Fu;
+            zigzag |= (uint32_t)(nibble & NIBBLE_DATA) << shift;
+            shift += NIBBLE_BITS;
+            nibbles++;
+        } while (nibble & NIBBLE_MORE);
+
+        int32_t sample = previous + (int32_t)((zigzag >> 1) ^ (0u - (zigzag & 1u)));
+        if ((sample < 0) || (sample > (int32_t)SAMPLE_MASK)) {
+            return 0;
+        }
+        samples[i] = (uint16_t)sample;
+        previous = sample;
+    }
+
+    // only a single zero padding nibble may follow the last sample
+    if (((nibbles + 1u) >> 1) != length) {
+        return 0;
+    }
+    if ((nibbles & 1u) && (input[nibbles >> 1] >> 4) != 0u) {
+        return 0;
+    }
+
+    return 1;
+}
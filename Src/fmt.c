@@ -0,0 +1,164 @@
+/**
+ * @file: fmt.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements allocation-free text formatting. Decimal digits are
+ * produced by repeated division by 10, which the Cortex-M4 does in a single
+ * UDIV, into a small stack buffer; nothing here touches the heap.
+*/
+
+#include "fmt.h"
+
+#define FMT_MAX_DIGITS 10u  /* 4294967295 */
+
+
+// Appends count copies of c
+static void fill(Fmt_Buffer_Type* buffer, char c, uint32_t count) {
+    while (count-- != 0u) {
+        fmt_char(buffer, c);
+    }
+}
+
+// Appends a digit string with sign and padding
+static void put_number(Fmt_Buffer_Type* buffer, const char* digits, uint32_t count, char sign, uint8_t width, uint8_t flags) {
+    uint32_t total = count + ((sign != '\0')? 1u: 0u);
+    uint32_t padding = (width > total)? (width - total): 0u;
+
+    if (!(flags & FMT_LEFT) && !(flags & FMT_ZERO)) {
+        fill(buffer, ' ', padding);
+    }
+    if (sign != '\0') {
+        fmt_char(buffer, sign);
+    }
+    if (!(flags & FMT_LEFT) && (flags & FMT_ZERO)) {
+        fill(buffer, '0', padding);
+    }
+    while (count != 0u) {
+        fmt_char(buffer, digits[--count]);
+    }
+    if (flags & FMT_LEFT) {
+        fill(buffer, ' ', padding);
+    }
+}
+
+// Writes the decimal digits of value, least significant first, returns their count
+static uint32_t decimal_digits(uint32_t value, char* digits) {
+    uint32_t count = 0;
+
+    do {
+        digits[count++] = (char)('0' + (value % 10u));
+        value /= 10u;
+    } while (value != 0u);
+
+    return count;
+}
+
+
+/**
+ * @brief Starts formatting into a buffer
+ * @param buffer Formatter state
+ * @param data Destination
+ * @param size Capacity of the destination
+*/
+void fmt_init(Fmt_Buffer_Type* buffer, char* data, uint32_t size) {
+    buffer->data = data;
+    buffer->length = 0;
+    buffer->size = (data != 0)? size: 0u;
+    buffer->overflow = 0;
+}
+
+/**
+ * @brief Appends one character
+ * @param buffer Formatter state
+ * @param c Character to append
+*/
+void fmt_char(Fmt_Buffer_Type* buffer, char c) {
+    if (buffer->length < buffer->size) {
+        buffer->data[buffer->length++] = c;
+    } else {
+        buffer->overflow = 1;
+    }
+}
+
+/**
+ * @brief Appends a padded string
+ * @param buffer Formatter state
+ * @param string String to append
+ * @param width Minimum width
+ * @param flags Alignment
+*/
+void fmt_str(Fmt_Buffer_Type* buffer, const char* string, uint8_t width, uint8_t flags) {
+    uint32_t length = 0;
+
+    while (string[length] != '\0') {
+        length++;
+    }
+
+    uint32_t padding = (width > length)? (width - length): 0u;
+
+    if (!(flags & FMT_LEFT)) {
+        fill(buffer, ' ', padding);
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        fmt_char(buffer, string[i]);
+    }
+    if (flags & FMT_LEFT) {
+        fill(buffer, ' ', padding);
+    }
+}
+
+/**
+ * @brief Appends an unsigned decimal number
+ * @param buffer Formatter state
+ * @param value Number to append
+ * @param width Minimum width
+ * @param flags Alignment and padding
+*/
+void fmt_u32(Fmt_Buffer_Type* buffer, uint32_t value, uint8_t width, uint8_t flags) {
+    char digits[FMT_MAX_DIGITS];
+    uint32_t count = decimal_digits(value, digits);
+
+    put_number(buffer, digits, count, '\0', width, flags);
+}
+
+/**
+ * @brief Appends a signed decimal number
+ * @param buffer Formatter state
+ * @param value Number to append
+ * @param width Minimum width
+ * @param flags Alignment and padding
+*/
+void fmt_i32(Fmt_Buffer_Type* buffer, int32_t value, uint8_t width, uint8_t flags) {
+    char digits[FMT_MAX_DIGITS];
+    uint32_t magnitude = (value < 0)? (0u - (uint32_t)value): (uint32_t)value;
+    uint32_t count = decimal_digits(magnitude, digits);
+
+    put_number(buffer, digits, count, (value < 0)? '-': '\0', width, flags);
+}
+
+/**
+ * @brief Appends a fixed-width hex number
+ * @param buffer Formatter state
+ * @param value Number to append
+ * @param digits Number of digits
+*/
+void fmt_hex(Fmt_Buffer_Type* buffer, uint32_t value, uint8_t digits) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    if (digits > 8u) {
+        digits = 8u;
+    }
+    while (digits-- != 0u) {
+        fmt_char(buffer, hex[(value >> (digits * 4u)) & 0x0Fu]);
+    }
+}
+
+/**
+ * @brief Appends an ANSI color code
+ * @param buffer Formatter state
+ * @param code Escape sequence
+*/
+void fmt_color(Fmt_Buffer_Type* buffer, const char* code) {
+    fmt_str(buffer, code, 0u, 0u);
+}
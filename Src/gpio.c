@@ -12,31 +12,29 @@
 
 #define ASSERT assert
 
-// Helper function to get the GPIO port structure based on port number
-// used to check if the port being accessed has been initialized or
-// in other words, if the bus for the port as been enabled.
-// initially none of the ports are initialized
-//static uint8_t initialized[] = {0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u};
-static GPIO_TypeDef* get_GPIOx_PORT(uint8_t GPIOx) {
-    ASSERT((GPIOx >= 0u) && (GPIOx < NUM_PORTS));
-
-    GPIO_TypeDef* GPIOx_PORTS[] = {
-        GPIOA, GPIOB, GPIOC, GPIOD, GPIOE, GPIOF, GPIOG, GPIOH,
-    };
+// Registers of every port, in flash. Pins known at compile time resolve
+// through GPIOx_PIN_GPIO() instead; this table serves run-time pin numbers
+// without rebuilding an array on the stack at every call.
+static GPIO_TypeDef* const GPIOx_PORTS[NUM_PORTS] = {
+    GPIOA, GPIOB, GPIOC, GPIOD, GPIOE, GPIOF, GPIOG, GPIOH,
+};
 
+// Helper function to get the GPIO port structure based on port number
+static inline GPIO_TypeDef* get_GPIOx_PORT(uint8_t GPIOx) {
+    ASSERT(GPIOx < NUM_PORTS);
     return GPIOx_PORTS[GPIOx];
 }
 
 // Helper function to get the port number from a pin number
 static inline uint8_t get_port_number(uint8_t pin) {
-    ASSERT((pin >= 0U) && (pin < TOTAL_PINS));
-    return (pin / NUM_PINS_PER_PORT);
+    ASSERT(pin < TOTAL_PINS);
+    return (uint8_t)GPIOx_PIN_PORT(pin);
 }
 
 // Helper function to get the pin number within a port
 static inline uint8_t get_pin_number(uint8_t pin) {
-    ASSERT((pin >= 0U) && (pin < TOTAL_PINS));
-    return (pin % NUM_PINS_PER_PORT);
+    ASSERT(pin < TOTAL_PINS);
+    return (uint8_t)GPIOx_PIN_NUMBER(pin);
 }
 
 // Helper function to check if a pin is in alternate function mode
@@ -166,13 +164,14 @@ void GPIOx_config_alternate_function(uint8_t pin, uint8_t alternate_function) {
 /**
  * @brief Set the output data register (ODR) of a GPIO pin
  * @param pin The pin to set
+ *
+ * Goes through BSRR, so an interrupt changing another pin of the same port
+ * in between cannot be undone.
 */
 void GPIOx_set_odr(uint8_t pin) {
-    uint8_t port = get_port_number(pin);
-    uint8_t pin_number = get_pin_number(pin);
-    GPIO_TypeDef* GPIOx = get_GPIOx_PORT(port);
+    ASSERT(pin < TOTAL_PINS);
 
-    GPIOx->ODR |= (1 << pin_number);
+    GPIOx_bsrr_set(pin);
 }
 
 /**
@@ -180,11 +179,21 @@ void GPIOx_set_odr(uint8_t pin) {
  * @param pin The pin to reset
 */
 void GPIOx_reset_odr(uint8_t pin) {
-    uint8_t port = get_port_number(pin);
-    uint8_t pin_number = get_pin_number(pin);
-    GPIO_TypeDef* GPIOx = get_GPIOx_PORT(port);
+    ASSERT(pin < TOTAL_PINS);
+
+    GPIOx_bsrr_reset(pin);
+}
+
+/**
+ * @brief Drive several pins of one port in a single store
+ * @param port The port
+ * @param mask Pins to drive
+ * @param value Level of each pin in mask
+*/
+void GPIOx_write_port(uint8_t port, uint16_t mask, uint16_t value) {
+    ASSERT(port < NUM_PORTS);
 
-    GPIOx->ODR &= ~(1 << pin_number);
+    GPIOx_bsrr_write(port, mask, value);
 }
 
 /**
@@ -193,9 +202,7 @@ void GPIOx_reset_odr(uint8_t pin) {
  * @return The input state of the pin (0 or 1)
 */
 uint8_t GPIOx_get_idr(uint8_t pin) {
-    uint8_t port = get_port_number(pin);
-    uint8_t pin_number = get_pin_number(pin);
-    GPIO_TypeDef* GPIOx = get_GPIOx_PORT(port);
+    ASSERT(pin < TOTAL_PINS);
 
-    return ((GPIOx->IDR & (1 << pin_number)) == 0) ? (uint8_t)0 : (uint8_t)1;
+    return GPIOx_idr_read(pin);
 }
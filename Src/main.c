@@ -26,19 +26,73 @@
 #include "gpio.h"	/* For GPIO pin configurations*/
 #include "adc.h"	/* For ADCx configurations*/
 #include "usart.h"	/* For USART2 configurations*/
+#include "daq.h"	/* For paced acquisition and USART2 commands*/
+#include "term_render.h"	/* For redrawing only the changed cells of the table*/
+#include "fmt.h"	/* For heap-free number formatting*/
+#include "profile.h"	/* For DWT cycle counts of the driver calls*/
+#include "soft_timer.h"	/* For running the table refresh on its own period*/
+#include "scheduler.h"	/* For running work posted by interrupts, sleeping in between*/
+#include "hw_poll.h"	/* For letting busy-waits advance the host simulator*/
 
 #if !defined(__SOFT_FP__) && defined(__ARM_FP)
   #warning "FPU is not initialized, but the project is compiling for an FPU. Please initialize the FPU before use."
 #endif
 
 
+#define TABLE_PERIOD_MS 50u	/* the table is refreshed this often (20 Hz) */
+#define TABLE_RENDER_CHUNK 256u	/* bytes of terminal output queued per refresh at most */
+#define TABLE_ROW 0u	/* position of the box on the terminal */
+#define TABLE_COL 24u
+
+#define LED_PORT_A_MASK ((uint16_t)(GPIOx_PIN_BIT(PA12) | GPIOx_PIN_BIT(PA6)))	/* reading and writing indicators */
+
+// Task priorities, the highest ready one runs first
+#define TASK_SAMPLES 3u	/* a DMA half buffer is ready: send it before it is overwritten */
+#define TASK_COMMANDS 2u	/* bytes were received: run the commands they complete */
+#define TASK_TX_DONE 1u	/* a transmit buffer drained: send the rest of the table */
+#define TASK_TABLE 0u	/* the table period elapsed: read, blink the LEDs and redraw */
+
+static Term_Render_Type table_screen;	/* shadow of what the terminal shows */
+static Soft_Timer_Type table_timer;	/* posts TASK_TABLE every TABLE_PERIOD_MS */
+static uint8_t shown_mode = DAQ_OUTPUT_BINARY;	/* output the terminal was last set up for */
+
+
+/* Draws the static parts of the table into the back screen */
+void draw_table_frame(void) {
+	term_init(&table_screen);	/* the next refresh clears the terminal once */
+
+	term_put_text(&table_screen, TABLE_ROW + 0u, 0u, "Max: 4095", TERM_COLOR_BOLD_RED);
+	term_put_text(&table_screen, TABLE_ROW + 1u, 0u, "Min: 0", TERM_COLOR_BOLD_GREEN);
+
+	term_put_text(&table_screen, TABLE_ROW + 0u, TABLE_COL, ".____________________________.", TERM_COLOR_CYAN);
+	term_put_text(&table_screen, TABLE_ROW + 1u, TABLE_COL, "|                            |", TERM_COLOR_CYAN);
+	term_put_text(&table_screen, TABLE_ROW + 2u, TABLE_COL, "|                            |", TERM_COLOR_CYAN);
+	term_put_text(&table_screen, TABLE_ROW + 2u, TABLE_COL + 2u, "D I G I T A L    V A L U E", TERM_COLOR_BOLD_WHITE);
+	term_put_text(&table_screen, TABLE_ROW + 3u, TABLE_COL, "|                            |", TERM_COLOR_CYAN);
+	term_put_text(&table_screen, TABLE_ROW + 4u, TABLE_COL, "|----------------------------|", TERM_COLOR_CYAN);
+	term_put_text(&table_screen, TABLE_ROW + 5u, TABLE_COL, "|                            |", TERM_COLOR_CYAN);
+	term_put_text(&table_screen, TABLE_ROW + 6u, TABLE_COL, "|                            |", TERM_COLOR_CYAN);
+	term_put_text(&table_screen, TABLE_ROW + 7u, TABLE_COL, "|                            |", TERM_COLOR_CYAN);
+	term_put_text(&table_screen, TABLE_ROW + 8u, TABLE_COL, "|____________________________|", TERM_COLOR_CYAN);
+}
+
+
+/* Sends the cells that differ from what the terminal shows, as many as fit */
+static void flush_table(void) {
+	char* output = USART2_tx_reserve(TABLE_RENDER_CHUNK);
+	if (output != NULL) {
+		USART2_tx_commit(term_render(&table_screen, output, TABLE_RENDER_CHUNK));	/* the rest goes out when the DMA drains */
+	}
+}
+
+
+/* Updates the value in the table and sends only the cells that changed */
 void print_table_in_serial_monitor(void) {
-	printf("\r%s%-9s\t\t\t%s.____________________________.\n", BHRED, "Max: 4095", KCYN);
-	printf("\r%s%-9s\t\t\t%s|                            |\n", BHGRN, "Min: 0", KCYN);
-	printf("\r%-9s\t\t\t%s| %sD I G I T A L    V A L U E %s|\n", " ", KCYN, BHWHT, KCYN);
-	printf("\r%-9s\t\t\t%s|                            |\n", " ", KCYN);
-	printf("\r%-9s\t\t\t%s|----------------------------|\n", " ", KCYN);
-	printf("\r%-9s\t\t\t%s|                            |\n", " ", KCYN);
+	char value[5];
+	Fmt_Buffer_Type text;
+	uint8_t color;
+
+	PROFILE_BEGIN(PROFILE_TABLE);
 
 	// decide text color
 	/*
@@ -47,16 +101,98 @@ void print_table_in_serial_monitor(void) {
 	 * [1000, 3000) 	-> text color: BLUE
 	 * [3000, beyond)	-> text color: RED
 	 * */
-	if ((ADC1_digital_value >= 0) && (ADC1_digital_value < 1000)) {
-		printf("\r%-9s\t\t\t%s|            %s%-4ld            %s|\n", " ", KCYN, BHGRN, ADC1_digital_value, KCYN);
-	} else if ((ADC1_digital_value >= 1000) && (ADC1_digital_value < 3000)) {
-		printf("\r%-9s\t\t\t%s|            %s%-4ld            %s|\n", " ", KCYN, BHBLU, ADC1_digital_value, KCYN);
+	if (ADC1_digital_value < 1000) {
+		color = TERM_COLOR_BOLD_GREEN;
+	} else if (ADC1_digital_value < 3000) {
+		color = TERM_COLOR_BOLD_BLUE;
+	} else {
+		color = TERM_COLOR_BOLD_RED;
+	}
+
+	fmt_init(&text, value, sizeof(value));
+	fmt_u32(&text, ADC1_digital_value, 4u, FMT_LEFT);	/* "%-4lu" without newlib printf */
+	fmt_char(&text, '\0');
+	term_put_text(&table_screen, TABLE_ROW + 6u, TABLE_COL + 13u, value, color);
+	flush_table();
+
+	PROFILE_END(PROFILE_TABLE);
+}
+
+
+/* Sets the terminal up again when a command switched the output format */
+static void follow_output_mode(void) {
+	if (daq_get_output_mode() == DAQ_OUTPUT_BINARY) {
+		GPIOx_bsrr_set(PA6);	/* writing indicator stays lit while streaming */
+		shown_mode = DAQ_OUTPUT_BINARY;
+	} else if (shown_mode != DAQ_OUTPUT_TABLE) {
+		draw_table_frame();	/* the terminal content is unknown, start from a clear screen */
+		shown_mode = DAQ_OUTPUT_TABLE;
+	}
+}
+
+
+/*   T A S K S   */
+
+static void task_samples(void) {
+	daq_send_telemetry();
+}
+
+static void task_commands(void) {
+	daq_serve_commands();
+	follow_output_mode();
+}
+
+static void task_tx_done(void) {
+	if (shown_mode == DAQ_OUTPUT_TABLE) {
+		flush_table();
+	}
+}
+
+/* Reads the latest sample, updates the indicator LEDs and redraws the table */
+static void task_table(void) {
+	static uint32_t last_retrieved_data = 0u;	/* last value read, to blink the LED at PB12 upon change */
+
+	if (shown_mode != DAQ_OUTPUT_TABLE) {
+		return;	/* the telemetry stream owns the line */
+	}
+
+	// reading data: LED at PA12 ON, writing indicator at PA6 OFF, in one store
+	GPIOx_bsrr_write(PA, LED_PORT_A_MASK, GPIOx_PIN_BIT(PA12));
+	ADC1_digital_value = daq_get_latest();
+
+	// change detected: LED at PB12 ON, otherwise OFF
+	if (last_retrieved_data != ADC1_digital_value) {
+		last_retrieved_data = ADC1_digital_value;
+		GPIOx_bsrr_set(PB12);
 	} else {
-		printf("\r%-9s\t\t\t%s|            %s%-4ld            %s|\n", " ", KCYN, BHRED, ADC1_digital_value, KCYN);
+		GPIOx_bsrr_reset(PB12);
 	}
 
-	printf("\r%-9s\t\t\t%s|                            |\n"," ", KCYN);
-	printf("\r%-9s\t\t\t%s|____________________________|\n"," ", KCYN);
+	// writing data: LED at PA6 ON, reading indicator at PA12 OFF
+	GPIOx_bsrr_write(PA, LED_PORT_A_MASK, GPIOx_PIN_BIT(PA6));
+
+	// print table
+	print_table_in_serial_monitor();
+}
+
+
+/*   E V E N T S   (interrupt context, only post work)   */
+
+static void on_samples_ready(void) {
+	sched_post(TASK_SAMPLES);
+}
+
+static void on_byte_received(void) {
+	sched_post(TASK_COMMANDS);
+}
+
+static void on_tx_drained(void) {
+	sched_post(TASK_TX_DONE);
+}
+
+static void on_table_period(void* context) {
+	(void)context;
+	sched_post(TASK_TABLE);
 }
 
 
@@ -65,6 +201,7 @@ int main (void) {
 	// initializing PLL and SysTick
 	clockSpeed_PLL();
 	SysTick_Init();
+	profile_init();	/* starts the DWT cycle counter when built with PROFILE_ENABLED */
 
 	/***************************************************
 	 * 		G P I O    C O N F I G U R A T I O N S     *
@@ -84,19 +221,9 @@ int main (void) {
 	/***************************************************
 	 * 		A D C 1    C O N F I G U R A T I O N S     *
 	 ***************************************************/
-	ADCx_init(ADC1);	/* initializing(Enabling Clock) for ADC1 */
-	enable_adc_converter(ADC1);	/* Enable ADC */
-	set_single_conversion_mode(ADC1);	/* Set ADC to single conversion mode
-	 	 	 	 	 	 	 	 	 	   to only read data from the pin when
-	 	 	 	 	 	 	 	 	 	   required*/
-
-	uint8_t channels[] = {1};	/* Number of channels to listen from.
-								   By default there is only one channel */
-	uint8_t num_of_channels_to_read = 1;
-	set_regular_sequence(ADC1, num_of_channels_to_read, channels);	/* Setting the sequence of reading
-																		from ADC and the number of
-																		channels to read from */
-
+	daq_init();	/* ADC1 on PA1, paced by TIM2 TRGO at DAQ_DEFAULT_RATE_HZ and moved
+				   into a circular buffer by DMA2; START, STOP, SET and SNAP
+				   commands on USART2 change this at run time */
 
 
 	/***************************************************
@@ -105,47 +232,38 @@ int main (void) {
 	USART2_quick_default_config();	/* Setting up USART2 with default configurations
 									   to transmit data from PA2 and receive data from
 									   PA3 */
+	USART2_dma_tx_init();	/* printf() output is handed to DMA1 Stream 6 instead
+							   of waiting on the TC flag for every byte */
+	USART2_rx_interrupt_init();	/* received bytes are queued by the RXNE interrupt,
+								   so commands never block the acquisition */
+
+
 
+	sched_init();
+	sched_register(TASK_SAMPLES, task_samples);
+	sched_register(TASK_COMMANDS, task_commands);
+	sched_register(TASK_TX_DONE, task_tx_done);
+	sched_register(TASK_TABLE, task_table);
 
+	daq_set_ready_callback(on_samples_ready);
+	USART2_set_rx_callback(on_byte_received);
+	USART2_set_tx_callback(on_tx_drained);
 
-	volatile uint32_t last_retrieved_data = 0u; /* to keep track of the last read data and blink the
-	 	 	 	 	 	 	 	 	 	 	 	   the led at PB12 upon change detection */
+	soft_timer_init(getMillis());
+	soft_timer_start(&table_timer, TABLE_PERIOD_MS, TABLE_PERIOD_MS, on_table_period, NULL);
+
+	follow_output_mode();	/* draws the table in table mode */
 
 
 	/******************************
 	 * 	L O O P    F O R E V E R  *
 	 ******************************/
 	for(;;) {
-		start_conversion(ADC1);	/* Trigger SWSTART bit of ADC_CR2 every time
-		 	 	 	 	 	 	   data is to be read */
-
-		// reading data
-		GPIOx_set_odr(PA12);	/* turn LED at PA12 ON to indicate reading */
-		GPIOx_reset_odr(PA6);	/* turn the writing indicator LED OFF */
-		GPIOx_reset_odr(PB12);	/* turn the change detection indicator LED OFF */
-		clearScreen();
-		printf("%s\t reading... \n", KCYN);
-		ADC1_digital_value = get_data(ADC1);
-
-		// change detected
-		if (last_retrieved_data != ADC1_digital_value) {
-			last_retrieved_data = ADC1_digital_value;
-			GPIOx_set_odr(PB12);	/* If a change was detected, turn LED at PB12 ON*/
-		} else {
-			GPIOx_reset_odr(PB12);	/* If a change was not detected, turn LED at PB12 OFF*/
-		}
-
-		// writing data
-		GPIOx_set_odr(PA6);	/* turn LED at PA6 ON to indicate writing */
-		GPIOx_reset_odr(PA12);	/* turn reading indicator LED OFF */
-
-		clearScreen();	/* Clear serial port terminal emulator(GTKTERM) screen */
+		soft_timer_poll(getMillis());	/* expired timers post their tasks */
 
-
-		// print table
-		print_table_in_serial_monitor();
-
-		delay_ms(1000); /* Delay of 1 second after every read cycle */
+		if (!sched_run_once()) {
+			sched_idle();	/* WFI until the next interrupt, SysTick wakes it every 1 ms */
+		}
 	}
 
 	return 0;
@@ -155,8 +273,10 @@ int main (void) {
 
 /* to send char to GTKTERM */
 void tx_send(uint8_t c) {
+	PROFILE_BEGIN(PROFILE_TX_SEND);
 	USART2->DR = c; // load the data into the data register
-	while (!(USART2->SR & (1 << 6)));
+	while (HW_POLL(!(USART2->SR & (1 << 6))));
+	PROFILE_END(PROFILE_TX_SEND);
 }
 
 /* to send data to GTKTERM via the printf() statement */
@@ -0,0 +1,138 @@
+/**
+ * @file: oversample.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the oversample-and-decimate stage.
+ *
+ * Samples are read as halfword pairs. __SADD16 adds two pairs lane by lane;
+ * a lane holds at most 8 twelve-bit samples (8 x 4095 = 32760) before it
+ * would turn negative for the signed multiply, so every 16 samples the two
+ * lanes are folded into the 32-bit sum with __SMLAD(lanes, 0x00010001, sum),
+ * i.e. sum + low + high.
+*/
+
+#include <stddef.h>
+#include "oversample.h"
+
+#ifndef HOST_BUILD
+#include "stm32f446xx.h"    /* CMSIS intrinsics */
+#endif
+
+
+#define OVERSAMPLE_LANE_SAMPLES     8u                              /* per lane between two folds */
+#define OVERSAMPLE_CHUNK            (2u * OVERSAMPLE_LANE_SAMPLES)  /* samples per fold */
+#define OVERSAMPLE_ONES             0x00010001uL                    /* multiplier of both lanes */
+
+typedef uint32_t __attribute__((may_alias)) Oversample_Pair_Type;   /* two samples, one load */
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+
+#define SADD16(a, b)        __SADD16((a), (b))
+#define SMLAD(a, b, sum)    __SMLAD((a), (b), (sum))
+
+#else
+
+// C versions of the two instructions for the host and simulator builds
+static inline uint32_t SADD16(uint32_t a, uint32_t b) {
+    uint32_t low = (a + b) & 0xFFFFu;
+    uint32_t high = ((a >> 16) + (b >> 16)) & 0xFFFFu;
+    return (high << 16) | low;
+}
+
+static inline uint32_t SMLAD(uint32_t a, uint32_t b, uint32_t sum) {
+    int32_t low = (int32_t)(int16_t)a * (int32_t)(int16_t)b;
+    int32_t high = (int32_t)(int16_t)(a >> 16) * (int32_t)(int16_t)(b >> 16);
+    return sum + (uint32_t)low + (uint32_t)high;
+}
+
+#endif
+
+
+// Sum of count samples
+static uint32_t sum_samples(const uint16_t* samples, uint32_t count) {
+    uint32_t sum = 0u;
+
+    if ((((uintptr_t)samples & 2u) != 0u) && (count != 0u)) {
+        sum += *samples++;      /* pairs are loaded from word boundaries */
+        count--;
+    }
+
+    const Oversample_Pair_Type* pairs = (const Oversample_Pair_Type*)samples;
+    while (count >= OVERSAMPLE_CHUNK) {
+        uint32_t lanes = SADD16(pairs[0], pairs[1]);
+        lanes = SADD16(lanes, pairs[2]);
+        lanes = SADD16(lanes, pairs[3]);
+        lanes = SADD16(lanes, pairs[4]);
+        lanes = SADD16(lanes, pairs[5]);
+        lanes = SADD16(lanes, pairs[6]);
+        lanes = SADD16(lanes, pairs[7]);
+        sum = SMLAD(lanes, OVERSAMPLE_ONES, sum);
+        pairs += OVERSAMPLE_LANE_SAMPLES;
+        count -= OVERSAMPLE_CHUNK;
+    }
+
+    samples = (const uint16_t*)pairs;
+    while (count-- != 0u) {
+        sum += *samples++;
+    }
+
+    return sum;
+}
+
+
+/**
+ * @brief Sets the number of extra bits
+ * @param stage Stage to initialize
+ * @param extra_bits Bits gained, clipped to OVERSAMPLE_MAX_EXTRA_BITS
+*/
+void oversample_init(Oversample_Type* stage, uint8_t extra_bits) {
+    if (extra_bits > OVERSAMPLE_MAX_EXTRA_BITS) {
+        extra_bits = OVERSAMPLE_MAX_EXTRA_BITS;
+    }
+
+    stage->extra_bits = extra_bits;
+    stage->ratio = 1uL << (2u * extra_bits);
+    oversample_reset(stage);
+}
+
+/**
+ * @brief Drops the partial sum
+ * @param stage Stage to reset
+*/
+void oversample_reset(Oversample_Type* stage) {
+    stage->pending = 0u;
+    stage->sum = 0u;
+}
+
+/**
+ * @brief Sums the samples and emits one result per 4^n of them
+ * @param stage Stage state
+ * @param samples Input block
+ * @param count Samples in the block
+ * @param results Destination of the results
+ * @return Results written
+*/
+uint32_t oversample_process(Oversample_Type* stage, const uint16_t* samples, uint32_t count, uint16_t* results) {
+    uint32_t rounding = (stage->extra_bits != 0u)? (1uL << (stage->extra_bits - 1u)): 0u;
+    uint32_t written = 0u;
+
+    while (count != 0u) {
+        uint32_t take = stage->ratio - stage->pending;
+        if (take > count) {
+            take = count;
+        }
+
+        stage->sum += sum_samples(samples, take);
+        stage->pending += take;
+        samples += take;
+        count -= take;
+
+        if (stage->pending == stage->ratio) {
+            results[written++] = (uint16_t)((stage->sum + rounding) >> stage->extra_bits);
+            oversample_reset(stage);
+        }
+    }
+
+    return written;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file: pack12.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements 12-bit sample packing.
+ *
+ * The kernels move four samples per step as two 32-bit words in and one
+ * word plus one half-word out (or the reverse), so the Cortex-M4 spends a
+ * handful of shifts and masks per pair instead of a load and store per byte.
+ * Both the core and the host tools are little-endian, which is what lets a
+ * pair of half-word samples be read as one word.
+*/
+
+#include <string.h>
+#include "pack12.h"
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "pack12 expects a little-endian target"
+#endif
+
+#define SAMPLE_MASK 0x0FFFu
+
+
+// Unaligned little-endian accesses; compile to single LDR/STR(H) on the M4
+static inline uint32_t load32(const void* source) {
+    uint32_t value;
+    memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+static inline uint16_t load16(const void* source) {
+    uint16_t value;
+    memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+static inline void store32(void* destination, uint32_t value) {
+    memcpy(destination, &value, sizeof(value));
+}
+
+static inline void store16(void* destination, uint16_t value) {
+    memcpy(destination, &value, sizeof(value));
+}
+
+// Squeezes the pair b:a held as b << 16 | a into the 24-bit value b << 12 | a
+static inline uint32_t squeeze_pair(uint32_t pair) {
+    return (pair & SAMPLE_MASK) | ((pair >> 4) & (SAMPLE_MASK << 12));
+}
+
+
+/**
+ * @brief Packs 12-bit samples
+ * @param samples Samples to pack
+ * @param count Number of samples
+ * @param output Destination buffer
+ * @return Number of bytes written
+*/
+uint32_t pack12(const uint16_t* samples, uint32_t count, uint8_t* output) {
+    uint8_t* out = output;
+    uint32_t i = 0;
+
+    // 4 samples -> 6 bytes
+    for (; i + 4u <= count; i += 4u) {
+        uint32_t low = squeeze_pair(load32(&samples[i]));
+        uint32_t high = squeeze_pair(load32(&samples[i + 2u]));
+
+        store32(out, low | (high << 24));
+        store16(out + 4, (uint16_t)(high >> 8));
+        out += 6;
+    }
+
+    // 2 samples -> 3 bytes
+    if (i + 2u <= count) {
+        uint32_t pair = squeeze_pair(load32(&samples[i]));
+
+        out[0] = (uint8_t)pair;
+        out[1] = (uint8_t)(pair >> 8);
+        out[2] = (uint8_t)(pair >> 16);
+        out += 3;
+        i += 2u;
+    }
+
+    // odd sample -> 2 bytes
+    if (i < count) {
+        store16(out, (uint16_t)(samples[i] & SAMPLE_MASK));
+        out += 2;
+    }
+
+    return (uint32_t)(out - output);
+}
+
+/**
+ * @brief Unpacks samples packed by pack12()
+ * @param input Packed bytes
+ * @param count Number of samples
+ * @param samples Destination buffer
+*/
+void unpack12(const uint8_t* input, uint32_t count, uint16_t* samples) {
+    const uint8_t* in = input;
+    uint32_t i = 0;
+
+    // 6 bytes -> 4 samples
+    for (; i + 4u <= count; i += 4u) {
+        uint32_t word = load32(in);
+        uint32_t half = load16(in + 4);
+
+        store32(&samples[i], (word & SAMPLE_MASK) | ((word << 4) & (SAMPLE_MASK << 16)));
+        store32(&samples[i + 2u], (word >> 24) | ((half & 0x0Fu) << 8) | ((half >> 4) << 16));
+        in += 6;
+    }
+
+    // 3 bytes -> 2 samples
+    if (i + 2u <= count) {
+        uint32_t pair = in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16);
+
+        samples[i] = (uint16_t)(pair & SAMPLE_MASK);
+        samples[i + 1u] = (uint16_t)(pair >> 12);
+        in += 3;
+        i += 2u;
+    }
+
+    // 2 bytes -> odd sample
+    if (i < count) {
+        samples[i] = (uint16_t)(load16(in) & SAMPLE_MASK);
+    }
+}
@@ -5,15 +5,17 @@
  * @author: Anurag
 */
 #include "pll.h"
+#include "hw_poll.h"
 
 
-volatile uint32_t ms_counter = 0;
+#define SYSTICK_CYCLES_PER_US (HCLK_FREQ / 1000000uL)
+
 volatile uint32_t millis = 0;
 
 void clockSpeed_PLL(void){
 
     RCC->CR |= RCC_CR_HSION;
-    while (!(RCC->CR & RCC_CR_HSIRDY));
+    while (HW_POLL(!(RCC->CR & RCC_CR_HSIRDY)));
 
     RCC->PLLCFGR = (PLL_M) | (PLL_N << 6) | (PLL_P << 16) | (PLL_Q << 24);
     RCC->PLLCFGR &=~ RCC_PLLCFGR_PLLSRC;
@@ -21,21 +23,21 @@ void clockSpeed_PLL(void){
     RCC->CFGR |= RCC_CFGR_HPRE_DIV1 | RCC_CFGR_PPRE2_DIV2 | RCC_CFGR_PPRE1_DIV4;
 
     RCC->CR |= RCC_CR_PLLON;
-    while (!(RCC->CR & RCC_CR_PLLRDY));
+    while (HW_POLL(!(RCC->CR & RCC_CR_PLLRDY)));
 
     RCC->APB1ENR |= RCC_APB1ENR_PWREN;
 
     PWR->CR |= PWR_CR_ODEN;
-    while (!(PWR->CSR & PWR_CSR_ODRDY)) ;
+    while (HW_POLL(!(PWR->CSR & PWR_CSR_ODRDY))) ;
 
     PWR->CR |= PWR_CR_ODSWEN;
-    while (!(PWR->CSR & PWR_CSR_ODSWRDY)) ;
+    while (HW_POLL(!(PWR->CSR & PWR_CSR_ODSWRDY))) ;
 
     FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN | FLASH_ACR_LATENCY_5WS;
 
     RCC->CFGR &=~ RCC_CFGR_SW;
     RCC->CFGR |= RCC_CFGR_SW_PLL;
-    while ((RCC->CFGR & RCC_CFGR_SWS ) != RCC_CFGR_SWS_PLL);
+    while (HW_POLL((RCC->CFGR & RCC_CFGR_SWS ) != RCC_CFGR_SWS_PLL));
 }
 
 
@@ -48,17 +50,45 @@ void SysTick_Init(){
 }
 
 void SysTick_Handler(){
-    if (ms_counter) ms_counter--;
     millis++;
 }
 
+/* Waits on the difference of two readings, so overlapping delays no longer share a counter */
 void delay_ms(uint32_t ms){
-    ms_counter = ms;
-    while (ms_counter);
+    uint32_t start = millis;
+    while (HW_POLL((millis - start) < ms));
+}
+
+void delay_us(uint32_t us){
+    uint32_t start = get_micros();
+    while (HW_POLL((get_micros() - start) < us));
 }
 
 uint32_t getMillis(){
     return millis;
 }
 
+/*
+ * SysTick counts VAL down from LOAD once per millisecond. If the tick
+ * interrupt lands between reading millis and VAL, millis changes and the
+ * pair is read again. With interrupts masked (or from a handler of higher
+ * priority) the reload is seen as a pending SysTick and its tick is added
+ * by hand.
+ */
+uint32_t get_micros(){
+    uint32_t ms, val;
+
+    do {
+        ms = millis;
+        val = SysTick->VAL;
+    } while (ms != millis);
+
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        ms++;
+        val = SysTick->VAL;
+    }
+
+    return (ms * 1000u) + ((SysTick->LOAD - val) / SYSTICK_CYCLES_PER_US);
+}
+
 
@@ -0,0 +1,110 @@
+/**
+ * @file: profile.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the probe accumulators behind PROFILE_BEGIN and
+ * PROFILE_END. Elapsed cycles are computed as an unsigned difference, so a
+ * run that spans one wrap of CYCCNT is still measured correctly.
+*/
+
+#include "profile.h"
+
+#if PROFILE_ENABLED
+
+static Profile_Probe_Type profile_probes[PROFILE_COUNT];
+
+#ifdef HOST_BUILD
+volatile uint32_t profile_mock_cycles = 0u;
+#endif
+
+
+/**
+ * @brief Starts the cycle counter and clears every probe
+*/
+void profile_init(void) {
+#ifndef HOST_BUILD
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;    /* DWT is clocked only with trace enabled */
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    profile_reset();
+}
+
+/**
+ * @brief Clears every probe
+*/
+void profile_reset(void) {
+    for (uint32_t i = 0; i < PROFILE_COUNT; i++) {
+        profile_probes[i].count = 0u;
+        profile_probes[i].min = 0xFFFFFFFFu;
+        profile_probes[i].max = 0u;
+        profile_probes[i].total = 0u;
+    }
+}
+
+/**
+ * @brief Accumulates one run of a probe
+ * @param probe Probe identifier
+ * @param cycles Duration of the run
+*/
+void profile_record(uint8_t probe, uint32_t cycles) {
+    if (probe >= PROFILE_COUNT) {
+        return;
+    }
+
+    Profile_Probe_Type* p = &profile_probes[probe];
+    p->count++;
+    p->total += cycles;
+    if (cycles < p->min) {
+        p->min = cycles;
+    }
+    if (cycles > p->max) {
+        p->max = cycles;
+    }
+}
+
+/**
+ * @brief Copies the accumulators of a probe
+ * @param probe Probe identifier
+ * @param result Destination
+ * @return 1 on success, 0 for an unknown probe
+*/
+uint8_t profile_get(uint8_t probe, Profile_Probe_Type* result) {
+    if (probe >= PROFILE_COUNT) {
+        return 0u;
+    }
+
+    *result = profile_probes[probe];
+    return 1u;
+}
+
+#else
+
+void profile_init(void) {
+}
+
+void profile_reset(void) {
+}
+
+void profile_record(uint8_t probe, uint32_t cycles) {
+    (void)probe;
+    (void)cycles;
+}
+
+uint8_t profile_get(uint8_t probe, Profile_Probe_Type* result) {
+    (void)probe;
+    (void)result;
+    return 0u;
+}
+
+#endif /* PROFILE_ENABLED */
+
+/**
+ * @brief Gets the mean duration of a probe
+ * @param probe Accumulators
+ * @return Mean cycles per run
+*/
+uint32_t profile_mean(const Profile_Probe_Type* probe) {
+    return (probe->count == 0u)? 0u: (uint32_t)(probe->total / probe->count);
+}
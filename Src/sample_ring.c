@@ -0,0 +1,88 @@
+/**
+ * @file: sample_ring.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the single-producer/single-consumer sample ring.
+ *
+ * The producer fills the slot before publishing the new head and the
+ * consumer copies the slot out before publishing the new tail. On the
+ * single Cortex-M4 core the ISR and the main loop observe each other's
+ * stores in program order, so a compiler barrier between the data access
+ * and the index update is all the ordering that is needed.
+*/
+
+#include "sample_ring.h"
+
+#define RING_BARRIER() __asm volatile ("" ::: "memory")
+
+
+/**
+ * @brief Empties the ring and resets its overrun counter
+ * @param ring Ring to initialize
+*/
+void sample_ring_init(Sample_Ring_Type* ring) {
+    ring->head = 0u;
+    ring->tail = 0u;
+    ring->overruns = 0u;
+}
+
+/**
+ * @brief Appends a sample, called from the producer only
+ * @param ring Ring to push into
+ * @param sample Sample to store
+ * @return 1 if stored, 0 if dropped
+*/
+uint8_t sample_ring_push(Sample_Ring_Type* ring, const ADC_Sample_Type* sample) {
+    uint32_t head = ring->head;
+
+    if ((head - ring->tail) >= SAMPLE_RING_SIZE) {
+        ring->overruns++;
+        return 0u;
+    }
+
+    ring->items[head & SAMPLE_RING_MASK] = *sample;
+    RING_BARRIER();     /* slot contents before the index that publishes them */
+    ring->head = head + 1u;
+
+    return 1u;
+}
+
+/**
+ * @brief Removes the oldest sample, called from the consumer only
+ * @param ring Ring to pop from
+ * @param sample Destination of the sample
+ * @return 1 if a sample was popped, 0 if the ring was empty
+*/
+uint8_t sample_ring_pop(Sample_Ring_Type* ring, ADC_Sample_Type* sample) {
+    uint32_t tail = ring->tail;
+
+    if (ring->head == tail) {
+        return 0u;
+    }
+
+    RING_BARRIER();     /* head read before the slot it published */
+    *sample = ring->items[tail & SAMPLE_RING_MASK];
+    RING_BARRIER();     /* slot copied out before it is handed back */
+    ring->tail = tail + 1u;
+
+    return 1u;
+}
+
+/**
+ * @brief Gets the number of samples waiting in the ring
+ * @param ring Ring to query
+ * @return Number of samples that can be popped
+*/
+uint32_t sample_ring_count(const Sample_Ring_Type* ring) {
+    return ring->head - ring->tail;
+}
+
+/**
+ * @brief Gets the number of dropped samples
+ * @param ring Ring to query
+ * @return Overrun counter
+*/
+uint32_t sample_ring_overruns(const Sample_Ring_Type* ring) {
+    return ring->overruns;
+}
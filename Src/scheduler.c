@@ -0,0 +1,115 @@
+/**
+ * @file: scheduler.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the priority-bitmap scheduler.
+ *
+ * Both the interrupts that post and the main loop that dispatches modify the
+ * ready word, so every read-modify-write of it is done with interrupts
+ * masked for a couple of instructions, as the USART2 transmit path does.
+*/
+
+#include "scheduler.h"
+
+#ifdef HOST_BUILD
+#define SCHED_CLZ(x)        ((uint8_t)__builtin_clz(x))
+#define SCHED_LOCK()        0u
+#define SCHED_UNLOCK(state) ((void)(state))
+#define SCHED_WAIT()
+#else
+#define SCHED_CLZ(x)        __CLZ(x)
+#define SCHED_LOCK()        lock()
+#define SCHED_UNLOCK(state) __set_PRIMASK(state)
+#define SCHED_WAIT()        __WFI()
+
+static inline uint32_t lock(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+#endif
+
+static Sched_Task sched_tasks[SCHED_MAX_TASKS];
+static volatile uint32_t sched_ready = 0u;
+static uint32_t sched_sleep_count = 0u;
+
+
+/**
+ * @brief Forgets every task and pending post
+*/
+void sched_init(void) {
+    for (uint32_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        sched_tasks[i] = 0;
+    }
+    sched_ready = 0u;
+    sched_sleep_count = 0u;
+}
+
+/**
+ * @brief Installs a task
+ * @param priority Priority of the task
+ * @param task Task body
+*/
+void sched_register(uint8_t priority, Sched_Task task) {
+    if (priority < SCHED_MAX_TASKS) {
+        sched_tasks[priority] = task;
+    }
+}
+
+/**
+ * @brief Marks a task ready
+ * @param priority Priority of the task
+*/
+void sched_post(uint8_t priority) {
+    if (priority >= SCHED_MAX_TASKS) {
+        return;
+    }
+
+    uint32_t state = SCHED_LOCK();
+    sched_ready |= (1uL << priority);
+    SCHED_UNLOCK(state);
+}
+
+/**
+ * @brief Runs the highest ready task
+ * @return 1 if a task ran
+*/
+uint8_t sched_run_once(void) {
+    uint32_t ready = sched_ready;
+
+    if (ready == 0u) {
+        return 0u;
+    }
+
+    uint8_t priority = (uint8_t)(31u - SCHED_CLZ(ready));
+    uint32_t state = SCHED_LOCK();
+    sched_ready &= ~(1uL << priority);  /* a post from here on runs the task again */
+    SCHED_UNLOCK(state);
+
+    if (sched_tasks[priority] != 0) {
+        sched_tasks[priority]();
+    }
+    return 1u;
+}
+
+/**
+ * @brief Sleeps until the next interrupt unless a task is ready
+*/
+void sched_idle(void) {
+    uint32_t state = SCHED_LOCK();
+
+    if (sched_ready == 0u) {
+        sched_sleep_count++;
+        SCHED_WAIT();   /* the pending interrupt runs once PRIMASK is restored */
+    }
+    SCHED_UNLOCK(state);
+}
+
+/**
+ * @brief Gets the number of times the core slept
+ * @return Sleep counter
+*/
+uint32_t sched_sleeps(void) {
+    return sched_sleep_count;
+}
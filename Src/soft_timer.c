@@ -0,0 +1,138 @@
+/**
+ * @file: soft_timer.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the software timer wheel.
+ *
+ * A timer sits in slot (expiry & SOFT_TIMER_WHEEL_MASK) whatever the number
+ * of turns still ahead of it, so every tick scans one slot and fires only the
+ * timers whose expiry equals that tick. Due timers are taken out one at a
+ * time, before their callback runs, so a callback may freely start or stop
+ * timers of the slot being scanned.
+*/
+
+#include "soft_timer.h"
+
+static Soft_Timer_Type* wheel[SOFT_TIMER_WHEEL_SIZE];
+static uint32_t current_tick = 0u;     /* last tick processed by soft_timer_poll() */
+
+
+static void wheel_insert(Soft_Timer_Type* timer) {
+    Soft_Timer_Type** slot = &wheel[timer->expiry & SOFT_TIMER_WHEEL_MASK];
+
+    timer->next = *slot;
+    *slot = timer;
+    timer->active = 1u;
+}
+
+static void wheel_remove(Soft_Timer_Type* timer) {
+    Soft_Timer_Type** link_to = &wheel[timer->expiry & SOFT_TIMER_WHEEL_MASK];
+
+    while (*link_to != NULL) {
+        if (*link_to == timer) {
+            *link_to = timer->next;
+            break;
+        }
+        link_to = &(*link_to)->next;
+    }
+    timer->next = NULL;
+    timer->active = 0u;
+}
+
+// Takes the first timer of the slot of tick that expires at tick out of the wheel
+static Soft_Timer_Type* take_due(uint32_t tick) {
+    Soft_Timer_Type** link_to = &wheel[tick & SOFT_TIMER_WHEEL_MASK];
+
+    while (*link_to != NULL) {
+        Soft_Timer_Type* timer = *link_to;
+        if (timer->expiry == tick) {
+            *link_to = timer->next;
+            timer->next = NULL;
+            timer->active = 0u;
+            return timer;
+        }
+        link_to = &timer->next;
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Empties the wheel
+ * @param now_ms Current time
+*/
+void soft_timer_init(uint32_t now_ms) {
+    for (uint32_t i = 0; i < SOFT_TIMER_WHEEL_SIZE; i++) {
+        wheel[i] = NULL;
+    }
+    current_tick = now_ms;
+}
+
+/**
+ * @brief Arms a timer
+ * @param timer Timer storage
+ * @param delay_ms Delay to the first expiry
+ * @param period_ms Reload, 0 for one-shot
+ * @param callback Function run on expiry
+ * @param context Passed to callback
+*/
+void soft_timer_start(Soft_Timer_Type* timer, uint32_t delay_ms, uint32_t period_ms, Soft_Timer_Callback callback, void* context) {
+    if (timer->active) {
+        wheel_remove(timer);
+    }
+
+    timer->expiry = current_tick + ((delay_ms == 0u)? 1u: delay_ms);   /* the current tick is already processed */
+    timer->period = period_ms;
+    timer->callback = callback;
+    timer->context = context;
+    wheel_insert(timer);
+}
+
+/**
+ * @brief Disarms a timer
+ * @param timer Timer to stop
+*/
+void soft_timer_stop(Soft_Timer_Type* timer) {
+    if (timer->active) {
+        wheel_remove(timer);
+    }
+}
+
+/**
+ * @brief Runs every timer that expired up to now
+ * @param now_ms Current time
+ * @return Number of callbacks run
+ *
+ * Ticks are processed one by one, so a late call runs the missed expiries
+ * in order, periodic ones included.
+*/
+uint32_t soft_timer_poll(uint32_t now_ms) {
+    uint32_t fired = 0u;
+
+    while (current_tick != now_ms) {
+        uint32_t tick = current_tick + 1u;
+        Soft_Timer_Type* timer;
+
+        current_tick = tick;    /* timers started by callbacks count from this tick */
+        while ((timer = take_due(tick)) != NULL) {
+            if (timer->period != 0u) {
+                timer->expiry = tick + timer->period;
+                wheel_insert(timer);
+            }
+            timer->callback(timer->context);
+            fired++;
+        }
+    }
+
+    return fired;
+}
+
+/**
+ * @brief Checks whether a timer is armed
+ * @param timer Timer to query
+ * @return 1 if active
+*/
+uint8_t soft_timer_active(const Soft_Timer_Type* timer) {
+    return timer->active;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file: strobe.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the trigger pulse output: TIM3 in one-pulse mode,
+ * started by the TRGO of TIM2, draws one pulse on CH2 per ADC trigger.
+*/
+
+
+#include "strobe.h"
+
+
+#define STROBE_TIMER        TIM3
+#define TIM3_MAX_TICKS      0x10000uLL                  /* 16-bit counter */
+#define NS_PER_SECOND       1000000000uLL
+
+// TIM3_SMCR: trigger input ITR1 (TIM2 TRGO), slave mode 110 (trigger mode, the trigger sets CEN)
+#define TIM3_SMCR_TS_ITR1       (TIM_SMCR_TS_0)
+#define TIM_SMCR_SMS_TRIGGER    (TIM_SMCR_SMS_2 | TIM_SMCR_SMS_1)
+
+// TIM_CCMR1 OC2M = 111: PWM mode 2, active once CNT >= CCR2
+#define TIM_CCMR1_OC2M_PWM2     (TIM_CCMR1_OC2M_2 | TIM_CCMR1_OC2M_1 | TIM_CCMR1_OC2M_0)
+#define TIM_CCMR1_OC2M_FORCE_LOW (TIM_CCMR1_OC2M_2)    /* 100: forced inactive */
+
+// Counter settings of one pulse
+typedef struct {
+	uint32_t prescaler;		/* PSC */
+	uint32_t compare;		/* CCR2, ticks from the trigger to the rising edge */
+	uint32_t high;			/* ticks from the rising to the falling edge, ARR = compare + high - 1 */
+} Strobe_Timing_Type;
+
+static uint8_t strobe_active = 0u;
+static uint64_t strobe_span_ns = 0u;	/* phase + width of the running pulse */
+
+
+/* Rounds a duration to timer ticks */
+static uint64_t ns_to_ticks(uint32_t ns) {
+	return (((uint64_t)ns * STROBE_TIMER_FREQ) + (NS_PER_SECOND / 2u)) / NS_PER_SECOND;
+}
+
+/* Converts timer ticks back to ns */
+static uint32_t ticks_to_ns(uint64_t ticks) {
+	return (uint32_t)(((ticks * NS_PER_SECOND) + (STROBE_TIMER_FREQ / 2u)) / STROBE_TIMER_FREQ);
+}
+
+
+/* Rounds a pulse to counter settings and writes back the actual width and phase */
+static uint8_t get_timing(uint32_t* width_ns, uint32_t* phase_ns, Strobe_Timing_Type* timing) {
+	uint64_t width = ns_to_ticks(*width_ns);
+	uint64_t phase = ns_to_ticks(*phase_ns);
+
+	if (*width_ns == 0u) {
+		return 0u;
+	}
+	width = (width == 0u)? 1u: width;
+	phase = (phase == 0u)? 1u: phase;	/* CCR2 = 0 would leave the output high once stopped */
+
+	// smallest prescaler that lets phase + width fit in the counter
+	uint64_t prescaler = (phase + width - 1u) / TIM3_MAX_TICKS;
+	if (prescaler > 0xFFFFu) {
+		return 0u;
+	}
+
+	uint32_t compare = (uint32_t)(phase / (prescaler + 1u));
+	uint32_t high = (uint32_t)(width / (prescaler + 1u));
+	compare = (compare == 0u)? 1u: compare;
+	high = (high == 0u)? 1u: high;
+	if ((compare + high - 1u) >= TIM3_MAX_TICKS) {
+		return 0u;	/* rounding pushed the end past the counter */
+	}
+
+	timing->prescaler = (uint32_t)prescaler;
+	timing->compare = compare;
+	timing->high = high;
+	*phase_ns = ticks_to_ns((uint64_t)compare * (prescaler + 1u));
+	*width_ns = ticks_to_ns((uint64_t)high * (prescaler + 1u));
+	return 1u;
+}
+
+
+/**
+ * @brief Rounds a pulse as strobe_start() would, without touching the timer
+ * @param width_ns Requested width, replaced by the actual one
+ * @param phase_ns Requested delay after the trigger, replaced by the actual one
+ * @return 1 if the pulse can be produced, 0 otherwise
+*/
+uint8_t strobe_round(uint32_t* width_ns, uint32_t* phase_ns) {
+	Strobe_Timing_Type timing;
+
+	return get_timing(width_ns, phase_ns, &timing);
+}
+
+/**
+ * @brief Starts emitting one pulse per TIM2 trigger event
+ * @param width_ns Requested width, replaced by the actual one
+ * @param phase_ns Requested delay after the trigger, replaced by the actual one
+ * @return 1 if running, 0 if the pulse cannot be produced
+*/
+uint8_t strobe_start(uint32_t* width_ns, uint32_t* phase_ns) {
+	Strobe_Timing_Type timing;
+
+	if (!get_timing(width_ns, phase_ns, &timing)) {
+		return 0u;
+	}
+
+	strobe_stop();
+
+	GPIOx_init(GPIOx_PIN_PORT(STROBE_PIN));
+	GPIOx_config_mode(STROBE_PIN, MODER_AF);
+	GPIOx_config_output_speed(STROBE_PIN, OSPEEDR_HIGH);	/* edges well under one tick */
+	GPIOx_config_alternate_function(STROBE_PIN, STROBE_AF);
+
+	STROBE_TIMER->PSC = timing.prescaler;
+	STROBE_TIMER->CCR2 = timing.compare;
+	STROBE_TIMER->ARR = timing.compare + timing.high - 1u;	/* CH2 is high for CNT in [CCR2, ARR] */
+	STROBE_TIMER->CCMR1 = (STROBE_TIMER->CCMR1 & ~(TIM_CCMR1_CC2S | TIM_CCMR1_OC2M)) | TIM_CCMR1_OC2M_PWM2;
+	STROBE_TIMER->CNT = 0;
+	STROBE_TIMER->EGR = TIM_EGR_UG;		/* load PSC now, the counter stays stopped */
+	STROBE_TIMER->SR = 0;
+	STROBE_TIMER->CCER = (STROBE_TIMER->CCER & ~TIM_CCER_CC2P) | TIM_CCER_CC2E;	/* active high */
+	STROBE_TIMER->CR1 = TIM_CR1_OPM;	/* the update at ARR clears CEN */
+	STROBE_TIMER->SMCR = TIM3_SMCR_TS_ITR1 | TIM_SMCR_SMS_TRIGGER;
+
+	strobe_span_ns = (uint64_t)*phase_ns + *width_ns;
+	strobe_active = 1u;
+	return 1u;
+}
+
+/**
+ * @brief Stops emitting pulses
+*/
+void strobe_stop(void) {
+	RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+
+	STROBE_TIMER->SMCR = 0;		/* triggers no longer start the counter */
+	STROBE_TIMER->CR1 = 0;
+	STROBE_TIMER->CCMR1 = (STROBE_TIMER->CCMR1 & ~TIM_CCMR1_OC2M) | TIM_CCMR1_OC2M_FORCE_LOW;	/* pulse cut short, pin held low */
+	strobe_active = 0u;
+	strobe_span_ns = 0u;
+}
+
+/**
+ * @brief Checks whether pulses are being emitted
+ * @return 1 if running
+*/
+uint8_t strobe_running(void) {
+	return strobe_active;
+}
+
+/**
+ * @brief Gets the time from a trigger to the end of its pulse
+ * @return Actual phase + width in ns, 0 when stopped
+*/
+uint64_t strobe_get_span_ns(void) {
+	return strobe_span_ns;
+}
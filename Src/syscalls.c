@@ -68,6 +68,8 @@ void ITM_SendChar(uint8_t ch)
 extern int errno;
 extern int __io_putchar(int ch) __attribute__((weak));
 extern int __io_getchar(void) __attribute__((weak));
+extern uint32_t USART2_dma_write(const char* data, uint32_t length); /* from usart.h, whose core_cm4.h
+																	  clashes with ITM_SendChar() above */
 
 register char * stack_ptr asm("sp");
 
@@ -109,15 +111,11 @@ __attribute__((weak)) int _read(int file, char *ptr, int len)
 return len;
 }
 
+/* printf() output is queued on the USART2 DMA ping-pong buffers and never
+   waits for the line; bytes that do not fit are counted by USART2_tx_dropped() */
 __attribute__((weak)) int _write(int file, char *ptr, int len)
 {
-	int DataIdx;
-
-	for (DataIdx = 0; DataIdx < len; DataIdx++)
-	{
-		__io_putchar(*ptr++);
-//		ITM_SendChar(*ptr++);
-	}
+	USART2_dma_write(ptr, (uint32_t)len);
 	return len;
 }
 
@@ -0,0 +1,152 @@
+/**
+ * @file: telemetry.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements encoding and decoding of binary telemetry frames.
+ * It touches no peripheral, so the Linux-side decoder in tools/ builds it
+ * unchanged.
+*/
+
+#include "telemetry.h"
+#include "crc16.h"
+
+
+// Writes a little-endian 16-bit value
+static void put_u16(uint8_t* destination, uint16_t value) {
+    destination[0] = (uint8_t)value;
+    destination[1] = (uint8_t)(value >> 8);
+}
+
+// Writes a little-endian 32-bit value
+static void put_u32(uint8_t* destination, uint32_t value) {
+    put_u16(&destination[0], (uint16_t)value);
+    put_u16(&destination[2], (uint16_t)(value >> 16));
+}
+
+// Reads a little-endian 16-bit value
+static uint16_t get_u16(const uint8_t* source) {
+    return (uint16_t)(source[0] | (source[1] << 8));
+}
+
+// Reads a little-endian 32-bit value
+static uint32_t get_u32(const uint8_t* source) {
+    return get_u16(&source[0]) | ((uint32_t)get_u16(&source[2]) << 16);
+}
+
+
+/**
+ * @brief Builds a complete frame
+ * @param header Packet fields
+ * @param samples Samples to carry
+ * @param frame Destination buffer
+ * @return Frame length, delimiter included
+*/
+uint32_t telemetry_encode_frame(const Telemetry_Header_Type* header, const uint16_t* samples, uint8_t* frame) {
+    uint8_t packet[TELEMETRY_MAX_PACKET_LENGTH];
+    uint32_t count = (header->num_of_samples > TELEMETRY_MAX_SAMPLES)? TELEMETRY_MAX_SAMPLES: header->num_of_samples;
+    uint32_t length = TELEMETRY_HEADER_LENGTH;
+    uint32_t data_length = 0;
+
+    // only keep the compressed block if it beats the packed one
+    if ((header->type == TELEMETRY_TYPE_DELTA) && (count != 0u)) {
+        data_length = delta_encode(samples, count, &packet[length], PACK12_LENGTH(count) - 1u);
+    }
+    if (header->type == TELEMETRY_TYPE_WIDE16) {
+        packet[0] = TELEMETRY_TYPE_WIDE16;
+        packet[length] = (header->bits < TELEMETRY_BASE_BITS)? TELEMETRY_BASE_BITS:
+                         (header->bits > TELEMETRY_MAX_BITS)? TELEMETRY_MAX_BITS: header->bits;
+        for (uint32_t i = 0; i < count; i++) {
+            put_u16(&packet[length + 1u + (2u * i)], samples[i]);
+        }
+        data_length = TELEMETRY_WIDE16_LENGTH(count);
+    } else if (data_length != 0u) {
+        packet[0] = TELEMETRY_TYPE_DELTA;
+    } else {
+        packet[0] = TELEMETRY_TYPE_PACKED12;
+        data_length = pack12(samples, count, &packet[length]);
+    }
+
+    put_u16(&packet[1], header->sequence);
+    put_u32(&packet[3], header->timestamp);
+    put_u16(&packet[7], header->channel_mask);
+    packet[9] = (uint8_t)count;
+
+    length += data_length;
+    put_u16(&packet[length], crc16_ccitt(packet, length));
+    length += TELEMETRY_CRC_LENGTH;
+
+    length = cobs_encode(packet, length, frame);
+    frame[length++] = COBS_DELIMITER;
+
+    return length;
+}
+
+/**
+ * @brief Parses a received frame
+ * @param frame Encoded bytes without delimiter
+ * @param length Number of encoded bytes
+ * @param header Destination of the packet fields
+ * @param samples Destination of the samples
+ * @return 1 if valid, 0 otherwise
+*/
+uint8_t telemetry_decode_frame(const uint8_t* frame, uint32_t length, Telemetry_Header_Type* header, uint16_t* samples) {
+    uint8_t packet[TELEMETRY_MAX_FRAME_LENGTH];
+
+    if (length > sizeof(packet)) {
+        return 0;
+    }
+
+    uint32_t packet_length = cobs_decode(frame, length, packet);
+    if (packet_length < (TELEMETRY_HEADER_LENGTH + TELEMETRY_CRC_LENGTH)) {
+        return 0;
+    }
+
+    uint32_t data_length = packet_length - TELEMETRY_CRC_LENGTH;
+    if (crc16_ccitt(packet, data_length) != get_u16(&packet[data_length])) {
+        return 0;
+    }
+
+    header->type = packet[0];
+    header->sequence = get_u16(&packet[1]);
+    header->timestamp = get_u32(&packet[3]);
+    header->channel_mask = get_u16(&packet[7]);
+    header->num_of_samples = packet[9];
+    header->bits = TELEMETRY_BASE_BITS;
+
+    if (header->num_of_samples > TELEMETRY_MAX_SAMPLES) {
+        return 0;
+    }
+
+    uint8_t* data = &packet[TELEMETRY_HEADER_LENGTH];
+    data_length -= TELEMETRY_HEADER_LENGTH;
+
+    switch (header->type) {
+    case TELEMETRY_TYPE_PACKED12:
+        if (data_length != PACK12_LENGTH(header->num_of_samples)) {
+            return 0;
+        }
+        unpack12(data, header->num_of_samples, samples);
+        return 1;
+
+    case TELEMETRY_TYPE_DELTA:
+        return delta_decode(data, data_length, header->num_of_samples, samples);
+
+    case TELEMETRY_TYPE_WIDE16:
+        if ((data_length != TELEMETRY_WIDE16_LENGTH(header->num_of_samples)) ||
+            (data[0] < TELEMETRY_BASE_BITS) || (data[0] > TELEMETRY_MAX_BITS)) {
+            return 0;
+        }
+        header->bits = data[0];
+        for (uint32_t i = 0; i < header->num_of_samples; i++) {
+            samples[i] = get_u16(&data[1u + (2u * i)]);
+            if ((samples[i] >> header->bits) != 0u) {
+                return 0;
+            }
+        }
+        return 1;
+
+    default:
+        return 0;
+    }
+}
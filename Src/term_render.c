@@ -0,0 +1,170 @@
+/**
+ * @file: term_render.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * This file implements the retained-mode terminal renderer.
+ *
+ * Changed cells are found row by row. Reaching one costs a cursor move
+ * (ESC[r;cH, 6 to 8 bytes) unless it directly follows the last cell sent;
+ * short runs of unchanged cells in the current color are resent instead,
+ * which is cheaper than jumping over them.
+ *
+ * Other output (command replies) may move the cursor between two renders,
+ * so every render starts with an absolute move; the color is only changed
+ * by the renderer and stays tracked.
+*/
+
+#include "term_render.h"
+#include "fmt.h"
+
+#define TERM_CLEAR          "\033[H\033[J\033[?25l"   /* home, clear, hide cursor */
+#define TERM_MAX_SKIP       4u                          /* resend up to this many unchanged cells */
+
+static const char* const term_color_codes[TERM_COLOR_COUNT] = {
+    [TERM_COLOR_NORMAL]     = "\x1B[0m",
+    [TERM_COLOR_CYAN]       = "\x1B[0;96m",
+    [TERM_COLOR_BOLD_RED]   = "\x1B[1;91m",
+    [TERM_COLOR_BOLD_GREEN] = "\x1B[1;92m",
+    [TERM_COLOR_BOLD_BLUE]  = "\x1B[1;94m",
+    [TERM_COLOR_BOLD_WHITE] = "\x1B[1;97m",
+};
+
+
+static void fill_screen(Term_Screen_Type* screen) {
+    for (uint32_t row = 0; row < TERM_ROWS; row++) {
+        for (uint32_t col = 0; col < TERM_COLS; col++) {
+            screen->chars[row][col] = ' ';
+            screen->colors[row][col] = TERM_COLOR_NORMAL;
+        }
+    }
+}
+
+static uint8_t cell_changed(const Term_Render_Type* term, uint32_t row, uint32_t col) {
+    return (term->back.chars[row][col] != term->front.chars[row][col]) ||
+           (term->back.colors[row][col] != term->front.colors[row][col]);
+}
+
+// Columns from col until the next changed cell of the row, TERM_COLS - col if none
+static uint32_t distance_to_change(const Term_Render_Type* term, uint32_t row, uint32_t col) {
+    uint32_t distance = 0;
+
+    while (((col + distance) < TERM_COLS) && !cell_changed(term, row, col + distance)) {
+        distance++;
+    }
+    return distance;
+}
+
+// Whether the cells [col, col + count) can be resent without a color change
+static uint8_t same_color_run(const Term_Render_Type* term, uint32_t row, uint32_t col, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (term->back.colors[row][col + i] != term->color) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/**
+ * @brief Blanks both screens and schedules a terminal clear
+ * @param term Renderer to initialize
+*/
+void term_init(Term_Render_Type* term) {
+    fill_screen(&term->back);
+    fill_screen(&term->front);
+    term->front_valid = 0;
+    term->cursor_row = 0;
+    term->cursor_col = 0;
+    term->color = TERM_COLOR_NORMAL;
+}
+
+/**
+ * @brief Draws text into the back screen
+ * @param term Renderer
+ * @param row Row of the first character
+ * @param col Column of the first character
+ * @param text Text to draw
+ * @param color Color of the text
+*/
+void term_put_text(Term_Render_Type* term, uint8_t row, uint8_t col, const char* text, uint8_t color) {
+    if ((row >= TERM_ROWS) || (color >= TERM_COLOR_COUNT)) {
+        return;
+    }
+
+    for (uint32_t c = col; (c < TERM_COLS) && (*text != '\0'); c++, text++) {
+        term->back.chars[row][c] = *text;
+        term->back.colors[row][c] = color;
+    }
+}
+
+/**
+ * @brief Emits the difference between the back screen and the terminal
+ * @param term Renderer
+ * @param output Destination buffer
+ * @param size Size of the destination
+ * @return Bytes written
+*/
+uint32_t term_render(Term_Render_Type* term, char* output, uint32_t size) {
+    Fmt_Buffer_Type out;
+
+    if (size < TERM_MIN_OUTPUT_SIZE) {
+        return 0;
+    }
+
+    fmt_init(&out, output, size);
+
+    if (!term->front_valid) {
+        fmt_str(&out, TERM_CLEAR, 0u, 0u);
+        fmt_color(&out, term_color_codes[TERM_COLOR_NORMAL]);
+        fill_screen(&term->front);
+        term->front_valid = 1;
+        term->cursor_row = 0;
+        term->cursor_col = 0;
+        term->color = TERM_COLOR_NORMAL;
+    }
+
+    term->cursor_row = TERM_ROWS;   /* unknown, force a move before the first cell */
+
+    for (uint32_t row = 0; row < TERM_ROWS; row++) {
+        uint32_t col = distance_to_change(term, row, 0);
+
+        while (col < TERM_COLS) {
+            // worst case for this cell: move, color and the character
+            if ((out.length + TERM_MIN_OUTPUT_SIZE) > size) {
+                return out.length;
+            }
+
+            uint32_t gap = col - term->cursor_col;
+            if ((term->cursor_row == row) && (col >= term->cursor_col) && (gap <= TERM_MAX_SKIP) &&
+                same_color_run(term, row, term->cursor_col, gap)) {
+                // bridge a short unchanged run by resending it
+                for (uint32_t c = term->cursor_col; c < col; c++) {
+                    fmt_char(&out, term->back.chars[row][c]);
+                }
+            } else {
+                fmt_str(&out, "\033[", 0u, 0u);
+                fmt_u32(&out, row + 1u, 0u, 0u);
+                fmt_char(&out, ';');
+                fmt_u32(&out, col + 1u, 0u, 0u);
+                fmt_char(&out, 'H');
+            }
+
+            uint8_t color = term->back.colors[row][col];
+            if (color != term->color) {
+                fmt_color(&out, term_color_codes[color]);
+                term->color = color;
+            }
+
+            fmt_char(&out, term->back.chars[row][col]);
+            term->front.chars[row][col] = term->back.chars[row][col];
+            term->front.colors[row][col] = color;
+            term->cursor_row = (uint8_t)row;
+            term->cursor_col = (uint8_t)(col + 1u);
+
+            col += 1u + distance_to_change(term, row, col + 1u);
+        }
+    }
+
+    return out.length;
+}
@@ -9,6 +9,41 @@
 */
 
 #include "usart.h"
+#include "hw_poll.h"
+
+#define ASSERT assert
+
+#define USART2_TX_DMA_FLAG_OFFSET   16u     // stream 6 flags inside DMA1 HISR/HIFCR
+#define USART2_TX_DMA_FLAGS_ALL     (0x3Du << USART2_TX_DMA_FLAG_OFFSET)
+
+// Ping-pong transmit buffers: the application fills one while the DMA drains the other
+static char tx_buffers[2][USART2_TX_BUFFER_SIZE];
+static volatile uint8_t tx_fill_index = 0;      // buffer the application writes into
+static volatile uint32_t tx_fill_length = 0;    // bytes waiting in the fill buffer
+static volatile uint8_t tx_reserved = 0;        // application holds a reservation in the fill buffer
+static volatile uint8_t tx_dma_busy = 0;        // DMA is draining the other buffer
+static volatile uint8_t tx_initialized = 0;
+static volatile uint32_t tx_dropped = 0;
+static volatile USART2_Event_Callback tx_callback = NULL;  // told when a buffer has drained
+
+#define USART2_RX_MASK              (USART2_RX_BUFFER_SIZE - 1u)
+
+#if (USART2_RX_BUFFER_SIZE & USART2_RX_MASK) != 0
+#error "USART2_RX_BUFFER_SIZE must be a power of two"
+#endif
+
+// Receive ring: head is only written by USART2_IRQHandler, tail only by the application
+static uint8_t rx_buffer[USART2_RX_BUFFER_SIZE];
+static volatile uint32_t rx_head = 0;           // bytes received so far
+static volatile uint32_t rx_tail = 0;           // bytes consumed so far
+static volatile uint32_t rx_idle_mark = 0;      // rx_head when the line last went idle
+static volatile uint32_t rx_dropped = 0;
+static volatile uint8_t rx_initialized = 0;
+static char rx_line[USART2_RX_LINE_SIZE];       // line being assembled by USART2_read_line()
+static uint32_t rx_line_length = 0;
+static volatile USART2_Event_Callback rx_callback = NULL;  // told when a byte has been queued
+
+#define RX_BARRIER() __asm volatile ("" ::: "memory")
 
 /**
  * @brief Initialize UART2 and configure related GPIO pins
@@ -67,7 +102,7 @@ void USART2_set_word_length(uint8_t length) {
  * This function enables the transmitter for USART2.
 */
 void USART2_enable_transmitter(void) {
-    USART2->CR1 |= (1 << PA2);
+    USART2->CR1 |= USART_CR1_TE;
 }
 
 /**
@@ -76,7 +111,7 @@ void USART2_enable_transmitter(void) {
  * This function enables the receiver for USART2.
 */
 void USART2_enable_receiver(void) {
-    USART2->CR1 |= (1 << PA3);
+    USART2->CR1 |= USART_CR1_RE;
 }
 
 /**
@@ -85,7 +120,43 @@ void USART2_enable_receiver(void) {
  * This function sets the default baud rate (115200) for USART2.
 */
 void USART2_set_default_baud_rate(void) {
-    USART2->BRR = (7 << 0) | (24 << 4);
+    USART2_set_baud_rate(USART2_DEFAULT_BAUD_RATE, NULL);
+}
+
+/**
+ * @brief Set the USART2 baud rate
+ * @param baud_rate Requested rate in bit/s
+ * @param error_ppm Optional destination of the rate error in ppm
+ * @return Actual baud rate
+ *
+ * With either oversampling the rate is PCLK1 / divider, where the divider is
+ * USARTDIV in 1/16 (OVER16) or 1/8 (OVER8) steps. The divider is rounded to
+ * the nearest step and split into BRR mantissa and fraction; in OVER8 mode
+ * the fraction is 3 bits wide and BRR bit 3 stays clear.
+*/
+uint32_t USART2_set_baud_rate(uint32_t baud_rate, int32_t* error_ppm) {
+    ASSERT((baud_rate >= USART2_MIN_BAUD_RATE) && (baud_rate <= USART2_MAX_BAUD_RATE));
+
+    uint32_t divider = (APB1_FREQ + (baud_rate / 2u)) / baud_rate;
+    uint8_t over8 = (divider < 16u);
+    uint32_t fraction_bits = over8? 3u: 4u;
+    uint32_t brr = ((divider >> fraction_bits) << 4) | (divider & ((1u << fraction_bits) - 1u));
+    uint32_t actual = APB1_FREQ / divider;
+
+    uint32_t enabled = USART2->CR1 & USART_CR1_UE;
+    USART2->CR1 &= ~USART_CR1_UE;     // OVER8 may only change while the USART is disabled
+    if (over8)
+        USART2->CR1 |= USART_CR1_OVER8;
+    else
+        USART2->CR1 &= ~USART_CR1_OVER8;
+    USART2->BRR = brr;
+    USART2->CR1 |= enabled;
+
+    if (error_ppm != NULL) {
+        *error_ppm = (int32_t)((((int64_t)actual - (int64_t)baud_rate) * 1000000) / (int64_t)baud_rate);
+    }
+
+    return actual;
 }
 
 /**
@@ -116,7 +187,7 @@ void USART2_quick_default_config(void) {
 */
 void UART2_sendChar(uint32_t c) {
     USART2->DR = c; // Load the data into the data register
-    while (!(USART2->SR & (1 << 6))); // Wait until transmission is complete
+    while (HW_POLL(!(USART2->SR & (1 << 6)))); // Wait until transmission is complete
 }
 
 /**
@@ -139,7 +210,13 @@ void UART2_sendString(char *string) {
  * This function waits for a character to be received on UART2 and returns it.
 */
 uint8_t UART2_getchar(void) {
-    while (!(USART2->SR & (1 << 5))); // Wait until data is received
+    if (rx_initialized) {
+        uint8_t c;
+        while (HW_POLL(!USART2_rx_pop(&c))); // Wait until the interrupt has queued a byte
+        return c;
+    }
+
+    while (HW_POLL(!(USART2->SR & (1 << 5)))); // Wait until data is received
     return USART2->DR;
 }
 
@@ -163,4 +240,316 @@ void UART2_getString(char string[], uint32_t input_size) {
         }
         UART2_sendChar(string[i]); // Echo back the received character
     }
-}
\ No newline at end of file
+}
+
+// Start draining the fill buffer if the DMA is idle. Caller must exclude the
+// DMA interrupt (either by being it or by masking interrupts).
+static void tx_kick(void) {
+    if (!tx_initialized || tx_dma_busy || tx_reserved || (tx_fill_length == 0)) {
+        return;
+    }
+
+    DMA1_Stream6->M0AR = (uint32_t)tx_buffers[tx_fill_index];
+    DMA1_Stream6->NDTR = tx_fill_length;
+    tx_fill_index ^= 1u;
+    tx_fill_length = 0;
+    tx_dma_busy = 1;
+
+    USART2->SR = ~USART_SR_TC;      // rc_w0: clear TC before the DMA starts feeding DR
+    DMA1_Stream6->CR |= DMA_SxCR_EN;
+}
+
+// tx_kick() from thread mode, with interrupts masked for a few instructions
+static void tx_kick_from_thread(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    tx_kick();
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Set up the DMA transmit path of USART2
+ *
+ * DMA1 Stream 6 Channel 4 moves bytes from memory to USART2->DR, one byte
+ * per TXE request, and raises a transfer-complete interrupt per buffer.
+*/
+void USART2_dma_tx_init(void) {
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+
+    DMA1_Stream6->CR &= ~DMA_SxCR_EN;
+    while (HW_POLL(DMA1_Stream6->CR & DMA_SxCR_EN));
+    DMA1->HIFCR = USART2_TX_DMA_FLAGS_ALL;
+
+    DMA1_Stream6->PAR = (uint32_t)&USART2->DR;
+    DMA1_Stream6->FCR = 0;              // direct mode
+    DMA1_Stream6->CR = DMA_SxCR_CHSEL_2 |   // channel 4: USART2_TX
+                       DMA_SxCR_MINC |
+                       DMA_SxCR_DIR_0 |     // memory to peripheral, 8-bit both sides
+                       DMA_SxCR_TCIE |
+                       DMA_SxCR_TEIE;
+
+    USART2->CR3 |= USART_CR3_DMAT;
+    NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+    tx_initialized = 1;
+}
+
+/**
+ * @brief Reserve space in the fill buffer
+ * @param length Number of bytes to be written
+ * @return Pointer into the fill buffer, or NULL if there is no room
+*/
+char* USART2_tx_reserve(uint32_t length) {
+    tx_reserved = 1;    // from here on the interrupt leaves the fill buffer alone
+
+    if ((tx_fill_length + length) > USART2_TX_BUFFER_SIZE) {
+        tx_reserved = 0;
+        tx_kick_from_thread();      // the buffer may be full only because the DMA went idle
+        tx_reserved = 1;
+        if ((tx_fill_length + length) > USART2_TX_BUFFER_SIZE) {
+            tx_reserved = 0;
+            return NULL;
+        }
+    }
+
+    return &tx_buffers[tx_fill_index][tx_fill_length];
+}
+
+/**
+ * @brief Commit the bytes written into a reservation
+ * @param length Number of bytes written
+*/
+void USART2_tx_commit(uint32_t length) {
+    tx_fill_length += length;
+    tx_reserved = 0;
+    tx_kick_from_thread();
+}
+
+/**
+ * @brief Queue bytes for DMA transmission
+ * @param data Bytes to send
+ * @param length Number of bytes
+ * @return Number of bytes queued
+*/
+uint32_t USART2_dma_write(const char* data, uint32_t length) {
+    uint32_t queued = 0;
+
+    while (queued < length) {
+        uint32_t chunk = length - queued;
+        if (chunk > USART2_TX_BUFFER_SIZE) {
+            chunk = USART2_TX_BUFFER_SIZE;
+        }
+
+        char* destination = USART2_tx_reserve(chunk);
+        if (destination == NULL) {
+            // take whatever still fits in the fill buffer, drop the rest
+            chunk = USART2_TX_BUFFER_SIZE - tx_fill_length;
+            if (chunk == 0) {
+                break;
+            }
+            destination = USART2_tx_reserve(chunk);
+            if (destination == NULL) {
+                break;
+            }
+        }
+
+        for (uint32_t i = 0; i < chunk; i++) {
+            destination[i] = data[queued + i];
+        }
+        USART2_tx_commit(chunk);
+        queued += chunk;
+    }
+
+    tx_dropped += length - queued;
+    return queued;
+}
+
+/**
+ * @brief Check whether a DMA transfer is in flight
+ * @return 1 if busy, 0 if idle
+*/
+uint8_t USART2_tx_busy(void) {
+    return tx_dma_busy;
+}
+
+/**
+ * @brief Get the number of dropped bytes
+ * @return Dropped byte counter
+*/
+uint32_t USART2_tx_dropped(void) {
+    return tx_dropped;
+}
+
+/**
+ * @brief ISR for DMA1 Stream 6 (USART2 TX)
+ *
+ * The drained buffer becomes free; whatever the application queued in the
+ * other buffer meanwhile is started straight away.
+*/
+void DMA1_Stream6_IRQHandler(void) {
+    uint32_t flags = DMA1->HISR & USART2_TX_DMA_FLAGS_ALL;
+    DMA1->HIFCR = flags;
+
+    if (flags & (DMA_HISR_TCIF6 | DMA_HISR_TEIF6)) {
+        tx_dma_busy = 0;
+        tx_kick();
+        if (tx_callback != NULL) {
+            tx_callback();
+        }
+    }
+}
+
+/**
+ * @brief Set the function called when a transmit buffer has drained
+ * @param callback Function called from the DMA interrupt, or NULL
+*/
+void USART2_set_tx_callback(USART2_Event_Callback callback) {
+    tx_callback = callback;
+}
+
+/**
+ * @brief Enable the interrupt-driven receive path
+ *
+ * RXNEIE queues every byte, IDLEIE marks the end of each burst.
+*/
+void USART2_rx_interrupt_init(void) {
+    rx_head = 0;
+    rx_tail = 0;
+    rx_idle_mark = 0;
+    rx_line_length = 0;
+    rx_initialized = 1;
+
+    (void)USART2->SR;   // SR then DR clears a stale RXNE/IDLE/ORE
+    (void)USART2->DR;
+    USART2->CR1 |= USART_CR1_RXNEIE | USART_CR1_IDLEIE;
+    NVIC_EnableIRQ(USART2_IRQn);
+}
+
+/**
+ * @brief Take one received byte
+ * @param c Destination of the byte
+ * @return 1 if a byte was taken, 0 if none was waiting
+*/
+uint8_t USART2_rx_pop(uint8_t* c) {
+    uint32_t tail = rx_tail;
+
+    if (rx_head == tail) {
+        return 0;
+    }
+
+    RX_BARRIER();   // head read before the byte it published
+    *c = rx_buffer[tail & USART2_RX_MASK];
+    RX_BARRIER();   // byte copied out before the slot is handed back
+    rx_tail = tail + 1u;
+
+    return 1;
+}
+
+/**
+ * @brief Number of received bytes waiting
+ * @return Bytes in the ring
+*/
+uint32_t USART2_rx_available(void) {
+    return rx_head - rx_tail;
+}
+
+/**
+ * @brief Assemble a line without waiting
+ * @param line Destination of the line
+ * @param size Size of the destination
+ * @return Length of the completed line, 0 if none yet
+*/
+uint32_t USART2_read_line(char* line, uint32_t size) {
+    uint8_t c;
+
+    while (USART2_rx_pop(&c)) {
+        if ((c == '\r') || (c == NEWLINE_CHARACTER)) {
+            if (rx_line_length == 0) {
+                continue;
+            }
+
+            uint32_t length = (rx_line_length < size)? rx_line_length: (size - 1u);
+            for (uint32_t i = 0; i < length; i++) {
+                line[i] = rx_line[i];
+            }
+            line[length] = NULL_CHARACTER;
+            rx_line_length = 0;
+            return length;
+        }
+
+        if (rx_line_length < (USART2_RX_LINE_SIZE - 1u)) {
+            rx_line[rx_line_length++] = (char)c;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Take the bytes of the last idle-delimited burst
+ * @param frame Destination of the bytes
+ * @param size Size of the destination
+ * @return Bytes copied, 0 if no complete burst is waiting
+*/
+uint32_t USART2_read_frame(uint8_t* frame, uint32_t size) {
+    uint32_t pending = rx_idle_mark - rx_tail;
+    uint32_t length = 0;
+
+    if ((int32_t)pending <= 0) {
+        return 0;   // nothing before the mark, or a line reader already consumed past it
+    }
+
+    while ((length < pending) && (length < size) && USART2_rx_pop(&frame[length])) {
+        length++;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Number of bytes lost on reception
+ * @return Dropped byte counter
+*/
+uint32_t USART2_rx_dropped(void) {
+    return rx_dropped;
+}
+
+/**
+ * @brief Set the function called when a received byte has been queued
+ * @param callback Function called from the USART2 interrupt, or NULL
+*/
+void USART2_set_rx_callback(USART2_Event_Callback callback) {
+    rx_callback = callback;
+}
+
+/**
+ * @brief USART2 interrupt: queue received bytes and mark idle lines
+*/
+void USART2_IRQHandler(void) {
+    uint32_t sr = USART2->SR;
+
+    if (sr & (USART_SR_RXNE | USART_SR_ORE)) {
+        uint8_t c = (uint8_t)USART2->DR;   // SR then DR clears RXNE, ORE and IDLE
+        uint32_t head = rx_head;
+
+        if (sr & USART_SR_ORE) {
+            rx_dropped++;   // a byte arrived before the previous one was read
+        }
+
+        if ((head - rx_tail) < USART2_RX_BUFFER_SIZE) {
+            rx_buffer[head & USART2_RX_MASK] = c;
+            RX_BARRIER();   // byte stored before the index that publishes it
+            rx_head = head + 1u;
+            if (rx_callback != NULL) {
+                rx_callback();
+            }
+        } else {
+            rx_dropped++;
+        }
+    } else if (sr & USART_SR_IDLE) {
+        (void)USART2->DR;   // completes the SR, DR sequence that clears IDLE
+    }
+
+    if (sr & USART_SR_IDLE) {
+        rx_idle_mark = rx_head;
+    }
+}
@@ -0,0 +1,283 @@
+/**
+ * @file: adc_stream_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/adc_stream.c. The ADC, DMA2 and RCC peripherals are
+ * replaced by plain structs so the register programming and the half/full
+ * transfer dispatch can be checked without a board.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -IInc -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast \
+ *       tests/adc_stream_test.c -o adc_stream_test && ./adc_stream_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "stm32f446xx.h"
+
+// simulated register block
+static ADC_TypeDef sim_adc[3];
+static ADC_Common_TypeDef sim_adc_common;
+static RCC_TypeDef sim_rcc;
+static DMA_TypeDef sim_dma2;
+static DMA_Stream_TypeDef sim_dma2_stream[8];
+static uint32_t sim_nvic_enabled;
+
+static void sim_nvic_enable(IRQn_Type irq) { sim_nvic_enabled |= (1u << (irq & 31)); }
+static void sim_nvic_disable(IRQn_Type irq) { sim_nvic_enabled &= ~(1u << (irq & 31)); }
+
+#undef ADC1
+#undef ADC2
+#undef ADC3
+#undef ADC
+#undef RCC
+#undef DMA2
+#undef DMA2_Stream0
+#undef DMA2_Stream1
+#undef DMA2_Stream2
+#undef NVIC_EnableIRQ
+#undef NVIC_DisableIRQ
+#define ADC1                (&sim_adc[0])
+#define ADC2                (&sim_adc[1])
+#define ADC3                (&sim_adc[2])
+#define ADC                 (&sim_adc_common)
+#define RCC                 (&sim_rcc)
+#define DMA2                (&sim_dma2)
+#define DMA2_Stream0        (&sim_dma2_stream[0])
+#define DMA2_Stream1        (&sim_dma2_stream[1])
+#define DMA2_Stream2        (&sim_dma2_stream[2])
+#define NVIC_EnableIRQ      sim_nvic_enable
+#define NVIC_DisableIRQ     sim_nvic_disable
+
+#include "../Src/adc_stream.c"
+
+// enable_adc_converter/start_conversion/get_regular_sequence_length live in
+// adc.c, which also pulls in the interrupt masking intrinsics; the ones
+// needed here are reproduced.
+void enable_adc_converter(ADC_TypeDef* ADCx) { ADCx->CR2 |= ADC_CR2_ADON; }
+void start_conversion(ADC_TypeDef* ADCx) { ADCx->CR2 |= ADC_CR2_SWSTART; }
+uint8_t get_regular_sequence_length(ADC_TypeDef* ADCx) { return ((ADCx->SQR1 & ADC_SQR1_L) >> ADC_SQR1_L_POS) + 1; }
+void set_channel_sample_time(ADC_TypeDef* ADCx, uint8_t channel, uint8_t sample_time) { (void)ADCx; (void)channel; (void)sample_time; }
+void set_regular_sequence(ADC_TypeDef* ADCx, uint8_t num_of_channels, uint8_t channels[]) {
+	ADCx->SQR1 = (uint32_t)(num_of_channels - 1) << ADC_SQR1_L_POS;
+	ADCx->SQR3 = channels[0];
+}
+
+
+#define TEST_LENGTH 8u
+
+static int failures = 0;
+static volatile uint16_t buffer[TEST_LENGTH];
+static volatile uint16_t* callback_samples[4];
+static uint32_t callback_counts[4];
+static uint32_t num_of_callbacks = 0;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static void on_samples(volatile uint16_t* samples, uint32_t num_of_samples) {
+	callback_samples[num_of_callbacks] = samples;
+	callback_counts[num_of_callbacks] = num_of_samples;
+	num_of_callbacks++;
+}
+
+static void test_start_programs_dma_and_adc(void) {
+	adc_stream_start(ADC1, buffer, TEST_LENGTH, on_samples);
+
+	CHECK(sim_rcc.AHB1ENR & RCC_AHB1ENR_DMA2EN);
+	CHECK(sim_dma2_stream[0].PAR == (uint32_t)&sim_adc[0].DR);
+	CHECK(sim_dma2_stream[0].M0AR == (uint32_t)buffer);
+	CHECK(sim_dma2_stream[0].NDTR == TEST_LENGTH);
+	CHECK((sim_dma2_stream[0].CR & DMA_SxCR_CHSEL) == 0u);
+	CHECK((sim_dma2_stream[0].CR & DMA_SxCR_DIR) == 0u);
+	CHECK(sim_dma2_stream[0].CR & DMA_SxCR_CIRC);
+	CHECK(sim_dma2_stream[0].CR & DMA_SxCR_MINC);
+	CHECK(sim_dma2_stream[0].CR & DMA_SxCR_HTIE);
+	CHECK(sim_dma2_stream[0].CR & DMA_SxCR_TCIE);
+	CHECK(sim_dma2_stream[0].CR & DMA_SxCR_EN);
+	CHECK((sim_dma2_stream[0].CR & DMA_SxCR_MSIZE) == DMA_SxCR_MSIZE_0);
+	CHECK((sim_dma2_stream[0].CR & DMA_SxCR_PSIZE) == DMA_SxCR_PSIZE_0);
+	CHECK(sim_nvic_enabled & (1u << (DMA2_Stream0_IRQn & 31)));
+
+	uint32_t cr2 = sim_adc[0].CR2;
+	CHECK(cr2 & ADC_CR2_DMA);
+	CHECK(cr2 & ADC_CR2_DDS);
+	CHECK(cr2 & ADC_CR2_CONT);
+	CHECK(cr2 & ADC_CR2_ADON);
+	CHECK(cr2 & ADC_CR2_SWSTART);
+}
+
+static void test_half_and_full_transfer_callbacks(void) {
+	num_of_callbacks = 0;
+
+	sim_dma2.LISR = DMA_LISR_HTIF0;
+	sim_dma2.LIFCR = 0;
+	DMA2_Stream0_IRQHandler();
+	CHECK(num_of_callbacks == 1);
+	CHECK(callback_samples[0] == &buffer[0]);
+	CHECK(callback_counts[0] == TEST_LENGTH / 2);
+	CHECK(sim_dma2.LIFCR == DMA_LIFCR_CHTIF0);
+
+	sim_dma2.LISR = DMA_LISR_TCIF0;
+	sim_dma2.LIFCR = 0;
+	DMA2_Stream0_IRQHandler();
+	CHECK(num_of_callbacks == 2);
+	CHECK(callback_samples[1] == &buffer[TEST_LENGTH / 2]);
+	CHECK(callback_counts[1] == TEST_LENGTH / 2);
+	CHECK(sim_dma2.LIFCR == DMA_LIFCR_CTCIF0);
+
+	// flags of the other streams must be left alone
+	sim_dma2.LISR = DMA_LISR_TCIF0 | (DMA_LISR_TCIF0 << 6);
+	sim_dma2.LIFCR = 0;
+	DMA2_Stream0_IRQHandler();
+	CHECK(sim_dma2.LIFCR == DMA_LIFCR_CTCIF0);
+	sim_dma2.LISR = 0;
+}
+
+static void test_latest_sample_follows_ndtr(void) {
+	for (uint32_t i = 0; i < TEST_LENGTH; i++) {
+		buffer[i] = (uint16_t)(100 + i);
+	}
+
+	sim_dma2_stream[0].NDTR = TEST_LENGTH;	/* nothing written since the wrap */
+	CHECK(adc_stream_get_write_index(ADC1) == 0);
+	CHECK(adc_stream_get_latest(ADC1) == 100 + TEST_LENGTH - 1);
+
+	sim_dma2_stream[0].NDTR = TEST_LENGTH - 3;
+	CHECK(adc_stream_get_write_index(ADC1) == 3);
+	CHECK(adc_stream_get_latest(ADC1) == 102);
+}
+
+static void test_other_adcs_use_their_streams(void) {
+	adc_stream_start(ADC2, buffer, TEST_LENGTH, on_samples);
+	CHECK((sim_dma2_stream[2].CR & DMA_SxCR_CHSEL) == DMA_SxCR_CHSEL_0);
+	CHECK(sim_dma2_stream[2].PAR == (uint32_t)&sim_adc[1].DR);
+
+	adc_stream_start(ADC3, buffer, TEST_LENGTH, on_samples);
+	CHECK((sim_dma2_stream[1].CR & DMA_SxCR_CHSEL) == DMA_SxCR_CHSEL_1);
+	CHECK(sim_dma2_stream[1].PAR == (uint32_t)&sim_adc[2].DR);
+
+	num_of_callbacks = 0;
+	sim_dma2.LISR = DMA_LISR_HTIF0 << 6;	/* stream 1 half transfer */
+	DMA2_Stream1_IRQHandler();
+	CHECK(num_of_callbacks == 1);
+	sim_dma2.LISR = 0;
+}
+
+static void test_external_trigger_is_not_overridden(void) {
+	sim_adc[0].CR2 = ADC_CR2_EXTEN_0;
+	adc_stream_start(ADC1, buffer, TEST_LENGTH, on_samples);
+
+	CHECK(sim_adc[0].CR2 & ADC_CR2_DMA);
+	CHECK((sim_adc[0].CR2 & ADC_CR2_CONT) == 0u);
+	CHECK((sim_adc[0].CR2 & ADC_CR2_SWSTART) == 0u);
+}
+
+static volatile uint16_t* frame_pointer;
+static uint32_t frame_count;
+static uint8_t frame_size;
+
+static void on_frames(volatile uint16_t* frames, uint32_t num_of_frames, uint8_t size) {
+	frame_pointer = frames;
+	frame_count = num_of_frames;
+	frame_size = size;
+}
+
+static void test_scan_frames(void) {
+	static volatile uint16_t frames[4 * 3];
+
+	sim_adc[0].CR2 = 0;
+	sim_adc[0].SQR1 = (3u - 1u) << ADC_SQR1_L_POS;	/* three ranks */
+	adc_scan_start(ADC1, frames, 4, on_frames);
+	CHECK(sim_dma2_stream[0].NDTR == 12);
+
+	sim_dma2.LISR = DMA_LISR_TCIF0;
+	DMA2_Stream0_IRQHandler();
+	CHECK(frame_pointer == &frames[6]);
+	CHECK(frame_count == 2);
+	CHECK(frame_size == 3);
+	sim_dma2.LISR = 0;
+	sim_adc[0].SQR1 = 0;
+}
+
+static void test_triple_interleaved_order(void) {
+	static volatile uint16_t samples[12];
+	volatile uint32_t* words = (volatile uint32_t*)samples;
+
+	for (int i = 0; i < 3; i++) {
+		sim_adc[i].CR2 = 0;
+	}
+	num_of_callbacks = 0;
+	adc_interleaved_start(1, samples, 12, ADC_INTERLEAVED_MIN_DELAY, on_samples);
+
+	CHECK((sim_adc_common.CCR & ADC_CCR_MULTI) == 0x17u);
+	CHECK((sim_adc_common.CCR & ADC_CCR_DELAY) == 0u);
+	CHECK((sim_adc_common.CCR & ADC_CCR_DMA) == ADC_CCR_DMA_1);
+	CHECK(sim_dma2_stream[0].PAR == (uint32_t)&sim_adc_common.CDR);
+	CHECK(sim_dma2_stream[0].NDTR == 6);
+	CHECK((sim_dma2_stream[0].CR & DMA_SxCR_MSIZE) == DMA_SxCR_MSIZE_1);
+	CHECK((sim_dma2_stream[0].CR & DMA_SxCR_PSIZE) == DMA_SxCR_PSIZE_1);
+	CHECK((sim_adc[0].CR2 & ADC_CR2_DMA) == 0u);
+	for (int i = 0; i < 3; i++) {
+		CHECK(sim_adc[i].CR2 & ADC_CR2_CONT);
+		CHECK(sim_adc[i].SQR3 == 1u);
+	}
+	CHECK(sim_adc[0].CR2 & ADC_CR2_SWSTART);
+
+	// the n-th conversion of ADCk reads k * 1000 + n; DMA mode 2 sends them
+	// as ADC2|ADC1, ADC1|ADC3, ADC3|ADC2 words (high|low, RM0390 triple mode)
+	static const uint8_t word_adcs[3][2] = { {1, 2}, {3, 1}, {2, 3} };	/* {low, high} */
+	uint32_t next_conversion[4] = {0, 0, 0, 0};
+	for (uint32_t i = 0; i < 6; i++) {
+		const uint8_t* adcs = word_adcs[i % 3];
+		uint32_t low = adcs[0] * 1000u + next_conversion[adcs[0]]++;
+		uint32_t high = adcs[1] * 1000u + next_conversion[adcs[1]]++;
+		words[i] = (high << 16) | low;
+	}
+	sim_dma2.LISR = DMA_LISR_HTIF0 | DMA_LISR_TCIF0;
+	DMA2_Stream0_IRQHandler();
+	CHECK(num_of_callbacks == 2);
+	CHECK(callback_counts[0] == 6 && callback_counts[1] == 6);
+	CHECK(callback_samples[1] == &samples[6]);
+	for (uint32_t i = 0; i < 12; i++) {
+		CHECK(samples[i] == ((i % 3) + 1u) * 1000u + (i / 3));	/* ADC1, ADC2, ADC3, ADC1, ... */
+	}
+	sim_dma2.LISR = 0;
+
+	sim_dma2_stream[0].NDTR = 4;	/* two words written */
+	CHECK(adc_stream_get_write_index(ADC1) == 4);
+
+	adc_interleaved_stop();
+	CHECK((sim_adc_common.CCR & ADC_CCR_MULTI) == 0u);
+	CHECK((sim_adc[1].CR2 & ADC_CR2_CONT) == 0u);
+}
+
+static void test_stop_disables_stream(void) {
+	adc_stream_stop(ADC1);
+
+	CHECK((sim_dma2_stream[0].CR & DMA_SxCR_EN) == 0u);
+	CHECK((sim_adc[0].CR2 & (ADC_CR2_DMA | ADC_CR2_CONT)) == 0u);
+	CHECK((sim_nvic_enabled & (1u << (DMA2_Stream0_IRQn & 31))) == 0u);
+
+	num_of_callbacks = 0;
+	sim_dma2.LISR = DMA_LISR_TCIF0;
+	DMA2_Stream0_IRQHandler();
+	CHECK(num_of_callbacks == 0);
+}
+
+int main(void) {
+	test_start_programs_dma_and_adc();
+	test_half_and_full_transfer_callbacks();
+	test_latest_sample_follows_ndtr();
+	test_other_adcs_use_their_streams();
+	test_external_trigger_is_not_overridden();
+	test_scan_frames();
+	test_triple_interleaved_order();
+	test_stop_disables_stream();
+
+	printf("adc_stream_test: %s\n", (failures == 0)? "PASS": "FAIL");
+	return (failures == 0)? 0: 1;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file: command_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/command.c: every name resolves through the perfect hash
+ * in either case, look-alikes do not, arguments are parsed and bounded, the
+ * binary form round-trips, and the byte reader answers text and binary
+ * commands arriving on the same line in their own form.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tests/command_test.c Src/command.c Src/fmt.c Src/cobs.c Src/crc16.c \
+ *       -o command_test && ./command_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include "command.h"
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+static uint8_t parse(const char* text, Command_Type* command) {
+    return command_parse_text(text, (uint32_t)strlen(text), command);
+}
+
+
+static void test_names(void) {
+    Command_Type command;
+    char lower[8];
+
+    for (uint8_t id = 0; id < COMMAND_COUNT; id++) {
+        const char* name = command_name(id);
+        uint32_t i;
+
+        for (i = 0; name[i] != '\0'; i++) {
+            lower[i] = (char)tolower((unsigned char)name[i]);
+        }
+        lower[i] = '\0';
+
+        uint8_t needs_argument = (id == COMMAND_SNAP) || (id == COMMAND_SET) || (id == COMMAND_TRIG);
+        char line[32];
+        snprintf(line, sizeof(line), needs_argument? "%s 1": "%s", name);
+        CHECK(parse(line, &command) == COMMAND_OK);
+        CHECK(command.id == id);
+        snprintf(line, sizeof(line), needs_argument? "%s 1": "%s", lower);
+        CHECK(parse(line, &command) == COMMAND_OK);
+        CHECK(command.id == id);
+    }
+
+    // same hash slot or prefix of a real name, but not a command
+    const char* impostors[] = {"STARTX", "STA", "SETX", "STOQ", "SNAPP", "ST", "", "TABLES", "BINARZ", "PROBES", "PRO", "TRIGS", "TRI", "BITSX", "BIT", "XXXXX"};
+    for (uint32_t i = 0; i < sizeof(impostors) / sizeof(impostors[0]); i++) {
+        CHECK(parse(impostors[i], &command) == COMMAND_ERROR_UNKNOWN);
+    }
+}
+
+static void test_arguments(void) {
+    Command_Type command;
+
+    CHECK(parse("  START   2500 ", &command) == COMMAND_OK);
+    CHECK((command.argc == 1u) && (command.argv[0] == 2500u));
+
+    CHECK(parse("set 0x1,4, 5", &command) == COMMAND_OK);
+    CHECK((command.id == COMMAND_SET) && (command.argc == 3u));
+    CHECK((command.argv[0] == 1u) && (command.argv[1] == 4u) && (command.argv[2] == 5u));
+
+    CHECK(parse("START 4294967295", &command) == COMMAND_OK);
+    CHECK(parse("START 4294967296", &command) == COMMAND_ERROR_ARGUMENT);
+    CHECK(parse("START 12a", &command) == COMMAND_ERROR_ARGUMENT);
+    CHECK(parse("START 0x", &command) == COMMAND_ERROR_ARGUMENT);
+    CHECK(parse("START 1 2", &command) == COMMAND_ERROR_ARGUMENT);
+    CHECK(parse("SNAP", &command) == COMMAND_ERROR_ARGUMENT);
+    CHECK(parse("STAT 1", &command) == COMMAND_ERROR_ARGUMENT);
+    CHECK(parse("SET 1 2 3 4 5 6 7 8", &command) == COMMAND_OK);
+    CHECK(parse("SET 1 2 3 4 5 6 7 8 9", &command) == COMMAND_ERROR_ARGUMENT);
+}
+
+static void test_binary_round_trip(void) {
+    Command_Type sent = {.id = COMMAND_SET, .argc = 3, .argv = {0, 0x100, 0xFFFFFFFF}};
+    Command_Type received;
+    uint8_t frame[COMMAND_MAX_FRAME_LENGTH];
+
+    uint32_t length = command_encode_binary(&sent, frame);
+    CHECK(frame[0] == COBS_DELIMITER);
+    CHECK(frame[length - 1u] == COBS_DELIMITER);
+    CHECK(command_parse_binary(&frame[1], length - 2u, &received) == COMMAND_OK);
+    CHECK((received.id == sent.id) && (received.argc == sent.argc));
+    CHECK(memcmp(received.argv, sent.argv, sent.argc * sizeof(uint32_t)) == 0);
+
+    frame[3] ^= 0x01u;
+    CHECK(command_parse_binary(&frame[1], length - 2u, &received) == COMMAND_ERROR_FRAME);
+
+    Command_Type stop_with_argument = {.id = COMMAND_STOP, .argc = 1, .argv = {7}};
+    length = command_encode_binary(&stop_with_argument, frame);
+    CHECK(command_parse_binary(&frame[1], length - 2u, &received) == COMMAND_ERROR_ARGUMENT);
+
+    Command_Type unknown = {.id = COMMAND_COUNT, .argc = 0};
+    length = command_encode_binary(&unknown, frame);
+    CHECK(command_parse_binary(&frame[1], length - 2u, &received) == COMMAND_ERROR_UNKNOWN);
+}
+
+
+static uint32_t start_calls;
+
+static void fake_start(const Command_Type* command, Command_Response_Type* response) {
+    start_calls++;
+    response->values[response->count++] = (command->argc != 0u)? command->argv[0] - 1u: 0u;
+}
+
+static void fake_stop(const Command_Type* command, Command_Response_Type* response) {
+    (void)command;
+    response->status = COMMAND_ERROR_STATE;
+}
+
+static const Command_Handler fake_handlers[COMMAND_COUNT] = {
+    [COMMAND_START] = fake_start,
+    [COMMAND_STOP] = fake_stop,
+};
+
+// Feeds bytes and concatenates every reply
+static uint32_t feed(Command_Reader_Type* reader, const uint8_t* bytes, uint32_t length, uint8_t* replies) {
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        total += command_reader_feed(reader, bytes[i], fake_handlers, &replies[total]);
+    }
+    return total;
+}
+
+static void test_reader(void) {
+    Command_Reader_Type reader;
+    uint8_t replies[4 * COMMAND_MAX_REPLY_LENGTH];
+    uint32_t length;
+
+    command_reader_init(&reader);
+
+    const char* text = "start 1000\r\n\nstop\rstat\nbogus\n";
+    length = feed(&reader, (const uint8_t*)text, (uint32_t)strlen(text), replies);
+    replies[length] = '\0';
+    CHECK(strcmp((char*)replies, "OK START 999\r\nERR STATE\r\nERR UNKNOWN\r\nERR UNKNOWN\r\n") == 0);
+    CHECK(start_calls == 1u);
+
+    // a binary command in the middle of a typed line: the partial text is dropped
+    Command_Type start = {.id = COMMAND_START, .argc = 1, .argv = {500}};
+    uint8_t stream[64];
+    uint32_t stream_length = 0;
+    memcpy(stream, "sta", 3);
+    stream_length = 3;
+    stream_length += command_encode_binary(&start, &stream[stream_length]);
+
+    length = feed(&reader, stream, stream_length, replies);
+    CHECK(replies[length - 1u] == COBS_DELIMITER);
+
+    uint8_t id;
+    Command_Response_Type response;
+    CHECK(command_decode_response(replies, length - 1u, &id, &response) == 1u);
+    CHECK((id == COMMAND_START) && (response.status == COMMAND_OK));
+    CHECK((response.count == 1u) && (response.values[0] == 499u));
+
+    // an over-long line is rejected as a whole
+    char long_line[COMMAND_LINE_SIZE + 10u];
+    memset(long_line, 'A', sizeof(long_line) - 1u);
+    long_line[sizeof(long_line) - 1u] = '\n';
+    length = feed(&reader, (const uint8_t*)long_line, sizeof(long_line), replies);
+    replies[length] = '\0';
+    CHECK(strcmp((char*)replies, "ERR ARGUMENT\r\n") == 0);
+}
+
+
+int main(void) {
+    test_names();
+    test_arguments();
+    test_binary_round_trip();
+    test_reader();
+
+    if (failures != 0u) {
+        printf("command_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("command_test: PASS\n");
+    return 0;
+}
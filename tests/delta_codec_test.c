@@ -0,0 +1,128 @@
+/**
+ * @file: delta_codec_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/delta_codec.c: exact encodings of small and full-scale
+ * steps, round trips of slow and random signals, the size limit, and
+ * rejection of truncated or padded blocks.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tests/delta_codec_test.c Src/delta_codec.c \
+ *       -o delta_codec_test && ./delta_codec_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "delta_codec.h"
+
+#define MAX_SAMPLES 64u
+#define MAX_ENCODED ((MAX_SAMPLES * 5u + 1u) / 2u)  /* five nibbles per full-scale step */
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+static uint32_t rng_state = 777u;
+
+static uint32_t next_random(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 16;
+}
+
+
+static void test_known_encodings(void) {
+    // deltas 0, +1, -1, +3: zigzag 0, 2, 1, 6, one nibble each
+    const uint16_t small[4] = {0, 1, 0, 3};
+    const uint8_t small_expected[2] = {0x20, 0x61};
+    // +4095 then -4095: zigzag 8190 and 8189, five nibbles each
+    const uint16_t large[2] = {4095, 0};
+    const uint8_t large_expected[5] = {0xFE, 0xFF, 0xD1, 0xFF, 0x1F};
+    uint8_t buffer[8];
+    uint16_t decoded[4];
+
+    CHECK(delta_encode(small, 4, buffer, sizeof(buffer)) == 2u);
+    CHECK(memcmp(buffer, small_expected, 2) == 0);
+    CHECK(delta_decode(buffer, 2, 4, decoded) == 1u);
+    CHECK(memcmp(decoded, small, sizeof(small)) == 0);
+
+    CHECK(delta_encode(large, 2, buffer, sizeof(buffer)) == 5u);
+    CHECK(memcmp(buffer, large_expected, 5) == 0);
+    CHECK(delta_decode(buffer, 5, 2, decoded) == 1u);
+    CHECK(memcmp(decoded, large, sizeof(large)) == 0);
+}
+
+static void round_trip(const uint16_t* samples, uint32_t count) {
+    uint8_t buffer[MAX_ENCODED];
+    uint16_t decoded[MAX_SAMPLES];
+
+    uint32_t length = delta_encode(samples, count, buffer, sizeof(buffer));
+    CHECK((length != 0u) || (count == 0u));
+    CHECK(delta_decode(buffer, length, count, decoded) == 1u);
+    CHECK(memcmp(decoded, samples, count * sizeof(uint16_t)) == 0);
+}
+
+static void test_round_trips(void) {
+    uint16_t samples[MAX_SAMPLES];
+
+    for (uint32_t round = 0; round < 1000u; round++) {
+        uint32_t count = next_random() % (MAX_SAMPLES + 1u);
+        uint32_t step = (round & 1u)? 4096u: 7u;    /* random or slowly drifting */
+        int32_t value = (int32_t)(next_random() & 0x0FFFu);
+
+        for (uint32_t i = 0; i < count; i++) {
+            value += (int32_t)(next_random() % step) - (int32_t)(step / 2u);
+            value = (value < 0)? 0: (value > 4095)? 4095: value;
+            samples[i] = (uint16_t)value;
+        }
+        round_trip(samples, count);
+    }
+}
+
+static void test_size_limit(void) {
+    uint16_t samples[MAX_SAMPLES];
+    uint8_t buffer[MAX_ENCODED];
+
+    for (uint32_t i = 0; i < MAX_SAMPLES; i++) {
+        samples[i] = (i & 1u)? 4095u: 0u;
+    }
+    CHECK(delta_encode(samples, MAX_SAMPLES, buffer, MAX_SAMPLES) == 0u);
+    // the first sample is 0 (one nibble), every other step full scale (five nibbles)
+    CHECK(delta_encode(samples, MAX_SAMPLES, buffer, sizeof(buffer)) == (1u + (MAX_SAMPLES - 1u) * 5u + 1u) / 2u);
+}
+
+static void test_malformed(void) {
+    const uint16_t samples[3] = {100, 101, 99};
+    uint8_t buffer[8];
+    uint16_t decoded[3];
+
+    uint32_t length = delta_encode(samples, 3, buffer, sizeof(buffer));
+    CHECK(delta_decode(buffer, length - 1u, 3, decoded) == 0u);    /* truncated */
+    buffer[length] = 0x00;
+    CHECK(delta_decode(buffer, length + 1u, 3, decoded) == 0u);    /* trailing byte */
+
+    const uint8_t below_zero[1] = {0x01};   /* first delta -1 */
+    CHECK(delta_decode(below_zero, 1, 1, decoded) == 0u);
+
+    const uint8_t endless[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+    CHECK(delta_decode(endless, 4, 1, decoded) == 0u);
+
+    const uint8_t dirty_padding[1] = {0x50};   /* one sample, non-zero pad nibble */
+    CHECK(delta_decode(dirty_padding, 1, 1, decoded) == 0u);
+}
+
+
+int main(void) {
+    test_known_encodings();
+    test_round_trips();
+    test_size_limit();
+    test_malformed();
+
+    if (failures != 0u) {
+        printf("delta_codec_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("delta_codec_test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file: fmt_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/fmt.c: every conversion must produce exactly what the
+ * printf format it replaces produces, and appends must stop at the end of
+ * the buffer.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tests/fmt_test.c Src/fmt.c -o fmt_test && ./fmt_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include "fmt.h"
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+static char output[64];
+static Fmt_Buffer_Type buffer;
+
+static const char* finish(void) {
+    fmt_char(&buffer, '\0');
+    return output;
+}
+
+static void start(void) {
+    fmt_init(&buffer, output, sizeof(output));
+}
+
+
+static void test_numbers(void) {
+    static const uint32_t unsigned_values[] = {0u, 7u, 10u, 999u, 1000u, 4095u, 65536u, 4294967295u};
+    static const int32_t signed_values[] = {0, 1, -1, 42, -42, 2147483647, -2147483647 - 1};
+    char expected[64];
+
+    for (uint32_t i = 0; i < sizeof(unsigned_values) / sizeof(unsigned_values[0]); i++) {
+        for (uint8_t width = 0; width <= 12u; width++) {
+            uint32_t v = unsigned_values[i];
+
+            start(); fmt_u32(&buffer, v, width, 0u);
+            snprintf(expected, sizeof(expected), "%*" PRIu32, width, v);
+            CHECK(strcmp(finish(), expected) == 0);
+
+            start(); fmt_u32(&buffer, v, width, FMT_LEFT);
+            snprintf(expected, sizeof(expected), "%-*" PRIu32, width, v);
+            CHECK(strcmp(finish(), expected) == 0);
+
+            start(); fmt_u32(&buffer, v, width, FMT_ZERO);
+            snprintf(expected, sizeof(expected), "%0*" PRIu32, width, v);
+            CHECK(strcmp(finish(), expected) == 0);
+
+            start(); fmt_hex(&buffer, v, (width % 8u) + 1u);
+            snprintf(expected, sizeof(expected), "%0*" PRIX32, (width % 8u) + 1u, v);
+            CHECK(strcmp(finish(), &expected[strlen(expected) - ((width % 8u) + 1u)]) == 0);
+        }
+    }
+
+    for (uint32_t i = 0; i < sizeof(signed_values) / sizeof(signed_values[0]); i++) {
+        for (uint8_t width = 0; width <= 12u; width++) {
+            int32_t v = signed_values[i];
+
+            start(); fmt_i32(&buffer, v, width, 0u);
+            snprintf(expected, sizeof(expected), "%*" PRId32, width, v);
+            CHECK(strcmp(finish(), expected) == 0);
+
+            start(); fmt_i32(&buffer, v, width, FMT_LEFT);
+            snprintf(expected, sizeof(expected), "%-*" PRId32, width, v);
+            CHECK(strcmp(finish(), expected) == 0);
+
+            start(); fmt_i32(&buffer, v, width, FMT_ZERO);
+            snprintf(expected, sizeof(expected), "%0*" PRId32, width, v);
+            CHECK(strcmp(finish(), expected) == 0);
+        }
+    }
+}
+
+static void test_strings(void) {
+    start();
+    fmt_color(&buffer, "\x1B[1;91m");
+    fmt_str(&buffer, "Max: 4095", 9u, FMT_LEFT);
+    fmt_str(&buffer, "|", 3u, 0u);
+    fmt_str(&buffer, "Min: 0", 9u, FMT_LEFT);
+    fmt_char(&buffer, '|');
+    CHECK(strcmp(finish(), "\x1B[1;91mMax: 4095  |Min: 0   |") == 0);
+}
+
+static void test_overflow(void) {
+    char small[6];
+
+    memset(small, 'x', sizeof(small));
+    fmt_init(&buffer, small, 4u);
+    fmt_u32(&buffer, 123456u, 0u, 0u);
+    CHECK(buffer.length == 4u);
+    CHECK(buffer.overflow == 1u);
+    CHECK(memcmp(small, "1234xx", 6) == 0);
+
+    fmt_init(&buffer, NULL, 16u);   /* a failed USART2_tx_reserve() */
+    fmt_str(&buffer, "abc", 0u, 0u);
+    CHECK((buffer.length == 0u) && (buffer.overflow == 1u));
+}
+
+
+int main(void) {
+    test_numbers();
+    test_strings();
+    test_overflow();
+
+    if (failures != 0u) {
+        printf("fmt_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("fmt_test: PASS\n");
+    return 0;
+}
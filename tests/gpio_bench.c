@@ -0,0 +1,104 @@
+/**
+ * @file: gpio_bench.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * On-target benchmark of a pin write: the original table-on-the-stack plus
+ * ODR read-modify-write, the out-of-line GPIOx_set_odr(), and the inline
+ * BSRR accessors resolved at compile time. Cycles come from DWT->CYCCNT and
+ * are printed on USART2 (115200 8N1) once at reset.
+ *
+ * Every case runs in the same loop and the cycles of that loop with an empty
+ * body are subtracted, so a called case includes its call and return and an
+ * inline case only its own instructions. The empty call is printed too.
+ *
+ * Build this file in place of Src/main.c with `make CONFIG=Release gpio_bench`
+ * (-Os, as the Release configuration of the IDE). Expected there at 180 MHz:
+ * an inline write costs one store (1-2 cycles), the legacy path an order of
+ * magnitude more. The Debug configuration builds at -O0, where the inline
+ * accessors are not inlined and the comparison means nothing; the output
+ * says so.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include "pll.h"
+#include "gpio.h"
+#include "usart.h"
+
+#define BENCH_ITERATIONS 1000u
+
+// The pin write as it was: port table rebuilt on the stack, ODR read-modify-write
+__attribute__((noinline)) static void legacy_set_odr(uint8_t pin) {
+    GPIO_TypeDef* ports[] = {
+        GPIOA, GPIOB, GPIOC, GPIOD, GPIOE, GPIOF, GPIOG, GPIOH,
+    };
+    GPIO_TypeDef* GPIOx = ports[pin / NUM_PINS_PER_PORT];
+
+    GPIOx->ODR |= (1 << (pin % NUM_PINS_PER_PORT));
+}
+
+__attribute__((noinline)) static void empty(uint8_t pin) {
+    __asm volatile ("" :: "r" (pin));
+}
+
+static volatile uint8_t bench_pin = PA5;    /* defeats constant folding for the run-time cases */
+
+// Cycles of BENCH_ITERATIONS runs of body; the barrier keeps the loop when the body is empty
+#define TIME_LOOP(body) ({                                  \
+    uint32_t start_ = DWT->CYCCNT;                          \
+    for (uint32_t i_ = 0; i_ < BENCH_ITERATIONS; i_++) {    \
+        body;                                               \
+        __asm volatile ("" ::: "memory");                   \
+    }                                                       \
+    DWT->CYCCNT - start_;                                   \
+})
+
+// Cycles per run of a case, without the loop around it
+static uint32_t per_write(uint32_t cycles, uint32_t loop_cycles) {
+    return (cycles > loop_cycles)? ((cycles - loop_cycles) / BENCH_ITERATIONS): 0u;
+}
+
+
+int main(void) {
+    clockSpeed_PLL();
+    SysTick_Init();
+
+    GPIOx_init(PA);
+    GPIOx_init(PB);
+    GPIOx_config_mode(PA5, MODER_OUTPUT);
+    GPIOx_config_mode(PA6, MODER_OUTPUT);
+    GPIOx_config_mode(PB12, MODER_OUTPUT);
+
+    USART2_quick_default_config();
+    USART2_dma_tx_init();
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint8_t pin = bench_pin;
+    uint32_t loop = TIME_LOOP((void)0);
+    uint32_t call = per_write(TIME_LOOP(empty(pin)), loop);
+    uint32_t legacy = per_write(TIME_LOOP(legacy_set_odr(pin)), loop);
+    uint32_t out_of_line = per_write(TIME_LOOP(GPIOx_set_odr(pin)), loop);
+    uint32_t inline_set = per_write(TIME_LOOP(GPIOx_bsrr_set(PA5)), loop);
+    uint32_t inline_port = per_write(TIME_LOOP(GPIOx_bsrr_write(PA, GPIOx_PIN_BIT(PA5) | GPIOx_PIN_BIT(PA6),
+            GPIOx_PIN_BIT(PA6))), loop);
+
+    printf("gpio_bench: cycles per pin write, %u iterations, empty loop (%lu cycles) subtracted\r\n",
+           (unsigned)BENCH_ITERATIONS, (unsigned long)loop);
+#ifndef __OPTIMIZE__
+    printf("  built at -O0 (CONFIG=Debug): inline accessors are calls, rebuild with CONFIG=Release\r\n");
+#endif
+    printf("  empty call                    %lu\r\n", (unsigned long)call);
+    printf("  legacy ODR read-modify-write  %lu (call included)\r\n", (unsigned long)legacy);
+    printf("  GPIOx_set_odr() via BSRR      %lu (call included)\r\n", (unsigned long)out_of_line);
+    printf("  GPIOx_bsrr_set(PA5) inline    %lu\r\n", (unsigned long)inline_set);
+    printf("  GPIOx_bsrr_write() two pins   %lu\r\n", (unsigned long)inline_port);
+
+    for(;;) {
+    }
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file: oversample_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/oversample.c: results against a plain sum for every
+ * ratio, blocks of any length and alignment with results straddling them,
+ * full-scale input (the SIMD lanes at their limit), reset, and the
+ * TELEMETRY_TYPE_WIDE16 frames that carry the results.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc -DHOST_BUILD tests/oversample_test.c Src/oversample.c Src/telemetry.c \
+ *       Src/pack12.c Src/delta_codec.c Src/cobs.c Src/crc16.c -o oversample_test && ./oversample_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "oversample.h"
+#include "telemetry.h"
+
+#define NUM_SAMPLES 4096u
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+static uint32_t rng_state = 12345u;
+
+static uint32_t next_random(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 16;
+}
+
+static uint16_t input[NUM_SAMPLES + 1u];    /* + 1: room to start on an odd halfword */
+static uint16_t results[NUM_SAMPLES];
+static uint16_t expected[NUM_SAMPLES];
+
+// Rounded sum of every 4^n samples, one at a time
+static uint32_t reference(const uint16_t* samples, uint32_t count, uint8_t extra_bits, uint16_t* destination) {
+    uint32_t ratio = 1u << (2u * extra_bits);
+    uint32_t rounding = (extra_bits != 0u)? (1u << (extra_bits - 1u)): 0u;
+    uint32_t written = 0u;
+
+    for (uint32_t start = 0; (start + ratio) <= count; start += ratio) {
+        uint32_t sum = 0u;
+        for (uint32_t i = 0; i < ratio; i++) {
+            sum += samples[start + i];
+        }
+        destination[written++] = (uint16_t)((sum + rounding) >> extra_bits);
+    }
+    return written;
+}
+
+// Feeds count samples in blocks of block_length, returns the number of results
+static uint32_t feed(Oversample_Type* stage, const uint16_t* samples, uint32_t count, uint32_t block_length) {
+    uint32_t written = 0u;
+
+    for (uint32_t offset = 0; offset < count; offset += block_length) {
+        uint32_t length = ((count - offset) < block_length)? (count - offset): block_length;
+        written += oversample_process(stage, &samples[offset], length, &results[written]);
+    }
+    return written;
+}
+
+
+static void test_known_values(void) {
+    Oversample_Type stage;
+    uint16_t samples[16];
+
+    // 16 x 1000 plus 8: 16008 / 4 = 4002, 14 bits
+    for (uint32_t i = 0; i < 16u; i++) {
+        samples[i] = (uint16_t)(1000u + (i == 3u) * 8u);
+    }
+    oversample_init(&stage, 2u);
+    CHECK(oversample_bits(&stage) == 14u);
+    CHECK(stage.ratio == 16u);
+    CHECK(oversample_process(&stage, samples, 16u, results) == 1u);
+    CHECK(results[0] == 4002u);
+
+    // 4 samples summing to 4 x 100 + 1: 401 / 2 = 200.5, rounded up
+    const uint16_t half_way[4] = {100, 100, 100, 101};
+    oversample_init(&stage, 1u);
+    CHECK(oversample_process(&stage, half_way, 4u, results) == 1u);
+    CHECK(results[0] == 201u);
+
+    // n = 0 passes samples through
+    oversample_init(&stage, 0u);
+    CHECK(oversample_process(&stage, half_way, 4u, results) == 4u);
+    CHECK(memcmp(results, half_way, sizeof(half_way)) == 0);
+
+    // more than 4 extra bits are clipped
+    oversample_init(&stage, 9u);
+    CHECK(oversample_bits(&stage) == 16u);
+}
+
+static void test_against_reference(void) {
+    const uint32_t block_lengths[] = {1u, 3u, 15u, 16u, 17u, 32u, 100u, NUM_SAMPLES};
+
+    for (uint32_t i = 0; i < (NUM_SAMPLES + 1u); i++) {
+        input[i] = (uint16_t)(next_random() & 0xFFFu);
+    }
+
+    for (uint8_t extra_bits = 0; extra_bits <= OVERSAMPLE_MAX_EXTRA_BITS; extra_bits++) {
+        for (uint32_t odd = 0; odd < 2u; odd++) {
+            uint32_t count = reference(&input[odd], NUM_SAMPLES, extra_bits, expected);
+
+            for (uint32_t b = 0; b < sizeof(block_lengths) / sizeof(block_lengths[0]); b++) {
+                Oversample_Type stage;
+
+                oversample_init(&stage, extra_bits);
+                memset(results, 0, sizeof(results));
+                CHECK(feed(&stage, &input[odd], NUM_SAMPLES, block_lengths[b]) == count);
+                CHECK(memcmp(results, expected, count * sizeof(results[0])) == 0);
+                CHECK(stage.pending == 0u);     /* 4096 is a multiple of every ratio */
+            }
+        }
+    }
+}
+
+static void test_full_scale(void) {
+    Oversample_Type stage;
+
+    // 8 x 4095 per SADD16 lane is the largest sum before the sign bit
+    for (uint32_t i = 0; i < NUM_SAMPLES; i++) {
+        input[i] = 4095u;
+    }
+    oversample_init(&stage, 4u);
+    CHECK(oversample_process(&stage, input, NUM_SAMPLES, results) == 16u);
+    CHECK((results[0] == 65520u) && (results[15] == 65520u));
+
+    memset(input, 0, sizeof(input));
+    CHECK(oversample_process(&stage, input, 256u, results) == 1u);
+    CHECK(results[0] == 0u);
+}
+
+static void test_reset(void) {
+    Oversample_Type stage;
+
+    for (uint32_t i = 0; i < 64u; i++) {
+        input[i] = (i < 32u)? 4095u: 100u;
+    }
+    oversample_init(&stage, 2u);
+    CHECK(oversample_process(&stage, input, 8u, results) == 0u);
+    CHECK(stage.pending == 8u);
+    oversample_reset(&stage);
+    CHECK(oversample_process(&stage, &input[32], 16u, results) == 1u);
+    CHECK(results[0] == 400u);      /* nothing left of the 4095s */
+}
+
+static void test_wide16_frames(void) {
+    Telemetry_Header_Type header = {
+        .type = TELEMETRY_TYPE_WIDE16,
+        .sequence = 7u,
+        .timestamp = 123456u,
+        .channel_mask = (1u << 1),
+        .num_of_samples = TELEMETRY_MAX_SAMPLES,
+        .bits = 16u,
+    };
+    Telemetry_Header_Type decoded;
+    uint8_t frame[TELEMETRY_MAX_FRAME_LENGTH];
+    uint16_t samples[TELEMETRY_MAX_SAMPLES];
+
+    for (uint32_t i = 0; i < TELEMETRY_MAX_SAMPLES; i++) {
+        expected[i] = (uint16_t)(next_random() | (i << 15));
+    }
+    uint32_t length = telemetry_encode_frame(&header, expected, frame);
+    CHECK(length <= TELEMETRY_MAX_FRAME_LENGTH);
+    CHECK(length <= TELEMETRY_FRAME_LENGTH(TELEMETRY_WIDE16_LENGTH(TELEMETRY_MAX_SAMPLES)));
+    CHECK(telemetry_decode_frame(frame, length - 1u, &decoded, samples) == 1u);
+    CHECK((decoded.type == TELEMETRY_TYPE_WIDE16) && (decoded.bits == 16u));
+    CHECK((decoded.sequence == 7u) && (decoded.timestamp == 123456u) && (decoded.channel_mask == 2u));
+    CHECK(decoded.num_of_samples == TELEMETRY_MAX_SAMPLES);
+    CHECK(memcmp(samples, expected, sizeof(samples)) == 0);
+
+    // a 14-bit frame may not carry a larger value
+    header.bits = 14u;
+    header.num_of_samples = 2u;
+    expected[0] = 16383u;
+    expected[1] = 16384u;
+    length = telemetry_encode_frame(&header, expected, frame);
+    CHECK(telemetry_decode_frame(frame, length - 1u, &decoded, samples) == 0u);
+    expected[1] = 0u;
+    length = telemetry_encode_frame(&header, expected, frame);
+    CHECK(telemetry_decode_frame(frame, length - 1u, &decoded, samples) == 1u);
+    CHECK((decoded.bits == 14u) && (samples[0] == 16383u));
+
+    // the 12-bit types report 12 bits
+    header.type = TELEMETRY_TYPE_PACKED12;
+    expected[0] = 4095u;
+    length = telemetry_encode_frame(&header, expected, frame);
+    CHECK(telemetry_decode_frame(frame, length - 1u, &decoded, samples) == 1u);
+    CHECK((decoded.type == TELEMETRY_TYPE_PACKED12) && (decoded.bits == TELEMETRY_BASE_BITS));
+}
+
+
+int main(void) {
+    test_known_values();
+    test_against_reference();
+    test_full_scale();
+    test_reset();
+    test_wide16_frames();
+
+    if (failures != 0u) {
+        printf("oversample_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("oversample_test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file: pack12_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/pack12.c: the word-at-a-time kernels are checked
+ * against a byte-by-byte reference of the documented layout, for every
+ * length up to 64 samples and for misaligned output buffers, and every
+ * packed buffer must unpack to the original samples.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tests/pack12_test.c Src/pack12.c \
+ *       -o pack12_test && ./pack12_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "pack12.h"
+
+#define MAX_SAMPLES 64u
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+
+// Byte-by-byte reference of the layout described in pack12.h
+static uint32_t reference_pack(const uint16_t* samples, uint32_t count, uint8_t* output) {
+    uint32_t out = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t s = samples[i] & 0x0FFFu;
+
+        if ((i & 1u) == 0u) {
+            output[out++] = (uint8_t)s;
+            output[out++] = (uint8_t)(s >> 8);
+        } else {
+            output[out - 1u] |= (uint8_t)(s << 4);
+            output[out++] = (uint8_t)(s >> 4);
+        }
+    }
+
+    return out;
+}
+
+static uint32_t rng_state = 12345u;
+
+static uint16_t next_random(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (uint16_t)(rng_state >> 16);
+}
+
+
+static void test_lengths_and_alignment(void) {
+    uint16_t samples[MAX_SAMPLES];
+    uint16_t unpacked[MAX_SAMPLES + 1u];
+    uint8_t expected[PACK12_LENGTH(MAX_SAMPLES)];
+    uint8_t buffer[PACK12_LENGTH(MAX_SAMPLES) + 8u];
+
+    for (uint32_t count = 0; count <= MAX_SAMPLES; count++) {
+        for (uint32_t offset = 0; offset < 4u; offset++) {
+            for (uint32_t i = 0; i < count; i++) {
+                samples[i] = next_random();     /* upper nibble set on purpose */
+            }
+
+            uint32_t expected_length = reference_pack(samples, count, expected);
+            CHECK(expected_length == PACK12_LENGTH(count));
+
+            memset(buffer, 0xA5, sizeof(buffer));
+            uint32_t length = pack12(samples, count, &buffer[offset]);
+            CHECK(length == expected_length);
+            CHECK(memcmp(&buffer[offset], expected, length) == 0);
+            CHECK(buffer[offset + length] == 0xA5);    /* nothing written past the end */
+
+            unpacked[count] = 0xBEEF;
+            unpack12(&buffer[offset], count, unpacked);
+            for (uint32_t i = 0; i < count; i++) {
+                CHECK(unpacked[i] == (samples[i] & 0x0FFFu));
+            }
+            CHECK(unpacked[count] == 0xBEEF);
+        }
+    }
+}
+
+static void test_extremes(void) {
+    const uint16_t samples[4] = {0x0FFF, 0x0000, 0x0ABC, 0x0FFF};
+    const uint8_t expected[6] = {0xFF, 0x0F, 0x00, 0xBC, 0xFA, 0xFF};
+    uint8_t buffer[6];
+    uint16_t unpacked[4];
+
+    CHECK(pack12(samples, 4, buffer) == 6u);
+    CHECK(memcmp(buffer, expected, sizeof(expected)) == 0);
+    unpack12(buffer, 4, unpacked);
+    CHECK(memcmp(unpacked, samples, sizeof(samples)) == 0);
+}
+
+
+int main(void) {
+    test_extremes();
+    test_lengths_and_alignment();
+
+    if (failures != 0u) {
+        printf("pack12_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("pack12_test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file: sample_ring_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/sample_ring.c: ordering, wrap-around of the free-running
+ * indices, overrun accounting and a two-thread producer/consumer run.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tests/sample_ring_test.c Src/sample_ring.c \
+ *       -lpthread -o sample_ring_test && ./sample_ring_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "sample_ring.h"
+
+#define STRESS_SAMPLES 2000000u
+
+static int failures = 0;
+static Sample_Ring_Type ring;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static ADC_Sample_Type make_sample(uint32_t n) {
+	ADC_Sample_Type sample = { .timestamp = n, .value = (uint16_t)(n & 0xFFF), .adc = (uint8_t)(n % 3), .reserved = 0 };
+	return sample;
+}
+
+static void test_fifo_order(void) {
+	ADC_Sample_Type out;
+	sample_ring_init(&ring);
+
+	CHECK(sample_ring_pop(&ring, &out) == 0);
+	for (uint32_t i = 0; i < 10; i++) {
+		ADC_Sample_Type in = make_sample(i);
+		CHECK(sample_ring_push(&ring, &in) == 1);
+	}
+	CHECK(sample_ring_count(&ring) == 10);
+	for (uint32_t i = 0; i < 10; i++) {
+		CHECK(sample_ring_pop(&ring, &out) == 1);
+		CHECK(out.timestamp == i && out.value == i && out.adc == i % 3);
+	}
+	CHECK(sample_ring_count(&ring) == 0);
+}
+
+static void test_overrun_when_full(void) {
+	ADC_Sample_Type in = make_sample(0), out;
+	sample_ring_init(&ring);
+
+	for (uint32_t i = 0; i < SAMPLE_RING_SIZE; i++) {
+		in = make_sample(i);
+		CHECK(sample_ring_push(&ring, &in) == 1);
+	}
+	in = make_sample(SAMPLE_RING_SIZE);
+	CHECK(sample_ring_push(&ring, &in) == 0);
+	CHECK(sample_ring_push(&ring, &in) == 0);
+	CHECK(sample_ring_overruns(&ring) == 2);
+	CHECK(sample_ring_count(&ring) == SAMPLE_RING_SIZE);
+
+	// the oldest samples survive, the dropped ones never appear
+	CHECK(sample_ring_pop(&ring, &out) == 1 && out.timestamp == 0);
+	CHECK(sample_ring_push(&ring, &in) == 1);
+}
+
+static void test_index_wrap(void) {
+	ADC_Sample_Type in, out;
+	sample_ring_init(&ring);
+	ring.head = ring.tail = 0xFFFFFFF0u;	/* just below the 32-bit wrap */
+
+	for (uint32_t i = 0; i < 64; i++) {
+		in = make_sample(i);
+		CHECK(sample_ring_push(&ring, &in) == 1);
+		CHECK(sample_ring_pop(&ring, &out) == 1);
+		CHECK(out.timestamp == i);
+	}
+	CHECK(sample_ring_count(&ring) == 0);
+	CHECK(ring.head == 0x30u);
+}
+
+static void* producer(void* arg) {
+	(void)arg;
+	for (uint32_t i = 0; i < STRESS_SAMPLES; i++) {
+		ADC_Sample_Type in = make_sample(i);
+		while (sample_ring_push(&ring, &in) == 0);	/* retry instead of dropping */
+	}
+	return NULL;
+}
+
+static void test_two_threads(void) {
+	pthread_t thread;
+	ADC_Sample_Type out;
+	uint32_t expected = 0;
+
+	sample_ring_init(&ring);
+	pthread_create(&thread, NULL, producer, NULL);
+	while (expected < STRESS_SAMPLES) {
+		if (sample_ring_pop(&ring, &out)) {
+			if (out.timestamp != expected || out.value != (expected & 0xFFF)) {
+				CHECK(out.timestamp == expected);
+				break;
+			}
+			expected++;
+		}
+	}
+	pthread_join(thread, NULL);
+	CHECK(expected == STRESS_SAMPLES);
+}
+
+int main(void) {
+	test_fifo_order();
+	test_overrun_when_full();
+	test_index_wrap();
+	test_two_threads();
+
+	printf("sample_ring_test: %s\n", (failures == 0)? "PASS": "FAIL");
+	return (failures == 0)? 0: 1;
+}
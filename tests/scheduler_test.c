@@ -0,0 +1,112 @@
+/**
+ * @file: scheduler_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/scheduler.c: dispatch order follows priority, repeated
+ * posts merge, tasks may post themselves and others, and the idle path only
+ * sleeps when nothing is ready.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc -DHOST_BUILD tests/scheduler_test.c Src/scheduler.c -o scheduler_test && ./scheduler_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "scheduler.h"
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+static char trace[64];
+static uint32_t trace_length;
+static uint32_t repost_count;
+
+static void record(char c) {
+    if (trace_length < (sizeof(trace) - 1u)) {
+        trace[trace_length++] = c;
+        trace[trace_length] = '\0';
+    }
+}
+
+static void task_low(void) { record('l'); }
+static void task_mid(void) { record('m'); }
+static void task_top(void) { record('t'); }
+
+// Posts the top task and itself twice more
+static void task_chain(void) {
+    record('c');
+    sched_post(31u);
+    if (++repost_count < 3u) {
+        sched_post(5u);
+    }
+}
+
+static void run_all(void) {
+    while (sched_run_once()) {
+    }
+}
+
+static void reset(void) {
+    sched_init();
+    trace_length = 0u;
+    trace[0] = '\0';
+    repost_count = 0u;
+    sched_register(0u, task_low);
+    sched_register(7u, task_mid);
+    sched_register(31u, task_top);
+    sched_register(5u, task_chain);
+}
+
+
+static void test_priority_order(void) {
+    reset();
+    sched_post(0u);
+    sched_post(31u);
+    sched_post(7u);
+    sched_post(7u);     /* merges with the previous post */
+    run_all();
+    CHECK(strcmp(trace, "tml") == 0);
+    CHECK(sched_run_once() == 0u);
+}
+
+static void test_posts_from_tasks(void) {
+    reset();
+    sched_post(5u);
+    sched_post(0u);
+    run_all();
+    // every run of the chain lets the top task in first, the low task waits for all
+    CHECK(strcmp(trace, "ctctctl") == 0);
+}
+
+static void test_idle(void) {
+    reset();
+    sched_post(7u);
+    sched_idle();
+    CHECK(sched_sleeps() == 0u);    /* ready work is never slept on */
+    run_all();
+    sched_idle();
+    CHECK(sched_sleeps() == 1u);
+
+    sched_post(12u);    /* no task registered: the post is consumed silently */
+    CHECK(sched_run_once() == 1u);
+    CHECK(sched_run_once() == 0u);
+    sched_post(SCHED_MAX_TASKS);    /* out of range, ignored */
+    CHECK(sched_run_once() == 0u);
+}
+
+
+int main(void) {
+    test_priority_order();
+    test_posts_from_tasks();
+    test_idle();
+
+    if (failures != 0u) {
+        printf("scheduler_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("scheduler_test: PASS\n");
+    return 0;
+}
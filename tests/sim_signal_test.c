@@ -0,0 +1,137 @@
+/**
+ * @file: sim_signal_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for the synthetic analog sources of the simulator: parsing of the
+ * specifications, levels at known times, clamping, repeatable noise and
+ * replay of both CSV layouts.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -fsanitize=address,undefined -include Sim/sim_device.h -IInc -ISim \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast tests/sim_signal_test.c Sim/sim_signal.c \
+ *       -lm -o sim_signal_test && ./sim_signal_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "sim_signal.h"
+#include "pll.h"
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+#define CYCLES_PER_MS   (HCLK_FREQ / 1000u)
+
+static uint16_t at_ms(Sim_Signal_Type* signal, double ms) {
+    return sim_signal_sample(1u, (uint64_t)(ms * CYCLES_PER_MS), signal);
+}
+
+
+static void test_parse(void) {
+    Sim_Signal_Type signal;
+
+    CHECK(sim_signal_parse(&signal, "const:100") && (signal.kind == SIM_SIGNAL_CONSTANT));
+    CHECK(sim_signal_parse(&signal, "noise:2048,10") && (signal.seed == 1u));
+    CHECK(sim_signal_parse(&signal, "noise:2048,10,42") && (signal.seed == 42u));
+    CHECK(!sim_signal_parse(&signal, "sine"));
+    CHECK(!sim_signal_parse(&signal, "sine:1,2"));          /* too few */
+    CHECK(!sim_signal_parse(&signal, "sine:1,2,3,4"));      /* too many */
+    CHECK(!sim_signal_parse(&signal, "ramp:0,x,1"));
+    CHECK(!sim_signal_parse(&signal, "square:0,1,2"));
+    CHECK(!sim_signal_parse(&signal, "csv:/nonexistent/file.csv"));
+}
+
+static void test_levels(void) {
+    Sim_Signal_Type signal;
+
+    sim_signal_parse(&signal, "sine:2048,1000,10");
+    CHECK(at_ms(&signal, 0.0) == 2048u);
+    CHECK(at_ms(&signal, 25.0) == 3048u);       /* quarter period */
+    CHECK(at_ms(&signal, 75.0) == 1048u);
+
+    sim_signal_parse(&signal, "ramp:1000,2000,100");
+    CHECK(at_ms(&signal, 0.0) == 1000u);
+    CHECK(at_ms(&signal, 5.0) == 1500u);
+    CHECK(at_ms(&signal, 10.0) == 1000u);       /* wrapped */
+
+    sim_signal_parse(&signal, "step:10,20,0.5");
+    CHECK(at_ms(&signal, 499.0) == 10u);
+    CHECK(at_ms(&signal, 500.0) == 20u);
+
+    sim_signal_parse(&signal, "sine:2048,5000,1");
+    CHECK(at_ms(&signal, 250.0) == 4095u);
+    CHECK(at_ms(&signal, 750.0) == 0u);
+}
+
+static void test_noise(void) {
+    Sim_Signal_Type a;
+    Sim_Signal_Type b;
+    Sim_Signal_Type c;
+    uint32_t differ = 0u;
+    uint16_t low = 4095u;
+    uint16_t high = 0u;
+
+    sim_signal_parse(&a, "noise:2048,100,7");
+    sim_signal_parse(&b, "noise:2048,100,7");
+    sim_signal_parse(&c, "noise:2048,100,8");
+    for (uint64_t cycle = 0; cycle < 100000u; cycle += 97u) {
+        uint16_t value = sim_signal_sample(1u, cycle, &a);
+        CHECK(value == sim_signal_sample(1u, cycle, &b));
+        differ += (value != sim_signal_sample(1u, cycle, &c));
+        low = (value < low)? value: low;
+        high = (value > high)? value: high;
+    }
+    CHECK(differ > 900u);
+    CHECK((low >= 1948u) && (low < 1960u));
+    CHECK((high <= 2148u) && (high > 2136u));
+}
+
+static void test_csv(void) {
+    Sim_Signal_Type signal;
+    const char* path = "sim_signal_test.csv";
+    FILE* file = fopen(path, "w");
+
+    fputs("level\n100\n# comment\n\n200\n300\n", file);
+    fclose(file);
+    CHECK(sim_signal_parse(&signal, "csv:sim_signal_test.csv,100"));
+    CHECK(signal.count == 3u);
+    CHECK(at_ms(&signal, 0.0) == 100u);
+    CHECK(at_ms(&signal, 15.0) == 200u);
+    CHECK(at_ms(&signal, 25.0) == 300u);
+    CHECK(at_ms(&signal, 5000.0) == 300u);      /* last level holds */
+    CHECK(at_ms(&signal, 9.0) == 100u);         /* back in time */
+    sim_signal_free(&signal);
+
+    file = fopen(path, "w");
+    fputs("time_s,level\n0.0,1\n0.25,2\n1.0,3\n", file);
+    fclose(file);
+    CHECK(sim_signal_parse(&signal, "csv:sim_signal_test.csv"));
+    CHECK(at_ms(&signal, 249.0) == 1u);
+    CHECK(at_ms(&signal, 250.0) == 2u);
+    CHECK(at_ms(&signal, 999.0) == 2u);
+    CHECK(at_ms(&signal, 1000.0) == 3u);
+    sim_signal_free(&signal);
+
+    file = fopen(path, "w");
+    fputs("0.5,1\n0.25,2\n", file);
+    fclose(file);
+    CHECK(!sim_signal_parse(&signal, "csv:sim_signal_test.csv"));
+    remove(path);
+}
+
+int main(void) {
+    test_parse();
+    test_levels();
+    test_noise();
+    test_csv();
+
+    if (failures != 0u) {
+        printf("sim_signal_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("sim_signal_test: PASS\n");
+    return 0;
+}
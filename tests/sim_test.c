@@ -0,0 +1,543 @@
+/**
+ * @file: sim_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test running the unmodified drivers against the peripheral simulator
+ * (Sim/): clock bring-up, SysTick time base, GPIO through BSRR/IDR, polled
+ * and interrupt-driven ADC conversions, the EXTSEL codes of the TIM2 and TIM3
+ * triggers, 16-rank scans (SQRx, SMPRx), TIM2-paced DMA streaming, USART2 polled, DMA and interrupt paths,
+ * including their timing in HCLK cycles, the USART2 baud rate settings, and the strobe pulse (TIM3
+ * settings, rounding, and the PB5 edges after each TIM2 trigger).
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -no-pie -fsanitize=address,undefined -include Sim/sim_device.h -IInc -ISim \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast tests/sim_test.c Sim/sim.c Src/pll.c \
+ *       Src/gpio.c Src/adc.c Src/adc_stream.c Src/adc_trigger.c Src/usart.c Src/sample_ring.c \
+ *       Src/strobe.c -o sim_test && ./sim_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "sim.h"
+#include "pll.h"
+#include "gpio.h"
+#include "adc.h"
+#include "adc_stream.h"
+#include "adc_trigger.h"
+#include "usart.h"
+#include "strobe.h"
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+#define CYCLES_PER_MS       (HCLK_FREQ / 1000u)
+#define FRAME_CYCLES_115200 (391u * 10u * (HCLK_FREQ / APB1_FREQ))     /* BRR = 391, 10 bits per frame */
+#define STREAM_LENGTH       64u
+#define STREAM_RATE_HZ      10000u
+#define PERIOD_CYCLES       (HCLK_FREQ / STREAM_RATE_HZ)
+#define SETTLE_CYCLES       1000u       /* lets the conversion started by the last trigger finish */
+#define TICK_CYCLES         (HCLK_FREQ / APB1_TIMER_FREQ)   /* HCLK cycles per timer tick */
+#define MAX_PULSES          16u
+
+typedef struct {
+    char data[256];
+    uint32_t length;
+} Capture_Type;
+
+// Cycles of the TIM2 updates and of the PB5 edges seen by the step hook
+typedef struct {
+    uint64_t triggers[MAX_PULSES];
+    uint64_t rises[MAX_PULSES];
+    uint64_t falls[MAX_PULSES];
+    uint32_t num_of_triggers;
+    uint32_t num_of_rises;
+    uint32_t num_of_falls;
+    uint8_t level;
+} Pulse_Log_Type;
+
+static Capture_Type captured;
+static uint32_t stream_calls;
+static uint32_t stream_samples;
+static volatile uint16_t stream_buffer[STREAM_LENGTH];
+
+static void capture(uint8_t byte, void* context) {
+    Capture_Type* capture = context;
+    if (capture->length < sizeof(capture->data)) {
+        capture->data[capture->length++] = (char)byte;
+    }
+}
+
+static uint16_t constant(uint8_t channel, uint64_t cycle, void* context) {
+    (void)channel;
+    (void)cycle;
+    return *(const uint16_t*)context;
+}
+
+// Sample index at STREAM_RATE_HZ, so every stored value tells when it was taken
+static uint16_t ramp(uint8_t channel, uint64_t cycle, void* context) {
+    (void)channel;
+    (void)context;
+    return (uint16_t)((cycle / PERIOD_CYCLES) & 0xFFFu);
+}
+
+// A level per channel, so every stored value tells which channel it came from
+static uint16_t by_channel(uint8_t channel, uint64_t cycle, void* context) {
+    (void)cycle;
+    (void)context;
+    return (uint16_t)((channel * 100u) + 7u);
+}
+
+// Step hook: steps land on timer events, so the cycles are exact
+static void log_pulses(void* context) {
+    Pulse_Log_Type* log = context;
+    uint8_t level = (uint8_t)((GPIOB->IDR >> 5) & 1u);
+
+    if ((TIM2->SR & TIM_SR_UIF) && (log->num_of_triggers < MAX_PULSES)) {
+        TIM2->SR = 0u;
+        log->triggers[log->num_of_triggers++] = sim_cycles();
+    }
+    if ((level > log->level) && (log->num_of_rises < MAX_PULSES)) {
+        log->rises[log->num_of_rises++] = sim_cycles();
+    } else if ((level < log->level) && (log->num_of_falls < MAX_PULSES)) {
+        log->falls[log->num_of_falls++] = sim_cycles();
+    }
+    log->level = level;
+}
+
+static void on_stream(volatile uint16_t* samples, uint32_t num_of_samples) {
+    (void)samples;
+    stream_calls++;
+    stream_samples += num_of_samples;
+}
+
+static void reset(void) {
+    sim_reset();
+    memset(&captured, 0, sizeof(captured));
+    sim_uart_set_sink(capture, &captured);
+}
+
+
+static void test_clock_and_systick(void) {
+    reset();
+
+    clockSpeed_PLL();
+    CHECK((RCC->CFGR & RCC_CFGR_SWS) == RCC_CFGR_SWS_PLL);
+    CHECK(PWR->CSR & PWR_CSR_ODSWRDY);
+
+    SysTick_Init();
+    uint64_t start = sim_cycles();
+    uint32_t millis_before = getMillis();
+    delay_ms(5u);
+    CHECK((getMillis() - millis_before) == 5u);
+    CHECK((sim_cycles() - start) >= (4u * CYCLES_PER_MS));
+    CHECK((sim_cycles() - start) <= (5u * CYCLES_PER_MS) + SIM_STEP_CYCLES);
+
+    uint32_t micros = get_micros();
+    start = sim_cycles();
+    delay_us(250u);
+    CHECK((get_micros() - micros) >= 250u);
+    CHECK((sim_cycles() - start) <= (251u * (HCLK_FREQ / 1000000u)) + SIM_STEP_CYCLES);
+}
+
+static void test_gpio(void) {
+    reset();
+
+    GPIOx_init(PA);
+    GPIOx_config_mode(PA5, MODER_OUTPUT);
+    GPIOx_set_odr(PA5);
+    CHECK(GPIOA->ODR & (1u << 5));
+    CHECK(GPIOx_get_idr(PA5) == 1u);
+    GPIOx_reset_odr(PA5);
+    CHECK((GPIOA->ODR & (1u << 5)) == 0u);
+
+    GPIOx_write_port(PA, 0x00F0u, 0x0050u);
+    CHECK((GPIOA->ODR & 0x00F0u) == 0x0050u);
+
+    GPIOx_init(PC);
+    GPIOx_config_mode(PC13, MODER_INPUT);
+    CHECK(GPIOx_idr_read(PC13) == 0u);
+    sim_gpio_set_input(2u, 13u, 1u);
+    CHECK(GPIOx_idr_read(PC13) == 1u);
+}
+
+static void test_polled_adc(void) {
+    uint8_t channels[] = { 1u };
+    uint16_t level = 1234u;
+
+    reset();
+    sim_adc_set_input(1u, constant, &level);
+
+    ADCx_init(ADC1);
+    set_regular_sequence(ADC1, 1u, channels);
+    set_channel_sample_time(ADC1, 1u, ADC_SAMPLE_TIME_3_CYCLES);
+    enable_adc_converter(ADC1);
+
+    uint64_t start = sim_cycles();
+    start_conversion(ADC1);
+    CHECK(get_data(ADC1) == 1234u);
+    CHECK((sim_cycles() - start) >= ((3u + 12u) * 8u));     /* 15 ADCCLK cycles at HCLK/8 */
+    CHECK(check_end_of_conversion_status(ADC1) == 0u);
+
+    set_channel_sample_time(ADC1, 1u, ADC_SAMPLE_TIME_480_CYCLES);
+    start = sim_cycles();
+    start_conversion(ADC1);
+    CHECK(get_data(ADC1) == 1234u);
+    CHECK((sim_cycles() - start) >= ((480u + 12u) * 8u));
+}
+
+static void test_triggered_interrupts(void) {
+    uint8_t channels[] = { 1u };
+    uint16_t level = 77u;
+    ADC_Sample_Type sample;
+
+    reset();
+    sim_adc_set_input(1u, constant, &level);
+    sample_ring_init(&adc_sample_ring);
+
+    ADCx_init(ADC1);
+    set_regular_sequence(ADC1, 1u, channels);
+    CHECK(adc_trigger_config(ADC1, TIM2, STREAM_RATE_HZ) == STREAM_RATE_HZ);
+    enable_adc_converter(ADC1);
+    enable_interrupt_on_end_of_conversion(ADC1);
+    adc_trigger_start(TIM2);
+
+    sim_advance(CYCLES_PER_MS + SETTLE_CYCLES);
+    CHECK(sample_ring_count(&adc_sample_ring) == (STREAM_RATE_HZ / 1000u));
+    CHECK(sample_ring_pop(&adc_sample_ring, &sample) && (sample.value == 77u) && (sample.adc == ADC_PORT_1));
+
+    adc_trigger_stop(TIM2);
+    uint32_t conversions = sim_stats()->adc_conversions;
+    sim_advance(CYCLES_PER_MS);
+    CHECK(sim_stats()->adc_conversions == conversions);
+
+    adc_trigger_fire(TIM2);     /* one conversion with the timer stopped */
+    sim_advance(CYCLES_PER_MS);
+    CHECK(sim_stats()->adc_conversions == (conversions + 1u));
+}
+
+// ADC1 converts once per TRGO of the timer adc_trigger_config() picked, and
+// the EXTSEL code it wrote is the one RM0390 gives for that timer
+static void test_trigger_sources(void) {
+    TIM_TypeDef* timers[] = { TIM2, TIM3 };
+    const uint32_t extsel[] = { 6u, 8u };   /* TIM2 TRGO, TIM3 TRGO */
+    uint8_t channels[] = { 1u };
+    uint16_t level = 1234u;
+
+    for (uint32_t i = 0; i < 2u; i++) {
+        reset();
+        sim_adc_set_input(1u, constant, &level);
+        ADCx_init(ADC1);
+        set_regular_sequence(ADC1, 1u, channels);
+        adc_trigger_config(ADC1, timers[i], STREAM_RATE_HZ);
+        enable_adc_converter(ADC1);
+        CHECK(((ADC1->CR2 & ADC_CR2_EXTSEL) / ADC_CR2_EXTSEL_0) == extsel[i]);
+
+        adc_trigger_start(timers[i]);
+        sim_advance(CYCLES_PER_MS + SETTLE_CYCLES);
+        CHECK(sim_stats()->adc_conversions == (STREAM_RATE_HZ / 1000u));
+        CHECK(ADC1->DR == level);
+        adc_trigger_stop(timers[i]);
+    }
+
+    // TIM5 CC2 (0b1011) is not TIM2 TRGO: nothing converts
+    reset();
+    ADCx_init(ADC1);
+    adc_trigger_config(ADC1, TIM2, STREAM_RATE_HZ);
+    enable_adc_converter(ADC1);
+    ADC1->CR2 = (ADC1->CR2 & ~ADC_CR2_EXTSEL) | (11u * ADC_CR2_EXTSEL_0);
+    adc_trigger_start(TIM2);
+    sim_advance(CYCLES_PER_MS);
+    CHECK(sim_stats()->adc_conversions == 0u);
+    adc_trigger_stop(TIM2);
+}
+
+// Field of rank (1-based) in SQR1..3, 5 bits each
+static uint32_t rank_field(uint32_t sqr, uint32_t rank) {
+    return (sqr >> (((rank - 1u) % 6u) * 5u)) & 0x1Fu;
+}
+
+// A full 16-rank scan through the real set_scan_sequence(): SQRx, L, SCAN, SMPRx, then conversions in rank order
+static void test_scan_sequence(void) {
+    uint8_t channels[16] = { 3u, 18u, 0u, 1u, 4u, 17u, 10u, 5u, 7u, 8u, 9u, 11u, 12u, 13u, 14u, 15u };
+    uint8_t sample_times[16];
+    uint8_t single[] = { 1u };
+
+    reset();
+    for (uint8_t channel = 0; channel <= MAX_CHANNEL_NUMBER; channel++) {
+        sim_adc_set_input(channel, by_channel, NULL);
+    }
+    for (uint32_t i = 0; i < 16u; i++) {
+        sample_times[i] = (uint8_t)((channels[i] * 5u) % 8u);     /* every code, varied per channel */
+    }
+
+    ADCx_init(ADC1);
+    set_scan_sequence(ADC1, 16u, channels, sample_times);
+
+    CHECK(rank_field(ADC1->SQR3, 1u) == 3u);        /* ranks 1-6 in SQR3 */
+    CHECK(rank_field(ADC1->SQR3, 6u) == 17u);
+    CHECK(rank_field(ADC1->SQR2, 7u) == 10u);       /* ranks 7-12 in SQR2 */
+    CHECK(rank_field(ADC1->SQR2, 12u) == 11u);
+    CHECK(rank_field(ADC1->SQR1, 13u) == 12u);      /* ranks 13-16 in SQR1 */
+    CHECK(rank_field(ADC1->SQR1, 16u) == 15u);
+    for (uint32_t rank = 1u; rank <= 16u; rank++) {
+        uint32_t sqr = (rank <= 6u)? ADC1->SQR3: (rank <= 12u)? ADC1->SQR2: ADC1->SQR1;
+        CHECK(rank_field(sqr, rank) == channels[rank - 1u]);
+    }
+    CHECK(((ADC1->SQR1 >> 20) & 0xFu) == 15u);     /* L = length - 1 */
+    CHECK((ADC1->SQR1 >> 24) == 0u);
+    CHECK(get_regular_sequence_length(ADC1) == 16u);
+    CHECK((ADC1->CR1 & ADC_CR1_SCAN) != 0u);
+
+    for (uint32_t i = 0; i < 16u; i++) {            /* channels 0-9 in SMPR2, 10-18 in SMPR1 */
+        uint32_t smp = (channels[i] < 10u)? (ADC1->SMPR2 >> (channels[i] * 3u)):
+                                             (ADC1->SMPR1 >> ((channels[i] - 10u) * 3u));
+        CHECK((smp & 7u) == sample_times[i]);
+    }
+    CHECK(((ADC1->SMPR2 >> (2u * 3u)) & 7u) == 0u);    /* channels 2 and 6 are not in the scan */
+    CHECK(((ADC1->SMPR2 >> (6u * 3u)) & 7u) == 0u);
+    CHECK((ADC1->SMPR1 >> 27) == 0u);
+
+    // four scans, one per trigger, land in rank order
+    stream_calls = 0u;
+    adc_trigger_config(ADC1, TIM2, 1000u);
+    adc_stream_start(ADC1, stream_buffer, STREAM_LENGTH, on_stream);
+    adc_trigger_start(TIM2);
+    sim_advance(4u * CYCLES_PER_MS + SETTLE_CYCLES);
+    CHECK(sim_stats()->adc_conversions == STREAM_LENGTH);
+    CHECK(stream_calls == 2u);
+    for (uint32_t i = 0; i < STREAM_LENGTH; i++) {
+        CHECK(stream_buffer[i] == (uint16_t)((channels[i % 16u] * 100u) + 7u));
+    }
+    adc_stream_stop(ADC1);
+    adc_trigger_stop(TIM2);
+
+    // back to one channel: L = 0, scan off, the higher ranks cleared
+    set_regular_sequence(ADC1, 1u, single);
+    CHECK(ADC1->SQR3 == 1u);
+    CHECK((ADC1->SQR2 == 0u) && (ADC1->SQR1 == 0u));
+    CHECK((ADC1->CR1 & ADC_CR1_SCAN) == 0u);
+}
+
+static void test_paced_stream(void) {
+    uint8_t channels[] = { 1u };
+
+    reset();
+    sim_adc_set_input(1u, ramp, NULL);
+    stream_calls = 0u;
+    stream_samples = 0u;
+
+    ADCx_init(ADC1);
+    set_regular_sequence(ADC1, 1u, channels);
+    adc_trigger_config(ADC1, TIM2, STREAM_RATE_HZ);
+    adc_stream_start(ADC1, stream_buffer, STREAM_LENGTH, on_stream);
+    adc_trigger_start(TIM2);
+
+    sim_advance(((uint64_t)STREAM_LENGTH * PERIOD_CYCLES) + SETTLE_CYCLES);
+    CHECK(stream_calls == 2u);      /* half and full transfer */
+    CHECK(stream_samples == STREAM_LENGTH);
+    CHECK(adc_stream_get_write_index(ADC1) == 0u);
+    for (uint32_t i = 1u; i < STREAM_LENGTH; i++) {
+        CHECK(stream_buffer[i] == (uint16_t)(stream_buffer[i - 1u] + 1u));     /* one sample per period, none skipped */
+    }
+
+    sim_advance(10u * PERIOD_CYCLES);
+    CHECK(adc_stream_get_write_index(ADC1) == 10u);
+    CHECK(adc_stream_get_latest(ADC1) == (uint16_t)(stream_buffer[STREAM_LENGTH - 1u] + 10u));
+
+    adc_stream_stop(ADC1);
+    adc_trigger_stop(TIM2);
+    CHECK((DMA2_Stream0->CR & DMA_SxCR_EN) == 0u);
+}
+
+static void test_uart(void) {
+    char line[32];
+
+    reset();
+    USART2_quick_default_config();
+
+    uint64_t start = sim_cycles();
+    UART2_sendString("hi");
+    CHECK((captured.length == 2u) && (memcmp(captured.data, "hi", 2u) == 0));
+    CHECK((sim_cycles() - start) >= (2u * FRAME_CYCLES_115200));
+    CHECK((sim_cycles() - start) <= (2u * FRAME_CYCLES_115200) + (2u * SIM_STEP_CYCLES));
+
+    captured.length = 0u;
+    USART2_dma_tx_init();
+    CHECK(USART2_dma_write("hello, world", 12u) == 12u);
+    CHECK(USART2_tx_busy());
+    sim_advance(13u * FRAME_CYCLES_115200);
+    CHECK((captured.length == 12u) && (memcmp(captured.data, "hello, world", 12u) == 0));
+    CHECK(!USART2_tx_busy());
+
+    USART2_rx_interrupt_init();
+    CHECK(sim_uart_inject((const uint8_t*)"RATE 100\r", 9u) == 9u);
+    sim_advance(8u * FRAME_CYCLES_115200);
+    CHECK(USART2_read_line(line, sizeof(line)) == 0u);  /* the CR is still on the wire */
+    sim_advance(2u * FRAME_CYCLES_115200);
+    CHECK(USART2_read_line(line, sizeof(line)) == 8u);
+    CHECK(strcmp(line, "RATE 100") == 0);
+    CHECK(USART2_rx_dropped() == 0u);
+    CHECK(sim_stats()->uart_rx_bytes == 9u);
+}
+
+// Divider, OVER8, BRR mantissa/fraction and error of USART2_set_baud_rate()
+static void test_baud_rates(void) {
+    const struct {
+        uint32_t baud_rate;
+        uint32_t brr;
+        uint8_t over8;
+        uint32_t actual;
+        int32_t error_ppm;
+    } rates[] = {
+        { 115200u,              0x187u,  0u, 115089u,  -963 },     /* divider 391 = 24 + 7/16 */
+        { USART2_MIN_BAUD_RATE, 0xFFDEu, 0u, 687u,     0 },        /* divider 65502, the widest that fits */
+        { 3000000u,             0x017u,  1u, 3000000u, 0 },        /* divider 15 = 8 x (1 + 7/8) */
+        { USART2_MAX_BAUD_RATE, 0x010u,  1u, 5625000u, 0 },        /* divider 8, USARTDIV 1 */
+    };
+    int32_t error_ppm;
+
+    // one below the minimum would need a 17-bit divider
+    CHECK(USART2_MIN_BAUD_RATE == 687u);
+    CHECK(((APB1_FREQ + ((USART2_MIN_BAUD_RATE - 1u) / 2u)) / (USART2_MIN_BAUD_RATE - 1u)) > 0xFFFFu);
+
+    reset();
+    USART2_quick_default_config();
+    for (uint32_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        error_ppm = 1;
+        CHECK(USART2_set_baud_rate(rates[i].baud_rate, &error_ppm) == rates[i].actual);
+        CHECK(USART2->BRR == rates[i].brr);
+        CHECK(((USART2->CR1 & USART_CR1_OVER8) != 0u) == rates[i].over8);
+        CHECK((USART2->CR1 & USART_CR1_UE) != 0u);  /* re-enabled after the change */
+        CHECK(error_ppm == rates[i].error_ppm);
+    }
+    USART2_set_default_baud_rate();
+    CHECK((USART2->BRR == 0x187u) && ((USART2->CR1 & USART_CR1_OVER8) == 0u));
+}
+
+// Runs TIM2 at rate_hz with the strobe started, logs PB5 until just before the (n + 1)th trigger
+static void run_strobe(uint32_t rate_hz, uint32_t width_ns, uint32_t phase_ns, uint32_t n, Pulse_Log_Type* log) {
+    reset();
+    memset(log, 0, sizeof(*log));
+    adc_trigger_config(ADC1, TIM2, rate_hz);
+    CHECK(strobe_start(&width_ns, &phase_ns) == 1u);
+    sim_sync();
+    TIM2->SR = 0u;
+    sim_set_step_hook(log_pulses, log);
+    adc_trigger_start(TIM2);
+    sim_advance((((uint64_t)n + 1u) * (HCLK_FREQ / rate_hz)) - 1u);
+    sim_set_step_hook(NULL, NULL);
+    adc_trigger_stop(TIM2);
+}
+
+static void test_strobe(void) {
+    Pulse_Log_Type log;
+    uint32_t width_ns = 1000u;
+    uint32_t phase_ns = 2000u;
+
+    // 90 and 180 ticks at 90 MHz, no prescaler
+    reset();
+    CHECK(strobe_start(&width_ns, &phase_ns) == 1u);
+    CHECK((width_ns == 1000u) && (phase_ns == 2000u));
+    CHECK(strobe_running() && (strobe_get_span_ns() == 3000u));
+    CHECK((TIM3->PSC == 0u) && (TIM3->CCR2 == 180u) && (TIM3->ARR == 269u));
+    CHECK(((TIM3->CCMR1 & TIM_CCMR1_OC2M) / TIM_CCMR1_OC2M_0) == 7u);      /* PWM mode 2 */
+    CHECK((TIM3->CCMR1 & TIM_CCMR1_CC2S) == 0u);
+    CHECK((TIM3->CCER & (TIM_CCER_CC2E | TIM_CCER_CC2P)) == TIM_CCER_CC2E);
+    CHECK(TIM3->CR1 == TIM_CR1_OPM);
+    CHECK(((TIM3->SMCR & TIM_SMCR_TS) / TIM_SMCR_TS_0) == 1u);              /* ITR1 = TIM2 TRGO */
+    CHECK(((TIM3->SMCR & TIM_SMCR_SMS) / TIM_SMCR_SMS_0) == 6u);            /* trigger mode */
+    CHECK(((GPIOB->MODER >> 10) & 3u) == 2u);
+    CHECK(((GPIOB->AFR[0] >> 20) & 0xFu) == 2u);
+
+    // to the nearest tick, the phase at least one
+    width_ns = 100u;
+    phase_ns = 0u;
+    CHECK(strobe_round(&width_ns, &phase_ns) == 1u);
+    CHECK((width_ns == 100u) && (phase_ns == 11u));
+    width_ns = 17u;
+    phase_ns = 5u;
+    CHECK(strobe_round(&width_ns, &phase_ns) == 1u);
+    CHECK((width_ns == 22u) && (phase_ns == 11u));
+    width_ns = 0u;
+    phase_ns = 100u;
+    CHECK(strobe_round(&width_ns, &phase_ns) == 0u);
+    CHECK(strobe_running() && (TIM3->CCR2 == 180u));    /* rounding leaves the timer alone */
+
+    // 1 + 65535 ticks still fit the counter, 1 + 65536 need a prescaler of 2
+    width_ns = 728167u;
+    phase_ns = 0u;
+    CHECK(strobe_start(&width_ns, &phase_ns) == 1u);
+    CHECK((TIM3->PSC == 0u) && (TIM3->CCR2 == 1u) && (TIM3->ARR == 65535u));
+    width_ns = 728178u;
+    CHECK(strobe_start(&width_ns, &phase_ns) == 1u);
+    CHECK((TIM3->PSC == 1u) && (TIM3->CCR2 == 1u) && (TIM3->ARR == 32768u));
+    CHECK((width_ns == 728178u) && (phase_ns == 22u));
+
+    // the longest requests still fit: 32-bit ns never need a prescaler above 0xFFFF
+    width_ns = UINT32_MAX;
+    phase_ns = UINT32_MAX;
+    CHECK(strobe_start(&width_ns, &phase_ns) == 1u);
+    CHECK((TIM3->PSC > 0u) && (TIM3->PSC <= 0xFFFFu) && (TIM3->ARR <= 0xFFFFu));
+    CHECK((width_ns <= UINT32_MAX) && ((UINT32_MAX - width_ns) < (TIM3->PSC * 12u)));
+    CHECK((UINT32_MAX - phase_ns) < (TIM3->PSC * 12u));
+
+    // edges: rising phase after every TIM2 update, falling width later
+    run_strobe(STREAM_RATE_HZ, 1000u, 2000u, 4u, &log);
+    CHECK((log.num_of_triggers == 4u) && (log.num_of_rises == 4u) && (log.num_of_falls == 4u));
+    for (uint32_t i = 0; i < log.num_of_rises; i++) {
+        CHECK((log.rises[i] - log.triggers[i]) == (180u * TICK_CYCLES));
+        CHECK((log.falls[i] - log.rises[i]) == (90u * TICK_CYCLES));
+    }
+    CHECK((log.rises[1] - log.rises[0]) == PERIOD_CYCLES);
+    CHECK(log.level == 0u);
+
+    // prescaled: 1 ms high from 2 ticks after the trigger
+    run_strobe(500u, 1000000u, 0u, 3u, &log);
+    CHECK((log.num_of_rises == 3u) && (log.num_of_falls == 3u));
+    for (uint32_t i = 0; i < log.num_of_rises; i++) {
+        CHECK((log.rises[i] - log.triggers[i]) == (2u * TICK_CYCLES));
+        CHECK((log.falls[i] - log.rises[i]) == (CYCLES_PER_MS));
+    }
+
+    // a pulse longer than the period swallows every other trigger
+    run_strobe(STREAM_RATE_HZ, 60000u, 50000u, 8u, &log);
+    CHECK((log.num_of_triggers == 8u) && (log.num_of_rises == 4u));
+    CHECK((log.rises[1] - log.rises[0]) == (2u * PERIOD_CYCLES));
+
+    // stopped: no more edges, the pin stays low
+    run_strobe(STREAM_RATE_HZ, 1000u, 2000u, 1u, &log);
+    strobe_stop();
+    CHECK(!strobe_running() && (strobe_get_span_ns() == 0u));
+    memset(&log, 0, sizeof(log));
+    sim_set_step_hook(log_pulses, &log);
+    adc_trigger_start(TIM2);
+    sim_advance(4u * PERIOD_CYCLES);
+    sim_set_step_hook(NULL, NULL);
+    CHECK((log.num_of_triggers == 4u) && (log.num_of_rises == 0u));
+    CHECK((GPIOB->IDR & (1u << 5)) == 0u);
+    adc_trigger_stop(TIM2);
+}
+
+
+int main(void) {
+    test_clock_and_systick();
+    test_gpio();
+    test_polled_adc();
+    test_triggered_interrupts();
+    test_trigger_sources();
+    test_scan_sequence();
+    test_paced_stream();
+    test_uart();
+    test_baud_rates();
+    test_strobe();
+
+    if (failures != 0u) {
+        printf("sim_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("sim_test: PASS\n");
+    return 0;
+}
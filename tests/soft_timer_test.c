@@ -0,0 +1,160 @@
+/**
+ * @file: soft_timer_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/soft_timer.c: one-shot and periodic expiries, timers more
+ * than one wheel turn away, late polls, wrap of the millisecond counter and
+ * callbacks that start or stop timers of the slot being scanned.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tests/soft_timer_test.c Src/soft_timer.c -o soft_timer_test && ./soft_timer_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "soft_timer.h"
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+typedef struct {
+    uint32_t calls;
+    uint32_t last_tick;
+} Probe_Type;
+
+static uint32_t now;
+
+static void count(void* context) {
+    Probe_Type* probe = context;
+    probe->calls++;
+    probe->last_tick = now;
+}
+
+// Advances the clock one millisecond at a time, polling every step
+static void run_to(uint32_t target) {
+    while (now != target) {
+        now++;
+        soft_timer_poll(now);
+    }
+}
+
+
+static void test_one_shot_and_periodic(void) {
+    static Soft_Timer_Type once, every;
+    Probe_Type a = {0}, b = {0};
+
+    now = 1000u;
+    soft_timer_init(now);
+    soft_timer_start(&once, 5u, 0u, count, &a);
+    soft_timer_start(&every, 3u, 3u, count, &b);
+
+    run_to(1004u);
+    CHECK(a.calls == 0u);
+    CHECK(b.calls == 1u);
+    run_to(1005u);
+    CHECK((a.calls == 1u) && (a.last_tick == 1005u));
+    CHECK(!soft_timer_active(&once));
+
+    run_to(1030u);
+    CHECK(a.calls == 1u);
+    CHECK(b.calls == 10u);
+    CHECK(soft_timer_active(&every));
+
+    soft_timer_stop(&every);
+    run_to(1040u);
+    CHECK(b.calls == 10u);
+    soft_timer_stop(&every);    /* stopping twice is harmless */
+}
+
+static void test_long_delay(void) {
+    static Soft_Timer_Type far, near;
+    Probe_Type a = {0}, b = {0};
+
+    now = 0u;
+    soft_timer_init(now);
+    soft_timer_start(&far, (3u * SOFT_TIMER_WHEEL_SIZE) + 1u, 0u, count, &a);
+    soft_timer_start(&near, 1u, 0u, count, &b);  /* same slot, earlier turn */
+
+    run_to(1u);
+    CHECK((b.calls == 1u) && (a.calls == 0u));
+    run_to(3u * SOFT_TIMER_WHEEL_SIZE);
+    CHECK(a.calls == 0u);
+    run_to((3u * SOFT_TIMER_WHEEL_SIZE) + 1u);
+    CHECK(a.calls == 1u);
+}
+
+static void test_late_poll(void) {
+    static Soft_Timer_Type every;
+    Probe_Type a = {0};
+
+    now = 0u;
+    soft_timer_init(now);
+    soft_timer_start(&every, 10u, 10u, count, &a);
+
+    CHECK(soft_timer_poll(95u) == 9u);  /* all missed expiries run, none is merged */
+    now = 95u;
+    run_to(100u);
+    CHECK(a.calls == 10u);
+}
+
+static void test_wrap(void) {
+    static Soft_Timer_Type every;
+    Probe_Type a = {0};
+
+    now = 0xFFFFFFF0u;
+    soft_timer_init(now);
+    soft_timer_start(&every, 20u, 20u, count, &a);
+
+    run_to(3u);
+    CHECK(a.calls == 0u);
+    run_to(4u);
+    CHECK((a.calls == 1u) && (a.last_tick == 4u));
+    run_to(24u);
+    CHECK(a.calls == 2u);
+}
+
+static Soft_Timer_Type chain[3];
+static uint32_t chain_calls[3];
+
+// Stops its successor and re-arms itself, both in the slot being scanned
+static void chained(void* context) {
+    uint32_t i = (uint32_t)(uintptr_t)context;
+
+    chain_calls[i]++;
+    soft_timer_stop(&chain[(i + 1u) % 3u]);
+    soft_timer_start(&chain[i], SOFT_TIMER_WHEEL_SIZE, 0u, chained, context);
+}
+
+static void test_callbacks_modify_wheel(void) {
+    now = 0u;
+    memset(chain, 0, sizeof(chain));
+    soft_timer_init(now);
+    for (uint32_t i = 0; i < 3u; i++) {
+        soft_timer_start(&chain[i], 5u, 0u, chained, (void*)(uintptr_t)i);
+    }
+
+    run_to(5u);
+    // whichever ran first stopped exactly one of the other two
+    CHECK((chain_calls[0] + chain_calls[1] + chain_calls[2]) == 2u);
+    run_to(5u + SOFT_TIMER_WHEEL_SIZE);
+    CHECK((chain_calls[0] + chain_calls[1] + chain_calls[2]) >= 3u);
+}
+
+
+int main(void) {
+    test_one_shot_and_periodic();
+    test_long_delay();
+    test_late_poll();
+    test_wrap();
+    test_callbacks_modify_wheel();
+
+    if (failures != 0u) {
+        printf("soft_timer_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("soft_timer_test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file: telemetry_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for the telemetry framing: the CRC-16/CCITT-FALSE check value,
+ * COBS round trips including runs of 254 and more non-zero bytes, frame
+ * round trips for every encoding (and the fall back from DELTA to PACKED12),
+ * and rejection of corrupted, truncated and malformed frames.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tests/telemetry_test.c Src/telemetry.c Src/pack12.c Src/delta_codec.c \
+ *       Src/cobs.c Src/crc16.c -o telemetry_test && ./telemetry_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "telemetry.h"
+#include "crc16.h"
+
+#define MAX_PACKET  1024u
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+static uint32_t rng_state = 4242u;
+
+static uint32_t next_random(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 16;
+}
+
+static uint8_t packet[MAX_PACKET];
+static uint8_t encoded[COBS_MAX_ENCODED_LENGTH(MAX_PACKET)];
+static uint8_t decoded[COBS_MAX_ENCODED_LENGTH(MAX_PACKET)];
+
+// Encodes length bytes of packet, checks the size bound, the absence of 0x00 and the round trip
+static uint32_t cobs_round_trip(uint32_t length) {
+    uint32_t encoded_length = cobs_encode(packet, length, encoded);
+
+    CHECK(encoded_length <= COBS_MAX_ENCODED_LENGTH(length));
+    CHECK(memchr(encoded, COBS_DELIMITER, encoded_length) == NULL);
+    CHECK(cobs_decode(encoded, encoded_length, decoded) == length);
+    CHECK(memcmp(decoded, packet, length) == 0);
+    return encoded_length;
+}
+
+
+static void test_crc16(void) {
+    const uint8_t check[] = "123456789";
+
+    CHECK(crc16_ccitt(check, 9u) == 0x29B1u);
+    CHECK(crc16_ccitt(check, 0u) == CRC16_CCITT_INIT);
+    CHECK(crc16_ccitt_update(crc16_ccitt(check, 4u), &check[4], 5u) == 0x29B1u);    /* in two parts */
+}
+
+static void test_cobs(void) {
+    const uint8_t zeros[3] = {0, 0, 0};
+    const uint8_t zeros_expected[4] = {1, 1, 1, 1};
+
+    memcpy(packet, zeros, sizeof(zeros));
+    CHECK(cobs_round_trip(sizeof(zeros)) == 4u);
+    CHECK(memcmp(encoded, zeros_expected, sizeof(zeros_expected)) == 0);
+
+    // runs of non-zero bytes around the 254-byte block limit
+    const uint32_t runs[] = {253u, 254u, 255u, 508u, 509u, MAX_PACKET};
+    for (uint32_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        for (uint32_t i = 0; i < runs[r]; i++) {
+            packet[i] = (uint8_t)((i % 255u) + 1u);
+        }
+        cobs_round_trip(runs[r]);
+    }
+    for (uint32_t i = 0; i < 254u; i++) {
+        packet[i] = 0x55u;
+    }
+    CHECK(cobs_round_trip(254u) == 256u);   /* one full 0xFF block and a closing code */
+    CHECK((encoded[0] == 0xFFu) && (encoded[255] == 1u));
+
+    // full run followed by a zero
+    packet[254] = 0u;
+    packet[255] = 0x66u;
+    cobs_round_trip(256u);
+
+    // random packets with zeros anywhere
+    for (uint32_t round = 0; round < 100u; round++) {
+        uint32_t length = 1u + (next_random() % MAX_PACKET);
+        for (uint32_t i = 0; i < length; i++) {
+            packet[i] = ((next_random() % 8u) == 0u)? 0u: (uint8_t)next_random();
+        }
+        cobs_round_trip(length);
+    }
+
+    // a code byte pointing past the end, and a stray zero
+    const uint8_t overrun[3] = {5, 1, 2};
+    const uint8_t stray_zero[3] = {2, 1, 0};
+    CHECK(cobs_decode(overrun, sizeof(overrun), decoded) == 0u);
+    CHECK(cobs_decode(stray_zero, sizeof(stray_zero), decoded) == 0u);
+}
+
+// Encodes samples with the given type, checks the frame and the round trip, returns the decoded type
+static uint8_t frame_round_trip(uint8_t type, uint8_t bits, const uint16_t* samples, uint8_t count) {
+    Telemetry_Header_Type header = {
+        .type = type,
+        .sequence = 0xBEEFu,
+        .timestamp = 0x12345678u,
+        .channel_mask = 0x8002u,
+        .num_of_samples = count,
+        .bits = bits,
+    };
+    Telemetry_Header_Type result;
+    uint16_t output[TELEMETRY_MAX_SAMPLES];
+    uint8_t frame[TELEMETRY_MAX_FRAME_LENGTH];
+
+    uint32_t length = telemetry_encode_frame(&header, samples, frame);
+    CHECK(length <= TELEMETRY_MAX_FRAME_LENGTH);
+    CHECK(frame[length - 1u] == COBS_DELIMITER);
+    CHECK(memchr(frame, COBS_DELIMITER, length - 1u) == NULL);
+
+    memset(&result, 0, sizeof(result));
+    CHECK(telemetry_decode_frame(frame, length - 1u, &result, output) == 1u);
+    CHECK((result.sequence == 0xBEEFu) && (result.timestamp == 0x12345678u) && (result.channel_mask == 0x8002u));
+    CHECK(result.num_of_samples == count);
+    CHECK(memcmp(output, samples, count * sizeof(samples[0])) == 0);
+    return result.type;
+}
+
+static void test_frames(void) {
+    uint16_t slow[TELEMETRY_MAX_SAMPLES];
+    uint16_t noise[TELEMETRY_MAX_SAMPLES];
+    uint16_t wide[TELEMETRY_MAX_SAMPLES];
+
+    for (uint32_t i = 0; i < TELEMETRY_MAX_SAMPLES; i++) {
+        slow[i] = (uint16_t)(2048u + (i % 5u));
+        noise[i] = (uint16_t)(next_random() & 0xFFFu);
+        wide[i] = (uint16_t)next_random();
+    }
+
+    for (uint8_t count = 0; count <= TELEMETRY_MAX_SAMPLES; count++) {
+        CHECK(frame_round_trip(TELEMETRY_TYPE_PACKED12, 12u, noise, count) == TELEMETRY_TYPE_PACKED12);
+        CHECK(frame_round_trip(TELEMETRY_TYPE_WIDE16, 16u, wide, count) == TELEMETRY_TYPE_WIDE16);
+        frame_round_trip(TELEMETRY_TYPE_DELTA, 12u, noise, count);
+    }
+    CHECK(frame_round_trip(TELEMETRY_TYPE_DELTA, 12u, slow, TELEMETRY_MAX_SAMPLES) == TELEMETRY_TYPE_DELTA);
+    CHECK(frame_round_trip(TELEMETRY_TYPE_DELTA, 12u, noise, TELEMETRY_MAX_SAMPLES) == TELEMETRY_TYPE_PACKED12);
+}
+
+static void test_rejection(void) {
+    Telemetry_Header_Type header = {
+        .type = TELEMETRY_TYPE_DELTA,
+        .sequence = 1u,
+        .timestamp = 2u,
+        .channel_mask = 2u,
+        .num_of_samples = 32u,
+    };
+    Telemetry_Header_Type result;
+    uint16_t samples[TELEMETRY_MAX_SAMPLES];
+    uint16_t output[TELEMETRY_MAX_SAMPLES];
+    uint8_t frame[TELEMETRY_MAX_FRAME_LENGTH];
+    uint8_t corrupted[TELEMETRY_MAX_FRAME_LENGTH];
+
+    for (uint32_t i = 0; i < TELEMETRY_MAX_SAMPLES; i++) {
+        samples[i] = (uint16_t)(1000u + (i * 3u));
+    }
+    uint32_t length = telemetry_encode_frame(&header, samples, frame) - 1u;     /* without the delimiter */
+    CHECK(telemetry_decode_frame(frame, length, &result, output) == 1u);
+
+    // every single-bit error is caught
+    uint32_t accepted = 0u;
+    for (uint32_t i = 0; i < length; i++) {
+        for (uint8_t bit = 0; bit < 8u; bit++) {
+            memcpy(corrupted, frame, length);
+            corrupted[i] ^= (uint8_t)(1u << bit);
+            accepted += telemetry_decode_frame(corrupted, length, &result, output);
+        }
+    }
+    CHECK(accepted == 0u);
+
+    // every truncation is caught
+    accepted = 0u;
+    for (uint32_t cut = 0; cut < length; cut++) {
+        accepted += telemetry_decode_frame(frame, cut, &result, output);
+    }
+    CHECK(accepted == 0u);
+
+    // longer than any frame
+    CHECK(telemetry_decode_frame(frame, TELEMETRY_MAX_FRAME_LENGTH + 1u, &result, output) == 0u);
+
+    // well-formed packets with a valid CRC but bad contents
+    uint8_t raw[TELEMETRY_MAX_PACKET_LENGTH];
+    uint8_t encoded_raw[TELEMETRY_MAX_FRAME_LENGTH];
+    const uint8_t bad_types[] = {0x00u, 0x04u, 0xFFu};
+    memset(raw, 0, sizeof(raw));
+    raw[9] = 2u;                                    /* two samples, three packed bytes */
+    for (uint32_t t = 0; t < sizeof(bad_types); t++) {
+        raw[0] = bad_types[t];
+        uint16_t crc = crc16_ccitt(raw, TELEMETRY_HEADER_LENGTH + 3u);
+        raw[TELEMETRY_HEADER_LENGTH + 3u] = (uint8_t)crc;
+        raw[TELEMETRY_HEADER_LENGTH + 4u] = (uint8_t)(crc >> 8);
+        uint32_t raw_length = cobs_encode(raw, TELEMETRY_HEADER_LENGTH + 5u, encoded_raw);
+        CHECK(telemetry_decode_frame(encoded_raw, raw_length, &result, output) == 0u);
+    }
+
+    raw[0] = TELEMETRY_TYPE_PACKED12;
+    raw[9] = TELEMETRY_MAX_SAMPLES + 2u;            /* more samples than a packet may carry */
+    uint16_t crc = crc16_ccitt(raw, TELEMETRY_HEADER_LENGTH + 3u);
+    raw[TELEMETRY_HEADER_LENGTH + 3u] = (uint8_t)crc;
+    raw[TELEMETRY_HEADER_LENGTH + 4u] = (uint8_t)(crc >> 8);
+    uint32_t raw_length = cobs_encode(raw, TELEMETRY_HEADER_LENGTH + 5u, encoded_raw);
+    CHECK(telemetry_decode_frame(encoded_raw, raw_length, &result, output) == 0u);
+
+    raw[9] = 3u;                                    /* three samples need five packed bytes */
+    crc = crc16_ccitt(raw, TELEMETRY_HEADER_LENGTH + 3u);
+    raw[TELEMETRY_HEADER_LENGTH + 3u] = (uint8_t)crc;
+    raw[TELEMETRY_HEADER_LENGTH + 4u] = (uint8_t)(crc >> 8);
+    raw_length = cobs_encode(raw, TELEMETRY_HEADER_LENGTH + 5u, encoded_raw);
+    CHECK(telemetry_decode_frame(encoded_raw, raw_length, &result, output) == 0u);
+}
+
+
+int main(void) {
+    test_crc16();
+    test_cobs();
+    test_frames();
+    test_rejection();
+
+    if (failures != 0u) {
+        printf("telemetry_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("telemetry_test: PASS\n");
+    return 0;
+}
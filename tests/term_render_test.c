@@ -0,0 +1,185 @@
+/**
+ * @file: term_render_test.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host test for Src/term_render.c. The rendered bytes are replayed through
+ * a minimal ANSI terminal model (cursor position, SGR color, clear) and the
+ * resulting screen must match what was drawn, for full redraws, single
+ * changes, color flips and output split over many small buffers.
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tests/term_render_test.c Src/term_render.c Src/fmt.c \
+ *       -o term_render_test && ./term_render_test
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "term_render.h"
+
+static uint32_t failures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+// Terminal model: the screen the user would see
+static char model_chars[TERM_ROWS][TERM_COLS];
+static char model_sgr[TERM_ROWS][TERM_COLS][8];
+static char model_color[8];
+static uint32_t model_row, model_col;
+
+static void model_clear(void) {
+    memset(model_chars, ' ', sizeof(model_chars));
+    for (uint32_t r = 0; r < TERM_ROWS; r++) {
+        for (uint32_t c = 0; c < TERM_COLS; c++) {
+            strcpy(model_sgr[r][c], "0");
+        }
+    }
+    strcpy(model_color, "0");
+    model_row = 0;
+    model_col = 0;
+}
+
+static void model_feed(const char* bytes, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        if (bytes[i] != '\033') {
+            CHECK((model_row < TERM_ROWS) && (model_col < TERM_COLS));
+            if ((model_row < TERM_ROWS) && (model_col < TERM_COLS)) {
+                model_chars[model_row][model_col] = bytes[i];
+                strcpy(model_sgr[model_row][model_col], model_color);
+            }
+            model_col++;
+            continue;
+        }
+
+        // ESC [ parameters final
+        char parameters[16];
+        uint32_t n = 0;
+        i += 2u;
+        while ((i < length) && (((bytes[i] >= '0') && (bytes[i] <= '9')) || (bytes[i] == ';') || (bytes[i] == '?'))) {
+            parameters[n++] = bytes[i++];
+        }
+        parameters[n] = '\0';
+
+        switch (bytes[i]) {
+        case 'H': {
+            unsigned row = 1, col = 1;
+            sscanf(parameters, "%u;%u", &row, &col);
+            model_row = row - 1u;
+            model_col = col - 1u;
+            break;
+        }
+        case 'J':
+            model_clear();
+            break;
+        case 'm':
+            strcpy(model_color, parameters);
+            break;
+        default:
+            break;  /* cursor visibility */
+        }
+    }
+}
+
+// Compares the model with the back screen; colors must map to the same SGR code
+static uint8_t model_matches(const Term_Render_Type* term) {
+    static const char* const sgr[TERM_COLOR_COUNT] = {"0", "0;96", "1;91", "1;92", "1;94", "1;97"};
+
+    for (uint32_t r = 0; r < TERM_ROWS; r++) {
+        for (uint32_t c = 0; c < TERM_COLS; c++) {
+            if ((model_chars[r][c] != term->back.chars[r][c]) ||
+                (strcmp(model_sgr[r][c], sgr[term->back.colors[r][c]]) != 0)) {
+                printf("  mismatch at %u,%u\n", r, c);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+static uint32_t render(Term_Render_Type* term, uint32_t chunk) {
+    char output[4096];
+    uint32_t total = 0;
+    uint32_t length;
+
+    do {
+        length = term_render(term, output, chunk);
+        model_feed(output, length);
+        total += length;
+    } while (length != 0u);
+
+    return total;
+}
+
+static void draw_box(Term_Render_Type* term, const char* value, uint8_t color) {
+    term_put_text(term, 0, 0, "Max: 4095", TERM_COLOR_BOLD_RED);
+    term_put_text(term, 0, 24, ".____________________________.", TERM_COLOR_CYAN);
+    term_put_text(term, 1, 0, "Min: 0", TERM_COLOR_BOLD_GREEN);
+    term_put_text(term, 2, 24, "|", TERM_COLOR_CYAN);
+    term_put_text(term, 2, 26, "D I G I T A L    V A L U E", TERM_COLOR_BOLD_WHITE);
+    term_put_text(term, 2, 53, "|", TERM_COLOR_CYAN);
+    term_put_text(term, 6, 24, "|            ", TERM_COLOR_CYAN);
+    term_put_text(term, 6, 37, value, color);
+    term_put_text(term, 6, 41, "            |", TERM_COLOR_CYAN);
+}
+
+
+static void test_full_then_incremental(void) {
+    static Term_Render_Type term;
+
+    term_init(&term);
+    model_clear();
+
+    draw_box(&term, "0123", TERM_COLOR_BOLD_GREEN);
+    uint32_t full = render(&term, 4096);
+    CHECK(model_matches(&term));
+
+    CHECK(render(&term, 4096) == 0u);   /* nothing changed, nothing sent */
+
+    draw_box(&term, "0124", TERM_COLOR_BOLD_GREEN);
+    uint32_t one_digit = render(&term, 4096);
+    CHECK(model_matches(&term));
+    CHECK(one_digit <= 16u);    /* ESC[7;41H, the digit color and one character */
+
+    draw_box(&term, "2048", TERM_COLOR_BOLD_BLUE);
+    uint32_t flip = render(&term, 4096);
+    CHECK(model_matches(&term));
+    CHECK(flip <= 24u);         /* move, color, four digits */
+    CHECK(flip * 10u < full);
+
+    printf("  full %u bytes, one digit %u bytes, color flip %u bytes\n", full, one_digit, flip);
+}
+
+static void test_small_chunks(void) {
+    static Term_Render_Type term;
+
+    term_init(&term);
+    model_clear();
+
+    draw_box(&term, "4095", TERM_COLOR_BOLD_RED);
+    render(&term, TERM_MIN_OUTPUT_SIZE);
+    CHECK(model_matches(&term));
+
+    for (uint32_t value = 0; value < 4096u; value += 97u) {
+        char digits[5];
+        snprintf(digits, sizeof(digits), "%-4u", value);
+        draw_box(&term, digits, (value < 1000u)? TERM_COLOR_BOLD_GREEN: TERM_COLOR_BOLD_BLUE);
+        render(&term, TERM_MIN_OUTPUT_SIZE);
+        CHECK(model_matches(&term));
+    }
+
+    CHECK(term_render(&term, (char[8]){0}, 8) == 0u);   /* below the minimum, nothing is emitted */
+}
+
+
+int main(void) {
+    test_full_then_incremental();
+    test_small_chunks();
+
+    if (failures != 0u) {
+        printf("term_render_test: %u failure(s)\n", failures);
+        return 1;
+    }
+    printf("term_render_test: PASS\n");
+    return 0;
+}
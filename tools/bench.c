@@ -0,0 +1,523 @@
+/**
+ * @file: bench.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Micro-benchmarks of the paths that bound the sustained sample rate: the
+ * sample ring between the ADC interrupt and the main loop, 12-bit packing,
+ * delta coding, oversampling, CRC, COBS and complete telemetry frames on the way out, the
+ * table formatting and rendering, and (on the target) GPIO writes.
+ *
+ * The same file runs in two places:
+ *   - on the host (HOST_BUILD), timed with CLOCK_MONOTONIC, in nanoseconds;
+ *   - on the board, built in place of Src/main.c like tests/gpio_bench.c,
+ *     timed with DWT->CYCCNT, in HCLK cycles, printed on USART2 (115200 8N1)
+ *     once at reset.
+ *
+ * Every case runs BENCH_ROUNDS batches; the output is CSV, one line per case,
+ * with the fastest and the median batch as time per call:
+ *
+ *   name,items,iterations,unit,min,median
+ *
+ * where items is the number of samples (or bytes, or pins) one call handles.
+ * The "overhead" line is an empty call through the same loop. On the host,
+ * giving a previous result file compares the medians with it and exits with
+ * status 1 if a case got slower by more than the tolerance (10 % by default).
+ *
+ * Build & run (host):
+ *   gcc -std=gnu11 -O2 -IInc -DHOST_BUILD tools/bench.c Src/sample_ring.c Src/pack12.c \
+ *       Src/delta_codec.c Src/crc16.c Src/cobs.c Src/telemetry.c Src/fmt.c Src/term_render.c \
+ *       Src/oversample.c -o bench && ./bench [baseline.csv [tolerance_percent]]
+ *
+ * Build (target): make bench_target
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "sample_ring.h"
+#include "pack12.h"
+#include "delta_codec.h"
+#include "crc16.h"
+#include "cobs.h"
+#include "telemetry.h"
+#include "fmt.h"
+#include "term_render.h"
+#include "oversample.h"
+
+#ifdef HOST_BUILD
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#else
+#include "pll.h"
+#include "gpio.h"
+#include "usart.h"
+#endif
+
+#define BENCH_ROUNDS        9u
+#define BENCH_SAMPLES       32u     /* one telemetry frame, half of DAQ_STREAM_LENGTH */
+#define BENCH_LINE_SIZE     96u
+
+#ifdef HOST_BUILD
+#define BENCH_UNIT          "ns"
+#define BENCH_EOL           "\n"
+#define BENCH_SCALE         100u    /* host calls are timed in bigger batches */
+#define BENCH_TOLERANCE     10u
+#else
+#define BENCH_UNIT          "cycles"
+#define BENCH_EOL           "\r\n"
+#define BENCH_SCALE         1u
+#endif
+
+
+typedef struct {
+    const char* name;
+    uint32_t items;                             /* samples, bytes or pins handled per call */
+    uint32_t iterations;                        /* calls per batch on the target */
+    uint32_t (*run)(uint32_t iterations);       /* returns a checksum, so nothing is optimised out */
+} Bench_Case_Type;
+
+typedef struct {
+    const char* name;
+    uint32_t min_x100;      /* time per call, hundredths of BENCH_UNIT */
+    uint32_t median_x100;
+} Bench_Result_Type;
+
+
+static volatile uint32_t bench_sink;
+static Sample_Ring_Type ring;
+static uint16_t slow_samples[BENCH_SAMPLES];    /* a slow triangle: delta coding pays */
+static uint16_t fast_samples[BENCH_SAMPLES];    /* full-scale noise: delta coding falls back */
+static uint8_t bytes[TELEMETRY_MAX_FRAME_LENGTH];
+static uint8_t output[TELEMETRY_MAX_FRAME_LENGTH];
+static Term_Render_Type screen;
+static Oversample_Type stage;
+
+
+/*
+ * Time base
+ */
+
+#ifdef HOST_BUILD
+static uint32_t bench_ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+static void bench_print(const char* line) {
+    fputs(line, stdout);
+}
+#else
+static uint32_t bench_ticks(void) {
+    return DWT->CYCCNT;
+}
+
+static void bench_print(const char* line) {
+    UART2_sendString((char*)line);
+}
+#endif
+
+
+/*
+ * Cases
+ */
+
+__attribute__((noinline)) static uint32_t empty(uint32_t i) {
+    __asm volatile ("" :: "r" (i));
+    return i;
+}
+
+static uint32_t run_overhead(uint32_t iterations) {
+    uint32_t sum = 0u;
+    for (uint32_t i = 0; i < iterations; i++) {
+        sum += empty(i);
+    }
+    return sum;
+}
+
+// One push and one pop, the steady state of the ADC interrupt and the main loop
+static uint32_t run_ring_push_pop(uint32_t iterations) {
+    ADC_Sample_Type sample = { .timestamp = 0u, .value = 0u, .adc = 0u, .reserved = 0u };
+    uint32_t sum = 0u;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        sample.value = (uint16_t)(i & 0xFFFu);
+        sample_ring_push(&ring, &sample);
+        sample_ring_pop(&ring, &sample);
+        sum += sample.value;
+    }
+    return sum;
+}
+
+// A burst filling part of the ring, then drained, as when the main loop was busy
+static uint32_t run_ring_burst(uint32_t iterations) {
+    ADC_Sample_Type sample = { .timestamp = 0u, .value = 0u, .adc = 0u, .reserved = 0u };
+    uint32_t sum = 0u;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (uint32_t n = 0; n < BENCH_SAMPLES; n++) {
+            sample.value = (uint16_t)n;
+            sample_ring_push(&ring, &sample);
+        }
+        while (sample_ring_pop(&ring, &sample)) {
+            sum += sample.value;
+        }
+    }
+    return sum;
+}
+
+static uint32_t run_pack12(uint32_t iterations) {
+    uint32_t sum = 0u;
+    for (uint32_t i = 0; i < iterations; i++) {
+        fast_samples[0] = (uint16_t)(i & 0xFFFu);
+        sum += pack12(fast_samples, BENCH_SAMPLES, output);
+    }
+    return sum + output[0];
+}
+
+static uint32_t run_unpack12(uint32_t iterations) {
+    uint16_t samples[BENCH_SAMPLES];
+    uint32_t sum = 0u;
+
+    pack12(fast_samples, BENCH_SAMPLES, bytes);
+    for (uint32_t i = 0; i < iterations; i++) {
+        bytes[0] = (uint8_t)i;
+        unpack12(bytes, BENCH_SAMPLES, samples);
+        sum += samples[0];
+    }
+    return sum;
+}
+
+static uint32_t run_delta_slow(uint32_t iterations) {
+    uint32_t sum = 0u;
+    for (uint32_t i = 0; i < iterations; i++) {
+        slow_samples[0] = (uint16_t)(2048u + (i & 7u));
+        sum += delta_encode(slow_samples, BENCH_SAMPLES, output, sizeof(output));
+    }
+    return sum;
+}
+
+static uint32_t run_delta_noise(uint32_t iterations) {
+    uint32_t sum = 0u;
+    for (uint32_t i = 0; i < iterations; i++) {
+        fast_samples[0] = (uint16_t)(i & 0xFFFu);
+        sum += delta_encode(fast_samples, BENCH_SAMPLES, output, sizeof(output));
+    }
+    return sum;
+}
+
+// CRC of a packed frame body: header plus 32 samples at 1.5 bytes each
+static uint32_t run_crc16(uint32_t iterations) {
+    uint32_t sum = 0u;
+    for (uint32_t i = 0; i < iterations; i++) {
+        bytes[0] = (uint8_t)i;
+        sum += crc16_ccitt(bytes, TELEMETRY_HEADER_LENGTH + PACK12_LENGTH(BENCH_SAMPLES));
+    }
+    return sum;
+}
+
+static uint32_t run_cobs(uint32_t iterations) {
+    uint32_t length = TELEMETRY_HEADER_LENGTH + PACK12_LENGTH(BENCH_SAMPLES) + TELEMETRY_CRC_LENGTH;
+    uint32_t sum = 0u;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        bytes[0] = (uint8_t)i;      /* a zero every 256 calls */
+        sum += cobs_encode(bytes, length, output);
+    }
+    return sum;
+}
+
+static uint32_t run_frame(const uint16_t* samples, uint8_t type, uint32_t iterations) {
+    Telemetry_Header_Type header = {
+        .type = type,
+        .sequence = 0u,
+        .timestamp = 0u,
+        .channel_mask = (1u << 1),
+        .num_of_samples = BENCH_SAMPLES,
+    };
+    uint32_t sum = 0u;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        header.sequence = (uint16_t)i;
+        sum += telemetry_encode_frame(&header, samples, output);
+    }
+    return sum;
+}
+
+static uint32_t run_frame_packed(uint32_t iterations) {
+    return run_frame(fast_samples, TELEMETRY_TYPE_PACKED12, iterations);
+}
+
+static uint32_t run_frame_delta(uint32_t iterations) {
+    return run_frame(slow_samples, TELEMETRY_TYPE_DELTA, iterations);
+}
+
+static uint32_t run_frame_wide16(uint32_t iterations) {
+    return run_frame(fast_samples, TELEMETRY_TYPE_WIDE16, iterations);
+}
+
+// One half buffer through the decimator, as daq.c feeds it after BITS
+static uint32_t run_oversample(uint8_t extra_bits, uint32_t iterations) {
+    uint16_t results[BENCH_SAMPLES];
+    uint32_t sum = 0u;
+
+    oversample_init(&stage, extra_bits);
+    for (uint32_t i = 0; i < iterations; i++) {
+        fast_samples[0] = (uint16_t)(i & 0xFFFu);
+        sum += oversample_process(&stage, fast_samples, BENCH_SAMPLES, results);
+        sum += results[0];
+    }
+    return sum;
+}
+
+static uint32_t run_oversample_n2(uint32_t iterations) {
+    return run_oversample(2u, iterations);
+}
+
+static uint32_t run_oversample_n4(uint32_t iterations) {
+    return run_oversample(4u, iterations);
+}
+
+// The value cell of the table: color, label and reading, as main.c draws it
+static uint32_t run_fmt_line(uint32_t iterations) {
+    char line[32];
+    Fmt_Buffer_Type buffer;
+    uint32_t sum = 0u;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        fmt_init(&buffer, line, sizeof(line));
+        fmt_color(&buffer, "\x1B[1;91m");
+        fmt_str(&buffer, "Latest:", 9u, FMT_LEFT);
+        fmt_u32(&buffer, i & 0xFFFu, 4u, FMT_LEFT);
+        sum += buffer.length;
+    }
+    return sum;
+}
+
+// One table refresh where only the reading changed
+static uint32_t run_term_render(uint32_t iterations) {
+    char text[5];
+    Fmt_Buffer_Type buffer;
+    uint32_t sum = 0u;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        fmt_init(&buffer, text, sizeof(text));
+        fmt_u32(&buffer, i & 0xFFFu, 4u, FMT_LEFT);
+        fmt_char(&buffer, '\0');
+        term_put_text(&screen, 6u, 37u, text, TERM_COLOR_BOLD_BLUE);
+        sum += term_render(&screen, (char*)output, sizeof(output));
+    }
+    return sum;
+}
+
+#ifndef HOST_BUILD
+static volatile uint8_t bench_pin = PA5;    /* defeats constant folding for the run-time case */
+
+static uint32_t run_gpio_set_odr(uint32_t iterations) {
+    uint8_t pin = bench_pin;
+    for (uint32_t i = 0; i < iterations; i++) {
+        GPIOx_set_odr(pin);
+    }
+    return pin;
+}
+
+static uint32_t run_gpio_bsrr_set(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        GPIOx_bsrr_set(PA5);
+    }
+    return 0u;
+}
+
+static uint32_t run_gpio_bsrr_write(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        GPIOx_bsrr_write(PA, GPIOx_PIN_BIT(PA5) | GPIOx_PIN_BIT(PA6), (uint16_t)((i & 1u)? GPIOx_PIN_BIT(PA6): 0u));
+    }
+    return 0u;
+}
+#endif
+
+static const Bench_Case_Type cases[] = {
+    { "overhead",           1u,                 1000u, run_overhead },
+    { "ring_push_pop",      1u,                 1000u, run_ring_push_pop },
+    { "ring_burst",         BENCH_SAMPLES,      100u,  run_ring_burst },
+    { "pack12",             BENCH_SAMPLES,      100u,  run_pack12 },
+    { "unpack12",           BENCH_SAMPLES,      100u,  run_unpack12 },
+    { "delta_encode_slow",  BENCH_SAMPLES,      100u,  run_delta_slow },
+    { "delta_encode_noise", BENCH_SAMPLES,      100u,  run_delta_noise },
+    { "crc16",              TELEMETRY_HEADER_LENGTH + PACK12_LENGTH(BENCH_SAMPLES), 100u, run_crc16 },
+    { "cobs_encode",        TELEMETRY_HEADER_LENGTH + PACK12_LENGTH(BENCH_SAMPLES) + TELEMETRY_CRC_LENGTH, 100u, run_cobs },
+    { "frame_packed12",     BENCH_SAMPLES,      100u,  run_frame_packed },
+    { "frame_delta",        BENCH_SAMPLES,      100u,  run_frame_delta },
+    { "frame_wide16",       BENCH_SAMPLES,      100u,  run_frame_wide16 },
+    { "oversample_n2",      BENCH_SAMPLES,      100u,  run_oversample_n2 },
+    { "oversample_n4",      BENCH_SAMPLES,      100u,  run_oversample_n4 },
+    { "fmt_line",           1u,                 100u,  run_fmt_line },
+    { "term_render_digit",  4u,                 100u,  run_term_render },
+#ifndef HOST_BUILD
+    { "gpio_set_odr",       1u,                 1000u, run_gpio_set_odr },
+    { "gpio_bsrr_set",      1u,                 1000u, run_gpio_bsrr_set },
+    { "gpio_bsrr_write",    2u,                 1000u, run_gpio_bsrr_write },
+#endif
+};
+
+#define BENCH_NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+static Bench_Result_Type results[BENCH_NUM_CASES];
+
+
+/*
+ * Runner
+ */
+
+static void setup(void) {
+    sample_ring_init(&ring);
+    term_init(&screen);
+
+    uint32_t noise = 1u;
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        // slow: a coarse triangle of +-16 LSB per sample around mid-scale
+        slow_samples[i] = (uint16_t)(2048u + ((i < (BENCH_SAMPLES / 2u))? (i * 16u): ((BENCH_SAMPLES - i) * 16u)));
+        noise = (noise * 1103515245u) + 12345u;
+        fast_samples[i] = (uint16_t)((noise >> 16) & 0xFFFu);
+    }
+    for (uint32_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (uint8_t)((i * 37u) + 1u);
+    }
+    term_render(&screen, (char*)output, sizeof(output));    /* the first render clears the screen */
+}
+
+static void measure(const Bench_Case_Type* bench, Bench_Result_Type* result) {
+    uint32_t rounds[BENCH_ROUNDS];
+    uint32_t iterations = bench->iterations * BENCH_SCALE;
+
+    bench_sink += bench->run(iterations);   /* warm up caches and branch predictors */
+
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+        uint32_t start = bench_ticks();
+        bench_sink += bench->run(iterations);
+        uint32_t per_call_x100 = (uint32_t)(((uint64_t)(bench_ticks() - start) * 100u) / iterations);
+
+        uint32_t n = r;
+        while ((n > 0u) && (rounds[n - 1u] > per_call_x100)) {      /* insertion sort */
+            rounds[n] = rounds[n - 1u];
+            n--;
+        }
+        rounds[n] = per_call_x100;
+    }
+
+    result->name = bench->name;
+    result->min_x100 = rounds[0];
+    result->median_x100 = rounds[BENCH_ROUNDS / 2u];
+}
+
+static void fmt_x100(Fmt_Buffer_Type* line, uint32_t value_x100) {
+    fmt_u32(line, value_x100 / 100u, 0u, 0u);
+    fmt_char(line, '.');
+    fmt_u32(line, value_x100 % 100u, 2u, FMT_ZERO);
+}
+
+static void report(const Bench_Case_Type* bench, const Bench_Result_Type* result) {
+    char text[BENCH_LINE_SIZE];
+    Fmt_Buffer_Type line;
+
+    fmt_init(&line, text, sizeof(text));
+    fmt_str(&line, bench->name, 0u, 0u);
+    fmt_char(&line, ',');
+    fmt_u32(&line, bench->items, 0u, 0u);
+    fmt_char(&line, ',');
+    fmt_u32(&line, bench->iterations * BENCH_SCALE, 0u, 0u);
+    fmt_str(&line, "," BENCH_UNIT ",", 0u, 0u);
+    fmt_x100(&line, result->min_x100);
+    fmt_char(&line, ',');
+    fmt_x100(&line, result->median_x100);
+    fmt_str(&line, BENCH_EOL, 0u, 0u);
+    fmt_char(&line, '\0');
+    bench_print(text);
+}
+
+static void run_all(void) {
+    setup();
+    bench_print("name,items,iterations,unit,min,median" BENCH_EOL);
+    for (uint32_t i = 0; i < BENCH_NUM_CASES; i++) {
+        measure(&cases[i], &results[i]);
+        report(&cases[i], &results[i]);
+    }
+}
+
+
+#ifdef HOST_BUILD
+
+// Compares the medians with a file written by an earlier run; returns the number of regressions
+static uint32_t compare(const char* path, uint32_t tolerance_percent) {
+    char text[BENCH_LINE_SIZE];
+    char name[BENCH_LINE_SIZE];
+    char unit[16];
+    unsigned long items, iterations;
+    double min, median;
+    uint32_t regressions = 0u;
+    FILE* file = fopen(path, "r");
+
+    if (file == NULL) {
+        perror(path);
+        return 1u;
+    }
+
+    while (fgets(text, sizeof(text), file) != NULL) {
+        if (sscanf(text, "%95[^,],%lu,%lu,%15[^,],%lf,%lf", name, &items, &iterations, unit, &min, &median) != 6) {
+            continue;   /* header, or a line of another tool */
+        }
+        for (uint32_t i = 0; i < BENCH_NUM_CASES; i++) {
+            if ((strcmp(results[i].name, name) != 0) || (strcmp(unit, BENCH_UNIT) != 0)) {
+                continue;
+            }
+            double now = results[i].median_x100 / 100.0;
+            double change = (median > 0.0)? (((now - median) * 100.0) / median): 0.0;
+            if (change > tolerance_percent) {
+                fprintf(stderr, "# regression: %s %.2f -> %.2f %s (%+.0f %%)\n", name, median, now, BENCH_UNIT, change);
+                regressions++;
+            }
+        }
+    }
+    fclose(file);
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    run_all();
+    fflush(stdout);
+
+    if (argc >= 2) {
+        uint32_t tolerance = (argc >= 3)? (uint32_t)strtoul(argv[2], NULL, 0): BENCH_TOLERANCE;
+        uint32_t regressions = compare(argv[1], tolerance);
+        fprintf(stderr, "# %u regression(s) against %s at %u %%\n", regressions, argv[1], tolerance);
+        return (regressions == 0u)? 0: 1;
+    }
+    return 0;
+}
+
+#else
+
+int main(void) {
+    clockSpeed_PLL();
+    SysTick_Init();
+
+    GPIOx_init(PA);
+    GPIOx_config_mode(PA5, MODER_OUTPUT);
+    GPIOx_config_mode(PA6, MODER_OUTPUT);
+
+    USART2_quick_default_config();
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    run_all();
+
+    for(;;) {
+    }
+
+    return 0;
+}
+
+#endif
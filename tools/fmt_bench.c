@@ -0,0 +1,83 @@
+/**
+ * @file: fmt_bench.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Host benchmark of Src/fmt.c against snprintf() on the lines the display
+ * path used to print: a colored "%-9s" label followed by a "%-4lu" reading.
+ *
+ * Both sides write the same bytes into the same stack buffer; the result is
+ * checked once before timing. Absolute numbers are host nanoseconds, only the
+ * ratio carries over to the Cortex-M4 (where newlib's vfprintf is also the
+ * one pulling _sbrk and several KB of flash into the image).
+ *
+ * Build & run:
+ *   gcc -std=gnu11 -O2 -IInc tools/fmt_bench.c Src/fmt.c -o fmt_bench && ./fmt_bench
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "fmt.h"
+
+#define ITERATIONS 2000000u
+
+static const char* const labels[] = {"Max:", "Min:", "Average:", "Latest:"};
+
+static volatile uint32_t sink;
+
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t line_printf(char* out, uint32_t size, uint32_t i) {
+    int n = snprintf(out, size, "\x1B[1;91m%-9s%-4lu", labels[i & 3u], (unsigned long)(i & 0xFFFu));
+    return (uint32_t)n;
+}
+
+static uint32_t line_fmt(char* out, uint32_t size, uint32_t i) {
+    Fmt_Buffer_Type buffer;
+
+    fmt_init(&buffer, out, size);
+    fmt_color(&buffer, "\x1B[1;91m");
+    fmt_str(&buffer, labels[i & 3u], 9u, FMT_LEFT);
+    fmt_u32(&buffer, i & 0xFFFu, 4u, FMT_LEFT);
+    fmt_char(&buffer, '\0');
+    return buffer.length - 1u;
+}
+
+static double run(uint32_t (*line)(char*, uint32_t, uint32_t)) {
+    char out[64];
+    uint64_t start = now_ns();
+
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        sink += line(out, sizeof(out), i);
+    }
+    return (double)(now_ns() - start) / ITERATIONS;
+}
+
+
+int main(void) {
+    char a[64], b[64];
+
+    for (uint32_t i = 0; i < 5000u; i++) {
+        uint32_t la = line_printf(a, sizeof(a), i);
+        uint32_t lb = line_fmt(b, sizeof(b), i);
+        if ((la != lb) || (memcmp(a, b, la + 1u) != 0)) {
+            printf("fmt_bench: output mismatch at %u: \"%s\" vs \"%s\"\n", i, a, b);
+            return 1;
+        }
+    }
+
+    double printf_ns = run(line_printf);
+    double fmt_ns = run(line_fmt);
+
+    printf("snprintf: %7.1f ns/line\n", printf_ns);
+    printf("fmt:      %7.1f ns/line\n", fmt_ns);
+    printf("speedup:  %7.2fx\n", printf_ns / fmt_ns);
+    return 0;
+}
@@ -0,0 +1,339 @@
+/**
+ * @file: sim_run.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Runs the unmodified firmware (Src/main.c and everything it calls) on the
+ * peripheral simulator, in virtual time, with PA1 (ADC1 channel 1) driven by
+ * a synthetic source (see Sim/sim_signal.h). Commands are sent to USART2 in
+ * binary form once the firmware listens, BINARY first unless -T is given, and
+ * everything the firmware transmits is decoded as it leaves USART2.
+ *
+ * Every conversion is logged with its cycle, so each telemetry frame is
+ * matched with the conversions it carries (or, after BITS, with the ones its
+ * results were decimated from): the report gives the sample rate
+ * delivered end to end, frames lost (sequence gaps) or corrupted, and the
+ * latency from the conversion of the newest sample of a frame to the frame's
+ * last byte leaving the UART.
+ *
+ * Build:
+ *   gcc -std=gnu11 -O2 -no-pie -include Sim/sim_device.h -IInc -ISim -Wno-pointer-to-int-cast \
+ *       -Wno-int-to-pointer-cast -Dmain=firmware_main tools/sim_run.c Sim/sim.c Sim/sim_signal.c \
+ *       Src/main.c Src/daq.c Src/adc.c Src/adc_stream.c Src/adc_trigger.c Src/usart.c Src/gpio.c \
+ *       Src/pll.c Src/scheduler.c Src/soft_timer.c Src/command.c Src/fmt.c Src/cobs.c Src/crc16.c \
+ *       Src/telemetry.c Src/pack12.c Src/delta_codec.c Src/term_render.c Src/sample_ring.c \
+ *       Src/profile.c Src/strobe.c Src/oversample.c -lm -o sim_run
+ *
+ * Usage:
+ *   sim_run [-t seconds] [-s signal] [-c command]... [-T] [-o file]
+ *     -t  virtual time to run, 1 s by default
+ *     -s  source on PA1, "sine:2048,1500,50" by default
+ *     -c  command to send, e.g. -c "START 20000" (repeatable, in order)
+ *     -T  keep the table output instead of switching to BINARY
+ *     -o  write the raw USART2 output to file
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <time.h>
+
+#include "sim.h"
+#include "sim_signal.h"
+#include "pll.h"
+#include "telemetry.h"
+#include "command.h"
+
+#undef main     /* the firmware's main() is built as firmware_main() */
+
+#define MAX_COMMANDS        16u
+#define CONVERSION_LOG_SIZE 65536u      /* about 0.3 s of samples at DAQ_MAX_RATE_HZ */
+#define CONVERSION_LOG_MASK (CONVERSION_LOG_SIZE - 1u)
+#define DEFAULT_SIGNAL      "sine:2048,1500,50"
+#define CYCLES_PER_US       (HCLK_FREQ / 1000000.0)
+
+
+typedef struct {
+    uint64_t cycle;
+    uint16_t value;
+} Conversion_Type;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t lost;
+    uint32_t rejected;
+    uint32_t unmatched;
+    uint32_t responses;
+    uint32_t frame_bytes;       /* delimiters included, the rest is table output */
+    uint64_t samples;
+    uint64_t latency_sum;
+    uint64_t latency_min;
+    uint64_t latency_max;
+    uint8_t have_sequence;
+    uint8_t synchronised;
+    uint16_t next_sequence;
+} Run_Stats_Type;
+
+
+int firmware_main(void);
+
+static Conversion_Type conversions[CONVERSION_LOG_SIZE];
+static uint64_t conversion_count;
+static uint64_t conversion_matched;     /* conversions up to here were found in a frame */
+
+static uint8_t frame[TELEMETRY_MAX_FRAME_LENGTH + COMMAND_MAX_REPLY_LENGTH];
+static uint32_t frame_length;
+static uint8_t frame_overflow;
+
+static Run_Stats_Type stats = { .latency_min = UINT64_MAX };
+static Sim_Signal_Type signal_source;
+static FILE* raw_output;
+
+static const char* commands[MAX_COMMANDS];
+static uint32_t num_of_commands;
+static uint8_t commands_sent;
+
+static uint64_t deadline;
+static jmp_buf finished;
+
+
+// Waveform of PA1: the source, with every conversion logged
+static uint16_t logged_source(uint8_t channel, uint64_t cycle, void* context) {
+    uint16_t value = sim_signal_sample(channel, cycle, context);
+    Conversion_Type* entry = &conversions[conversion_count & CONVERSION_LOG_MASK];
+
+    entry->cycle = cycle;
+    entry->value = value;
+    conversion_count++;
+    return value;
+}
+
+// Result of the ratio conversions from start, decimated as by oversample.c
+static uint16_t decimated(uint64_t start, uint32_t ratio, uint32_t extra_bits) {
+    uint32_t sum = (extra_bits != 0u)? (1u << (extra_bits - 1u)): 0u;
+
+    for (uint32_t i = 0; i < ratio; i++) {
+        sum += conversions[(start + i) & CONVERSION_LOG_MASK].value;
+    }
+    return (uint16_t)(sum >> extra_bits);
+}
+
+// Finds the conversions a frame carries, the first run whose results equal the
+// samples after the last match (each result decimating 4^(bits-12) conversions);
+// returns the index of the newest one, or UINT64_MAX
+static uint64_t match_conversions(const uint16_t* samples, uint32_t num_of_samples, uint8_t bits) {
+    uint32_t extra_bits = bits - TELEMETRY_BASE_BITS;
+    uint32_t ratio = 1u << (2u * extra_bits);
+    uint64_t length = (uint64_t)num_of_samples * ratio;
+    uint64_t first = conversion_matched;
+
+    if ((conversion_count - first) > CONVERSION_LOG_SIZE) {
+        first = conversion_count - CONVERSION_LOG_SIZE;
+    }
+    for (uint64_t start = first; (start + length) <= conversion_count; start++) {
+        uint32_t i = 0u;
+        while ((i < num_of_samples) && (decimated(start + ((uint64_t)i * ratio), ratio, extra_bits) == samples[i])) {
+            i++;
+        }
+        if (i == num_of_samples) {
+            conversion_matched = start + length;
+            return conversion_matched - 1u;
+        }
+    }
+    return UINT64_MAX;
+}
+
+static void handle_frame(void) {
+    Telemetry_Header_Type header;
+    uint16_t samples[TELEMETRY_MAX_SAMPLES];
+    uint8_t id;
+    Command_Response_Type response;
+
+    if (command_decode_response(frame, frame_length, &id, &response)) {
+        printf("# %s status %u:", command_name(id), response.status);
+        for (uint32_t i = 0; i < response.count; i++) {
+            printf(" %u", response.values[i]);
+        }
+        printf("\n");
+        stats.responses++;
+        stats.frame_bytes += frame_length + 1u;
+        stats.synchronised = 1u;
+        return;
+    }
+    if (!telemetry_decode_frame(frame, frame_length, &header, samples)) {
+        stats.rejected += stats.synchronised;   /* before the first frame, it is the table */
+        return;
+    }
+    stats.frame_bytes += frame_length + 1u;
+    stats.synchronised = 1u;
+
+    if (stats.have_sequence) {
+        stats.lost += (uint16_t)(header.sequence - stats.next_sequence);
+    }
+    stats.have_sequence = 1u;
+    stats.next_sequence = (uint16_t)(header.sequence + 1u);
+    stats.frames++;
+    stats.samples += header.num_of_samples;
+
+    uint64_t newest = match_conversions(samples, header.num_of_samples, header.bits);
+    if (newest == UINT64_MAX) {
+        stats.unmatched++;
+        return;
+    }
+    uint64_t latency = sim_cycles() - conversions[newest & CONVERSION_LOG_MASK].cycle;
+    stats.latency_sum += latency;
+    if (latency < stats.latency_min) {
+        stats.latency_min = latency;
+    }
+    if (latency > stats.latency_max) {
+        stats.latency_max = latency;
+    }
+}
+
+// Receives USART2 TX, one byte at the cycle its stop bit ends
+static void on_uart_byte(uint8_t byte, void* context) {
+    (void)context;
+
+    if (raw_output != NULL) {
+        fputc(byte, raw_output);
+    }
+    if (byte == COBS_DELIMITER) {
+        if (frame_overflow) {
+            stats.rejected += stats.synchronised;
+        } else if (frame_length != 0u) {
+            handle_frame();
+        }
+        frame_length = 0u;
+        frame_overflow = 0u;
+    } else if (frame_length < sizeof(frame)) {
+        frame[frame_length++] = byte;
+    } else {
+        frame_overflow = 1u;
+    }
+}
+
+// Sends the commands once the RXNE interrupt is enabled, ends the run at the deadline
+static void on_step(void* context) {
+    (void)context;
+
+    if (!commands_sent && (USART2->CR1 & USART_CR1_RXNEIE)) {
+        commands_sent = 1u;
+        for (uint32_t i = 0; i < num_of_commands; i++) {
+            Command_Type command;
+            uint8_t encoded[COMMAND_MAX_FRAME_LENGTH];
+
+            command_parse_text(commands[i], (uint32_t)strlen(commands[i]), &command);   /* checked in main() */
+            sim_uart_inject(encoded, command_encode_binary(&command, encoded));
+        }
+    }
+    if (sim_cycles() >= deadline) {
+        longjmp(finished, 1);
+    }
+}
+
+static double seconds_since(const struct timespec* start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + ((now.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+static void report(double wall_s) {
+    const Sim_Stats_Type* sim = sim_stats();
+    double virtual_s = (double)sim_cycles() / HCLK_FREQ;
+    uint32_t matched = stats.frames - stats.unmatched;
+
+    printf("virtual time      %.3f s in %.3f s wall (%.1fx real time)\n",
+           virtual_s, wall_s, (wall_s > 0.0)? (virtual_s / wall_s): 0.0);
+    printf("conversions       %u (%.0f/s)\n", sim->adc_conversions, sim->adc_conversions / virtual_s);
+    printf("frames            %u decoded, %u lost, %u rejected, %u unmatched\n",
+           stats.frames, stats.lost, stats.rejected, stats.unmatched);
+    printf("samples delivered %llu (%.0f/s)\n", (unsigned long long)stats.samples, stats.samples / virtual_s);
+    if (matched != 0u) {
+        printf("latency           min %.1f us, mean %.1f us, max %.1f us (newest sample to end of frame)\n",
+               stats.latency_min / CYCLES_PER_US, (stats.latency_sum / (double)matched) / CYCLES_PER_US,
+               stats.latency_max / CYCLES_PER_US);
+    }
+    uint32_t in_flight = stats.synchronised? frame_length: 0u;     /* frame cut by the deadline, not text */
+    printf("usart2            %u bytes out (%u text), %u bytes in, %u interrupts\n",
+           sim->uart_tx_bytes, sim->uart_tx_bytes - stats.frame_bytes - in_flight, sim->uart_rx_bytes, sim->interrupts);
+}
+
+
+int main(int argc, char** argv) {
+    const char* signal_spec = DEFAULT_SIGNAL;
+    const char* output_path = NULL;
+    double seconds = 1.0;
+    uint8_t table = 0u;
+    uint8_t usage = 0u;
+
+    for (int i = 1; i < argc; i++) {
+        uint8_t has_value = (i + 1) < argc;
+
+        if ((strcmp(argv[i], "-t") == 0) && has_value) {
+            seconds = strtod(argv[++i], NULL);
+        } else if ((strcmp(argv[i], "-s") == 0) && has_value) {
+            signal_spec = argv[++i];
+        } else if ((strcmp(argv[i], "-c") == 0) && has_value && (num_of_commands < (MAX_COMMANDS - 1u))) {
+            commands[num_of_commands++] = argv[++i];
+        } else if ((strcmp(argv[i], "-o") == 0) && has_value) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "-T") == 0) {
+            table = 1u;
+        } else {
+            usage = 1u;
+        }
+    }
+    if (usage || !(seconds > 0.0)) {
+        fprintf(stderr, "usage: %s [-t seconds] [-s signal] [-c command]... [-T] [-o file]\n", argv[0]);
+        return 2;
+    }
+
+    if (!table) {
+        memmove(&commands[1], &commands[0], num_of_commands * sizeof(commands[0]));
+        commands[0] = "BINARY";
+        num_of_commands++;
+    }
+    for (uint32_t i = 0; i < num_of_commands; i++) {
+        Command_Type command;
+        if (command_parse_text(commands[i], (uint32_t)strlen(commands[i]), &command) != COMMAND_OK) {
+            fprintf(stderr, "invalid command \"%s\"\n", commands[i]);
+            return 2;
+        }
+    }
+    if (!sim_signal_parse(&signal_source, signal_spec)) {
+        fprintf(stderr, "invalid signal \"%s\"\n", signal_spec);
+        return 2;
+    }
+    if (output_path != NULL) {
+        raw_output = fopen(output_path, "wb");
+        if (raw_output == NULL) {
+            perror(output_path);
+            return 1;
+        }
+    }
+
+    sim_reset();
+    sim_adc_set_input(1u, logged_source, &signal_source);
+    sim_uart_set_sink(on_uart_byte, NULL);
+    sim_set_step_hook(on_step, NULL);
+    deadline = (uint64_t)(seconds * HCLK_FREQ);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (setjmp(finished) == 0) {
+        firmware_main();    /* never returns */
+    }
+    double wall_s = seconds_since(&start);
+
+    sim_set_step_hook(NULL, NULL);
+    report(wall_s);
+
+    if (raw_output != NULL) {
+        fclose(raw_output);
+    }
+    sim_signal_free(&signal_source);
+    return ((stats.rejected == 0u) && (stats.unmatched == 0u))? 0: 1;
+}
@@ -0,0 +1,313 @@
+/**
+ * @file: telemetry_decode.c
+ *
+ * @date: Oct 17, 2026
+ * @author: Anurag
+ * Linux-side decoder for the binary telemetry stream (see telemetry.h).
+ * Frames are read from a serial port, checked and printed as CSV:
+ *
+ *   sequence,timestamp_ms,channel_mask,index,value
+ *
+ * Sequence gaps, rejected frames and the average number of wire bytes per
+ * sample are reported on stderr at exit. Command responses found in the
+ * stream are printed on stderr as they arrive.
+ *
+ * Build:
+ *   gcc -std=gnu11 -O2 -IInc tools/telemetry_decode.c Src/telemetry.c Src/pack12.c Src/delta_codec.c Src/command.c Src/fmt.c Src/cobs.c Src/crc16.c -o telemetry_decode
+ *
+ * Usage:
+ *   telemetry_decode /dev/ttyACM0 [frames]    decode from the board (115200 8N1)
+ *   telemetry_decode -b 921600 /dev/ttyACM0   same at the rate the firmware was built with
+ *   telemetry_decode -c "START 5000" /dev/ttyACM0 [frames]
+ *                                             send a command in binary form first; without
+ *                                             a frame count, exit once it is answered
+ *   telemetry_decode -g /dev/pts/N [frames]   write synthetic frames to a tty
+ *   telemetry_decode -G /dev/pts/N [frames]   same, delta compressed
+ *   telemetry_decode -p [frames]              generate and decode over a pseudo-terminal pair
+ *   telemetry_decode -P [frames]              same, delta compressed
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/wait.h>
+
+#include "telemetry.h"
+#include "command.h"
+
+#define GENERATOR_SAMPLES 32u   /* matches half of ADC1_STREAM_LENGTH on the board */
+
+
+typedef struct {
+    uint32_t frames;
+    uint32_t rejected;
+    uint32_t lost;
+    uint32_t samples;
+    uint32_t compressed;
+    uint32_t responses;
+    uint64_t bytes;
+    uint8_t have_sequence;
+    uint16_t next_sequence;
+} Decode_Stats_Type;
+
+
+static speed_t line_speed = B115200;
+
+// Maps a baud rate to its termios constant, B0 if the host has none
+static speed_t speed_of(unsigned long baud_rate) {
+    switch (baud_rate) {
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+    case 3000000: return B3000000;
+    case 4000000: return B4000000;
+    default: return B0;
+    }
+}
+
+// Puts a terminal in raw 8N1 mode at line_speed; silently ignores non-terminals
+static void set_raw(int fd) {
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) != 0) {
+        return;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, line_speed);
+    cfsetospeed(&tio, line_speed);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    tcsetattr(fd, TCSANOW, &tio);
+}
+
+// Validates one frame and prints its samples
+static void handle_frame(const uint8_t* frame, uint32_t length, Decode_Stats_Type* stats) {
+    Telemetry_Header_Type header;
+    uint16_t samples[TELEMETRY_MAX_SAMPLES];
+
+    uint8_t id;
+    Command_Response_Type response;
+
+    if (length == 0u) {
+        return;     /* back to back delimiters, e.g. after resynchronising */
+    }
+    if (command_decode_response(frame, length, &id, &response)) {
+        fprintf(stderr, "# %s status %u:", command_name(id), response.status);
+        for (uint32_t i = 0; i < response.count; i++) {
+            fprintf(stderr, " %u", response.values[i]);
+        }
+        fprintf(stderr, "\n");
+        stats->responses++;
+        return;
+    }
+    if (!telemetry_decode_frame(frame, length, &header, samples)) {
+        stats->rejected++;
+        return;
+    }
+
+    if (stats->have_sequence) {
+        stats->lost += (uint16_t)(header.sequence - stats->next_sequence);
+    }
+    stats->have_sequence = 1u;
+    stats->next_sequence = (uint16_t)(header.sequence + 1u);
+    stats->frames++;
+    stats->samples += header.num_of_samples;
+    stats->bytes += length + 1u;    /* delimiter included */
+    if (header.type == TELEMETRY_TYPE_DELTA) {
+        stats->compressed++;
+    }
+
+    for (uint32_t i = 0; i < header.num_of_samples; i++) {
+        printf("%u,%u,0x%04x,%u,%u\n", header.sequence, header.timestamp, header.channel_mask, i, samples[i]);
+    }
+}
+
+// Reads frames until max_frames valid frames were seen (0 = forever, or until
+// the first response when a command was sent) or EOF
+static int decode(int fd, uint32_t max_frames, uint8_t until_response) {
+    Decode_Stats_Type stats = {0};
+    uint8_t frame[TELEMETRY_MAX_FRAME_LENGTH];
+    uint32_t length = 0u;
+    uint8_t overflow = 0u;
+    uint8_t chunk[256];
+    ssize_t got;
+
+    set_raw(fd);
+
+    while (((max_frames == 0u) || (stats.frames < max_frames)) &&
+           !(until_response && (stats.responses != 0u))) {
+        got = read(fd, chunk, sizeof(chunk));
+        if (got <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < got; i++) {
+            if (chunk[i] == COBS_DELIMITER) {
+                if (overflow) {
+                    stats.rejected++;
+                } else {
+                    handle_frame(frame, length, &stats);
+                }
+                length = 0u;
+                overflow = 0u;
+            } else if (length < sizeof(frame)) {
+                frame[length++] = chunk[i];
+            } else {
+                overflow = 1u;
+            }
+        }
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "frames %u (%u compressed), samples %u, lost %u, rejected %u, %.2f bytes/sample\n",
+            stats.frames, stats.compressed, stats.samples, stats.lost, stats.rejected,
+            (stats.samples != 0u)? (double)stats.bytes / stats.samples: 0.0);
+    return (stats.rejected == 0u)? 0: 1;
+}
+
+// Writes frames carrying a slow random walk, 1 ms per sample like the board
+static int generate(int fd, uint32_t max_frames, uint8_t type) {
+    uint16_t samples[GENERATOR_SAMPLES];
+    uint8_t frame[TELEMETRY_MAX_FRAME_LENGTH];
+    uint32_t timestamp = 0u;
+    uint16_t value = 2048u;
+    uint32_t noise = 1u;
+
+    set_raw(fd);
+
+    for (uint32_t n = 0; (max_frames == 0u) || (n < max_frames); n++) {
+        for (uint32_t i = 0; i < GENERATOR_SAMPLES; i++) {
+            samples[i] = value;
+            noise = noise * 1103515245u + 12345u;
+            value = (uint16_t)((value + ((noise >> 16) % 7u) - 3u) & 0x0FFFu);    /* +-3 LSB */
+        }
+        timestamp += GENERATOR_SAMPLES;
+
+        Telemetry_Header_Type header = {
+            .type = type,
+            .sequence = (uint16_t)n,
+            .timestamp = timestamp,
+            .channel_mask = (1u << 1),
+            .num_of_samples = GENERATOR_SAMPLES,
+        };
+        uint32_t length = telemetry_encode_frame(&header, samples, frame);
+
+        if (write(fd, frame, length) != (ssize_t)length) {
+            perror("write");
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Runs the generator on the master side of a pty and decodes from the slave side
+static int pty_loopback(uint32_t max_frames, uint8_t type) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0)) {
+        perror("posix_openpt");
+        return 1;
+    }
+
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0) {
+        perror("open slave");
+        return 1;
+    }
+    set_raw(slave);     /* before the child writes, so no byte is line-edited */
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(slave);
+        _exit(generate(master, max_frames, type));
+    }
+
+    int status = decode(slave, max_frames, 0u);
+    waitpid(child, NULL, 0);
+    return status;
+}
+
+
+// Sends a text command in its binary form
+static int send_command(int fd, const char* text) {
+    Command_Type command;
+    uint8_t frame[COMMAND_MAX_FRAME_LENGTH];
+
+    if (command_parse_text(text, (uint32_t)strlen(text), &command) != COMMAND_OK) {
+        fprintf(stderr, "invalid command \"%s\"\n", text);
+        return 2;
+    }
+
+    uint32_t length = command_encode_binary(&command, frame);
+    if (write(fd, frame, length) != (ssize_t)length) {
+        perror("write");
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, char** argv) {
+    const char* command_text = NULL;
+
+    while ((argc >= 3) && ((strcmp(argv[1], "-b") == 0) || (strcmp(argv[1], "-c") == 0))) {
+        if (argv[1][1] == 'b') {
+            line_speed = speed_of(strtoul(argv[2], NULL, 0));
+            if (line_speed == B0) {
+                fprintf(stderr, "unsupported baud rate %s\n", argv[2]);
+                return 2;
+            }
+        } else {
+            command_text = argv[2];
+        }
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+
+    const char* option = (argc >= 2)? argv[1]: "";
+    uint8_t type = ((strcmp(option, "-G") == 0) || (strcmp(option, "-P") == 0))?
+                   TELEMETRY_TYPE_DELTA: TELEMETRY_TYPE_PACKED12;
+
+    if ((strcmp(option, "-p") == 0) || (strcmp(option, "-P") == 0)) {
+        return pty_loopback((argc >= 3)? (uint32_t)strtoul(argv[2], NULL, 0): 100u, type);
+    }
+
+    uint8_t generator = (strcmp(option, "-g") == 0) || (strcmp(option, "-G") == 0);
+    int path = generator? 2: 1;
+
+    if (argc <= path) {
+        fprintf(stderr, "usage: %s [-b baud] [-c command] [-g|-G] <tty> [frames] | -p|-P [frames]\n", argv[0]);
+        return 2;
+    }
+
+    int fd = open(argv[path], (generator? O_WRONLY: O_RDWR) | O_NOCTTY);
+    if (fd < 0) {
+        perror(argv[path]);
+        return 1;
+    }
+
+    uint32_t frames = (argc > path + 1)? (uint32_t)strtoul(argv[path + 1], NULL, 0): 0u;
+    int status;
+
+    if (generator) {
+        status = generate(fd, frames, type);
+    } else {
+        set_raw(fd);
+        status = (command_text != NULL)? send_command(fd, command_text): 0;
+        if (status == 0) {
+            status = decode(fd, frames, (command_text != NULL) && (frames == 0u));
+        }
+    }
+
+    close(fd);
+    return status;
+}